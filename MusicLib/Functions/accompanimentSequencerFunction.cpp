@@ -137,7 +137,7 @@ namespace {
                     if (accompanimentTrack) {
                         ASSIGN_OR_ERROR(bw_music::Track excerpt,
                             getTrackSegmentForDuration(*accompanimentTrack, offset, targetDuration));
-                        ASSIGN_OR_ERROR(excerpt, bw_music::transposeTrack(excerpt, pitchOffset,
+                        ASSIGN_OR_ERROR(excerpt, bw_music::transposeTrack(std::move(excerpt), pitchOffset,
                                                            bw_music::TransposeOutOfRangePolicy::MapToNearestOctave));
                         // Get the track segment for this duration
                         bw_music::appendTrack(trackInStructure.m_track, excerpt);
@@ -13,18 +13,23 @@ babelwires::Result bw_music::appendTrack(Track& targetTrack, const Track& source
     const ModelDuration gapAtEnd = targetTrack.getDuration() - targetTrack.getTotalEventDuration();
 
     TrackBuilder resultTrack(std::move(targetTrack));
+    resultTrack.addEventsOfTrack(sourceTrack, gapAtEnd);
+    targetTrack = resultTrack.finishAndGetTrack(initialDuration + sourceTrack.getDuration());
+    return {};
+}
 
-    auto it = sourceTrack.begin();
-    if (it != sourceTrack.end()) {
-        TrackEventHolder firstEventInSequence = *it;
-        firstEventInSequence->setTimeSinceLastEvent(firstEventInSequence->getTimeSinceLastEvent() + gapAtEnd);
-        resultTrack.addEvent(firstEventInSequence.release());
-
-        for (++it; it != sourceTrack.end(); ++it) {
-            resultTrack.addEvent(*it);
+bw_music::Track bw_music::concatenateTracks(std::span<const Track* const> tracks) {
+    TrackBuilder resultTrack;
+    ModelDuration duration;
+    // The time between the last event added and the end of the tracks processed so far.
+    ModelDuration gapAtEnd;
+    for (const Track* track : tracks) {
+        if (track->getNumEvents() > 0) {
+            resultTrack.addEventsOfTrack(*track, gapAtEnd);
+            gapAtEnd = 0;
         }
+        duration += track->getDuration();
+        gapAtEnd += track->getDuration() - track->getTotalEventDuration();
     }
-    
-    targetTrack = resultTrack.finishAndGetTrack(initialDuration + sourceTrack.getDuration());
-    return {};
+    return resultTrack.finishAndGetTrack(duration);
 }
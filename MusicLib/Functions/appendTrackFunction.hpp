@@ -13,7 +13,12 @@
 
 #include <BaseLib/Result/result.hpp>
 
+#include <span>
+
 namespace bw_music {
     /// Add the events of sourceTrack to the end of targetTrack.
     MUSICLIB_API babelwires::Result appendTrack(Track& targetTrack, const Track& sourceTrack);
+
+    /// Join the tracks end to end in a single pass, copying their events without checking them again.
+    MUSICLIB_API Track concatenateTracks(std::span<const Track* const> tracks);
 } // namespace bw_music
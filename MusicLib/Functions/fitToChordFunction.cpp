@@ -12,6 +12,7 @@
 #include <MusicLib/Types/Track/trackType.hpp>
 #include <MusicLib/chord.hpp>
 
+#include <bitset>
 #include <map>
 
 namespace {
@@ -171,6 +172,28 @@ namespace {
         return resultTrack.finishAndGetTrack(sourceTrack.getDuration());
     }
 
+    /// Adjusting notes in place is safe when the pitches used in the track map to distinct pitches, since then
+    /// overlapping notes cannot be merged.
+    bool canFitToChordInPlace(const PitchMap& pitchMap, const bw_music::Track& sourceTrack) {
+        std::bitset<256> usedPitches;
+        for (const auto& event : sourceTrack) {
+            if (const auto note = event.tryAs<bw_music::NoteEvent>()) {
+                usedPitches.set(note->getPitch());
+            }
+        }
+        std::bitset<256> targetPitches;
+        for (unsigned int pitch = 0; pitch < usedPitches.size(); ++pitch) {
+            if (usedPitches.test(pitch)) {
+                const bw_music::Pitch targetPitch = pitchMap(static_cast<bw_music::Pitch>(pitch));
+                if (targetPitches.test(targetPitch)) {
+                    return false;
+                }
+                targetPitches.set(targetPitch);
+            }
+        }
+        return true;
+    }
+
 } // namespace
 
 babelwires::ResultT<bw_music::Track> bw_music::fitToChordFunction(const Track& sourceTrack, const Chord& chord) {
@@ -178,3 +201,18 @@ babelwires::ResultT<bw_music::Track> bw_music::fitToChordFunction(const Track& s
 
     return fitToChordFunctionInternal(pitchMap, sourceTrack, chord);
 }
+
+babelwires::ResultT<bw_music::Track> bw_music::fitToChordFunction(Track&& sourceTrack, const Chord& chord) {
+    const PitchMap pitchMap(chord);
+
+    if (!canFitToChordInPlace(pitchMap, sourceTrack)) {
+        return fitToChordFunctionInternal(pitchMap, sourceTrack, chord);
+    }
+
+    sourceTrack.modifyEventsInPlace([&pitchMap](TrackEvent& event) {
+        if (auto note = event.tryAs<NoteEvent>()) {
+            note->setPitch(pitchMap(note->getPitch()));
+        }
+    });
+    return std::move(sourceTrack);
+}
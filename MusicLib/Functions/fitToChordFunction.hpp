@@ -21,4 +21,8 @@ namespace bw_music {
     /// The input is assumed notes are assumed to be in C major.
     MUSICLIB_API babelwires::ResultT<Track> fitToChordFunction(const Track& sourceTrack, const Chord& chord);
 
+    /// As above, but when no two pitches in the track are mapped to the same pitch, the notes of sourceTrack are
+    /// adjusted in place.
+    MUSICLIB_API babelwires::ResultT<Track> fitToChordFunction(Track&& sourceTrack, const Chord& chord);
+
 } // namespace bw_music
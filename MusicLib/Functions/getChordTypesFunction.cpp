@@ -8,15 +8,15 @@
 #include <MusicLib/Functions/getChordTypesFunction.hpp>
 
 #include <MusicLib/Types/Track/track.hpp>
-#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
 
 babelwires::ResultT<std::set<bw_music::ChordType::Value>> bw_music::getChordTypesFunction(const Track& chordTrack) {
     std::set<ChordType::Value> chordTypes;
 
-    // Iterate through the chord track and collect unique chord types.
-    for (const auto& event : chordTrack) {
-        if (const auto chordEvent = event.tryAs<ChordOnEvent>()) {
-            chordTypes.insert(chordEvent->m_chord.m_chordType);
+    // The track keeps a summary of the chord types it uses.
+    const ChordTypeBitset& chordTypesUsed = chordTrack.getChordTypesUsed();
+    for (std::size_t i = 0; i < chordTypesUsed.size(); ++i) {
+        if (chordTypesUsed.test(i)) {
+            chordTypes.insert(static_cast<ChordType::Value>(i));
         }
     }
 
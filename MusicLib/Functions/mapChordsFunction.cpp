@@ -26,7 +26,9 @@
 
 #include <BaseLib/Result/error.hpp>
 
+#include <algorithm>
 #include <optional>
+#include <vector>
 
 babelwires::TypeExp bw_music::getMapChordFunctionSourceTypeExp() {
     return babelwires::SumTypeConstructor::makeTypeExp(
@@ -84,124 +86,93 @@ namespace {
         return decomposeMapTypes(typeSystem, *targetSumType);
     }
 
+    /// A map entry with its enum values decoded to indices, where index 0 is the wildcard.
+    struct DecodedChordMapEntry {
+        bool m_sourceIsNoChord = false;
+        unsigned int m_sourcePitchClassIndex = 0;
+        unsigned int m_sourceChordTypeIndex = 0;
+        bool m_targetIsNoChord = false;
+        unsigned int m_targetPitchClassIndex = 0;
+        unsigned int m_targetChordTypeIndex = 0;
+
+        bool matches(const bw_music::Chord& chord) const {
+            return !m_sourceIsNoChord &&
+                   ((static_cast<unsigned int>(chord.m_root) + 1 == m_sourcePitchClassIndex) ||
+                    (m_sourcePitchClassIndex == 0)) &&
+                   ((static_cast<unsigned int>(chord.m_chordType) + 1 == m_sourceChordTypeIndex) ||
+                    (m_sourceChordTypeIndex == 0));
+        }
+
+        std::optional<bw_music::Chord> getTarget(const bw_music::Chord& chord) const {
+            if (m_targetIsNoChord) {
+                return {};
+            }
+            const bw_music::PitchClass::Value newPitchClass =
+                (m_targetPitchClassIndex == 0) ? chord.m_root
+                                               : static_cast<bw_music::PitchClass::Value>(m_targetPitchClassIndex - 1);
+            const bw_music::ChordType::Value newChordType =
+                (m_targetChordTypeIndex == 0) ? chord.m_chordType
+                                              : static_cast<bw_music::ChordType::Value>(m_targetChordTypeIndex - 1);
+            return bw_music::Chord{newPitchClass, newChordType};
+        }
+    };
+
     /// As yet, there is no generic handling of wildcards when they occur within tuples, as in this case.
     /// Therefore, I cannot use one of the preexisting applicators.
+    /// The enum adapters are only used to decode the entries once, after which matching works on indices.
     /// TODO: Can this be made generic?
-    class ChordMapApplicator {
+    class ChordMapDecoder {
       public:
-        ChordMapApplicator(const babelwires::TypeSystem& typeSystem, const babelwires::MapValue& mapValue)
-            : ChordMapApplicator(mapValue, getSourceTupleComponentTypes(typeSystem),
-                                 getTargetTupleComponentTypes(typeSystem)) {}
+        ChordMapDecoder(const babelwires::TypeSystem& typeSystem)
+            : ChordMapDecoder(getSourceTupleComponentTypes(typeSystem), getTargetTupleComponentTypes(typeSystem)) {}
 
-        /// This isn't memoized, so the caller should remember it.
-        std::optional<bw_music::Chord> getNoChordTarget() {
-            // Since the map is valid, the last entry only will be a fallback.
-            for (int i = 0; i < m_mapValue.getNumMapEntries() - 1; ++i) {
-                const babelwires::MapEntryData& entry = m_mapValue.getMapEntry(i);
-                if (entry.getSourceValue()->tryAs<babelwires::EnumValue>()) {
-                    assert(entry.getSourceValue()->tryAs<babelwires::EnumValue>()->get() ==
-                               bw_music::NoChord::getNoChordValue() &&
-                           "Bare EnumValue in ChordMap source that wasn't the NoChord value");
-                    if (entry.getTargetValue()->tryAs<babelwires::EnumValue>()) {
-                        assert(entry.getTargetValue()->tryAs<babelwires::EnumValue>()->get() ==
-                                   bw_music::NoChord::getNoChordValue() &&
-                               "Bare EnumValue in ChordMap target that wasn't the NoChord value");
-                        return {};
-                    } else {
-                        const babelwires::TupleValue& target = entry.getTargetValue()->as<babelwires::TupleValue>();
-                        const unsigned int pitchClassIndex =
-                            m_targetPitchClassAdapter(target.getValue(0)->as<babelwires::EnumValue>());
-                        const unsigned int chordTypeIndex =
-                            m_targetChordTypeAdapter(target.getValue(1)->as<babelwires::EnumValue>());
-                        assert((pitchClassIndex != 0) && (chordTypeIndex != 0) && "NoChord cannot be mapped to wildcard value");
-                        return bw_music::Chord{bw_music::PitchClass::Value(pitchClassIndex - 1),
-                                               bw_music::ChordType::Value(chordTypeIndex - 1)};
-                    }
-                }
-            }
-            // I think it would be expected that NoChord->NoChord if not specified, so the fallback is ignored.
-            return {};
-        };
-
-        std::optional<bw_music::Chord> operator[](const bw_music::Chord& chord) {
-            const std::uint16_t code = chordToCode(chord);
-            const auto [it, wasInserted] = m_memo.try_emplace(code, -2);
-            std::uint16_t& newCode = it->second;
-            if (wasInserted) {
-                unsigned int matchingEntry = 0;
-                while (matchingEntry < m_mapValue.getNumMapEntries() - 1) {
-                    const babelwires::MapEntryData& entry = m_mapValue.getMapEntry(matchingEntry);
+        /// Since the map is valid, the last entry only will be a fallback, whose source is not decoded.
+        std::vector<DecodedChordMapEntry> decodeEntries(const babelwires::MapValue& mapValue) {
+            std::vector<DecodedChordMapEntry> entries;
+            entries.resize(mapValue.getNumMapEntries());
+            for (unsigned int i = 0; i < mapValue.getNumMapEntries(); ++i) {
+                const babelwires::MapEntryData& entry = mapValue.getMapEntry(i);
+                DecodedChordMapEntry& decodedEntry = entries[i];
+                if (i < mapValue.getNumMapEntries() - 1) {
                     if (const babelwires::TupleValue* sourceTuple =
                             entry.getSourceValue()->tryAs<babelwires::TupleValue>()) {
-                        const unsigned int pitchClassIndex =
+                        decodedEntry.m_sourcePitchClassIndex =
                             m_sourcePitchClassAdapter(sourceTuple->getValue(0)->as<babelwires::EnumValue>());
-                        const unsigned int chordTypeIndex =
+                        decodedEntry.m_sourceChordTypeIndex =
                             m_sourceChordTypeAdapter(sourceTuple->getValue(1)->as<babelwires::EnumValue>());
-                        if (((static_cast<unsigned int>(chord.m_root) + 1 == pitchClassIndex) ||
-                             (pitchClassIndex == 0)) &&
-                            ((static_cast<unsigned int>(chord.m_chordType) + 1 == chordTypeIndex) ||
-                             (chordTypeIndex == 0))) {
-                            // Found match.
-                            break;
-                        }
+                    } else {
+                        assert(entry.getSourceValue()->as<babelwires::EnumValue>().get() ==
+                                   bw_music::NoChord::getNoChordValue() &&
+                               "Bare EnumValue in ChordMap source that wasn't the NoChord value");
+                        decodedEntry.m_sourceIsNoChord = true;
                     }
-                    ++matchingEntry;
                 }
-                const babelwires::MapEntryData& entry = m_mapValue.getMapEntry(matchingEntry);
                 if (entry.getTargetValue()->tryAs<babelwires::EnumValue>()) {
                     assert(entry.getTargetValue()->tryAs<babelwires::EnumValue>()->get() ==
                                bw_music::NoChord::getNoChordValue() &&
                            "Bare EnumValue in ChordMap target that wasn't the NoChord value");
-                    newCode = -1;
+                    decodedEntry.m_targetIsNoChord = true;
                 } else {
                     const babelwires::TupleValue& target = entry.getTargetValue()->as<babelwires::TupleValue>();
-                    unsigned int targetPitchClassIndex =
+                    decodedEntry.m_targetPitchClassIndex =
                         m_targetPitchClassAdapter(target.getValue(0)->as<babelwires::EnumValue>());
-                    bw_music::PitchClass::Value newPitchClass =
-                        (targetPitchClassIndex == 0)
-                            ? chord.m_root
-                            : static_cast<bw_music::PitchClass::Value>(targetPitchClassIndex - 1);
-
-                    unsigned int targetChordTypeIndex =
+                    decodedEntry.m_targetChordTypeIndex =
                         m_targetChordTypeAdapter(target.getValue(1)->as<babelwires::EnumValue>());
-                    bw_music::ChordType::Value newChordType =
-                        (targetChordTypeIndex == 0) ? chord.m_chordType
-                                                    : static_cast<bw_music::ChordType::Value>(targetChordTypeIndex - 1);
-
-                    newCode = chordToCode(bw_music::Chord(newPitchClass, newChordType));
                 }
             }
-            assert((newCode != -2) && "Entry not inserted");
-            return codeToChord(newCode);
+            return entries;
         }
 
       private:
-        ChordMapApplicator(
-            const babelwires::MapValue& mapValue,
+        ChordMapDecoder(
             std::tuple<const babelwires::TypePtrT<babelwires::EnumType>, const babelwires::TypePtrT<babelwires::EnumType>> sourceTupleComponentTypes,
             std::tuple<const babelwires::TypePtrT<babelwires::EnumType>, const babelwires::TypePtrT<babelwires::EnumType>> targetTupleComponentTypes)
-            : m_mapValue(mapValue)
-            , m_sourcePitchClassAdapter(std::get<0>(sourceTupleComponentTypes))
+            : m_sourcePitchClassAdapter(std::get<0>(sourceTupleComponentTypes))
             , m_sourceChordTypeAdapter(std::get<1>(sourceTupleComponentTypes))
             , m_targetPitchClassAdapter(std::get<0>(targetTupleComponentTypes))
             , m_targetChordTypeAdapter(std::get<1>(targetTupleComponentTypes)) {}
 
-        std::uint16_t chordToCode(const bw_music::Chord& chord) const {
-            return (static_cast<std::uint8_t>(chord.m_root) << 8) | static_cast<std::uint8_t>(chord.m_chordType);
-        }
-
-        std::optional<bw_music::Chord> codeToChord(std::uint16_t code) const {
-            if (code != static_cast<std::uint16_t>(-1)) {
-                return bw_music::Chord{static_cast<bw_music::PitchClass::Value>(code >> 8),
-                                       static_cast<bw_music::ChordType::Value>(code & 255)};
-            } else {
-                return {};
-            }
-        }
-
       private:
-        std::unordered_map<std::uint16_t, std::uint16_t> m_memo;
-        const babelwires::MapValue& m_mapValue;
         babelwires::EnumToIndexValueAdapter m_sourcePitchClassAdapter;
         babelwires::EnumToIndexValueAdapter m_sourceChordTypeAdapter;
         babelwires::EnumToIndexValueAdapter m_targetPitchClassAdapter;
@@ -209,6 +180,33 @@ namespace {
     };
 } // namespace
 
+bw_music::CompiledChordMap::CompiledChordMap(const babelwires::TypeSystem& typeSystem,
+                                             const babelwires::MapValue& chordMapValue) {
+    assert(chordMapValue.isValid(typeSystem) && "The Chord Type Map is not valid");
+    const std::vector<DecodedChordMapEntry> entries = ChordMapDecoder(typeSystem).decodeEntries(chordMapValue);
+
+    for (unsigned int root = 0; root < static_cast<unsigned int>(PitchClass::Value::NUM_VALUES); ++root) {
+        for (unsigned int chordType = 0; chordType < c_numChordTypes; ++chordType) {
+            const Chord chord{static_cast<PitchClass::Value>(root), static_cast<ChordType::Value>(chordType)};
+            // If nothing matches, this finds the fallback entry.
+            const auto it = std::find_if(entries.begin(), entries.end() - 1,
+                                         [&chord](const DecodedChordMapEntry& entry) { return entry.matches(chord); });
+            m_targets[getIndex(chord)] = it->getTarget(chord);
+        }
+    }
+
+    // I think it would be expected that NoChord->NoChord if not specified, so the fallback is ignored.
+    const auto noChordIt = std::find_if(entries.begin(), entries.end() - 1,
+                                        [](const DecodedChordMapEntry& entry) { return entry.m_sourceIsNoChord; });
+    if (noChordIt != entries.end() - 1) {
+        assert((noChordIt->m_targetIsNoChord ||
+                ((noChordIt->m_targetPitchClassIndex != 0) && (noChordIt->m_targetChordTypeIndex != 0))) &&
+               "NoChord cannot be mapped to wildcard value");
+        // The wildcard-free target does not depend on the chord argument.
+        m_targets[c_noChordIndex] = noChordIt->getTarget(Chord{});
+    }
+}
+
 babelwires::ResultT<bw_music::Track> bw_music::mapChordsFunction(const babelwires::TypeSystem& typeSystem, const Track& sourceTrack,
                                             const babelwires::MapValue& chordMapValue) {
     // TODO Could an invalid map ever reach here? Clarify this somewhere.
@@ -216,12 +214,15 @@ babelwires::ResultT<bw_music::Track> bw_music::mapChordsFunction(const babelwire
         return babelwires::Error() << "The Chord Type Map is not valid.";
     }
 
-    ChordMapApplicator mapApplicator(typeSystem, chordMapValue);
+    return mapChordsFunction(sourceTrack, CompiledChordMap(typeSystem, chordMapValue));
+}
 
+babelwires::ResultT<bw_music::Track> bw_music::mapChordsFunction(const Track& sourceTrack,
+                                                                 const CompiledChordMap& chordMap) {
     TrackBuilder trackOut;
     ModelDuration totalEventDuration;
 
-    std::optional<bw_music::Chord> silenceToChordChord = mapApplicator.getNoChordTarget();
+    std::optional<bw_music::Chord> silenceToChordChord = chordMap.getNoChordTarget();
 
     enum {
         pending,
@@ -245,7 +246,7 @@ babelwires::ResultT<bw_music::Track> bw_music::mapChordsFunction(const babelwire
         if (it->tryAs<ChordOnEvent>()) {
             TrackEventHolder holder(*it);
             Chord& chord = holder->as<ChordOnEvent>().m_chord;
-            if (std::optional<bw_music::Chord> targetChord = mapApplicator[chord]) {
+            if (std::optional<bw_music::Chord> targetChord = chordMap[chord]) {
                 if (state == silenceToChord) {
                     trackOut.addEvent(ChordOffEvent(timeSinceLastEvent));
                     timeSinceLastEvent = 0;
@@ -8,9 +8,13 @@
  * Licensed under the GPLv3.0. See LICENSE file.
  **/
 #include <MusicLib/Types/Track/track.hpp>
+#include <MusicLib/chord.hpp>
 
 #include <BaseLib/Result/result.hpp>
 
+#include <array>
+#include <optional>
+
 namespace babelwires {
     class MapValue;
     class TypeSystem;
@@ -20,8 +24,41 @@ namespace bw_music {
     MUSICLIB_API babelwires::TypeExp getMapChordFunctionSourceTypeExp();
     MUSICLIB_API babelwires::TypeExp getMapChordFunctionTargetTypeExp();
 
+    /// A chord map compiled into a dense table of target chords, so mapping a chord costs a single lookup.
+    /// Compiling a map once allows it to be applied to many tracks.
+    class MUSICLIB_API CompiledChordMap {
+      public:
+        /// The chordMapValue must be valid.
+        CompiledChordMap(const babelwires::TypeSystem& typeSystem, const babelwires::MapValue& chordMapValue);
+
+        /// Get the chord the given chord is mapped to, or nothing if it is mapped to NoChord.
+        std::optional<Chord> operator[](Chord chord) const { return m_targets[getIndex(chord)]; }
+
+        /// Get the chord that should be active when no chord in the source track is active, if any.
+        std::optional<Chord> getNoChordTarget() const { return m_targets[c_noChordIndex]; }
+
+      private:
+        static constexpr unsigned int c_numChordTypes = static_cast<unsigned int>(ChordType::Value::NUM_VALUES);
+        static constexpr unsigned int c_numChords =
+            static_cast<unsigned int>(PitchClass::Value::NUM_VALUES) * c_numChordTypes;
+        /// The NoChord target is stored after the targets of the real chords.
+        static constexpr unsigned int c_noChordIndex = c_numChords;
+
+        static unsigned int getIndex(Chord chord) {
+            assert((chord.m_chordType != ChordType::Value::NotAValue) && "Cannot map a chord without a chord type");
+            return (static_cast<unsigned int>(chord.m_root) * c_numChordTypes) +
+                   static_cast<unsigned int>(chord.m_chordType);
+        }
+
+      private:
+        std::array<std::optional<Chord>, c_numChords + 1> m_targets;
+    };
+
     /// Apply maps to chord events in the track.
     /// You can specify a chord that should be active when no chord in the sourceTrack is active
     /// by having blanks in the source map.
     MUSICLIB_API babelwires::ResultT<Track> mapChordsFunction(const babelwires::TypeSystem& typeSystem, const Track& sourceTrack, const babelwires::MapValue& chordMapValue);
+
+    /// Apply an already compiled chord map to chord events in the track.
+    MUSICLIB_API babelwires::ResultT<Track> mapChordsFunction(const Track& sourceTrack, const CompiledChordMap& chordMap);
 }
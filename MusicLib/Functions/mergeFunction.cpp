@@ -10,42 +10,117 @@
 #include <MusicLib/Utilities/trackTraverser.hpp>
 #include <MusicLib/Types/Track/trackBuilder.hpp>
 
-babelwires::ResultT<bw_music::Track> bw_music::mergeTracks(const std::vector<const Track*>& sourceTracks) {
-    TrackBuilder trackOut;
+#include <algorithm>
 
-    bw_music::ModelDuration trackDuration = 0;
-    std::vector<TrackTraverser<Track::const_iterator>> traversers;
+namespace {
+    /// Merge the events of the sourceTracks which occur at or after startTime into trackOut.
+    /// The events trackOut already holds must be the merge of the events before startTime, ending at timeOfLastEventOut.
+    bw_music::Track mergeTracksFrom(const std::vector<const bw_music::Track*>& sourceTracks,
+                                    bw_music::TrackBuilder& trackOut, bw_music::ModelDuration startTime,
+                                    bw_music::ModelDuration timeOfLastEventOut) {
+        bw_music::ModelDuration trackDuration = 0;
+        std::vector<bw_music::TrackTraverser<bw_music::Track::const_iterator>> traversers;
 
-    const int numTracks = sourceTracks.size();
-    traversers.reserve(numTracks);
+        const int numTracks = sourceTracks.size();
+        traversers.reserve(numTracks);
 
-    for (int i = 0; i < numTracks; ++i) {
-        const bw_music::Track& track = *sourceTracks[i];
-        traversers.emplace_back(track, track);
-        traversers.back().leastUpperBoundDuration(trackDuration);
+        for (int i = 0; i < numTracks; ++i) {
+            const bw_music::Track& track = *sourceTracks[i];
+            traversers.emplace_back(track, track);
+            traversers.back().leastUpperBoundDuration(trackDuration);
+        }
+
+        // Skip the events before startTime, which are already merged.
+        bw_music::ModelDuration timeSinceStart = 0;
+        while (timeSinceStart < trackDuration) {
+            bw_music::ModelDuration timeToNextEvent = trackDuration - timeSinceStart;
+            for (int i = 0; i < numTracks; ++i) {
+                traversers[i].greatestLowerBoundNextEvent(timeToNextEvent);
+            }
+            if (timeSinceStart + timeToNextEvent >= startTime) {
+                break;
+            }
+            for (int i = 0; i < numTracks; ++i) {
+                traversers[i].advance(timeToNextEvent, [](const bw_music::TrackEvent&) {});
+            }
+            timeSinceStart += timeToNextEvent;
+        }
+
+        // The time between the last event in trackOut and the current time.
+        bw_music::ModelDuration timeSinceLastEventOut = timeSinceStart - timeOfLastEventOut;
+        while (timeSinceStart < trackDuration) {
+            bw_music::ModelDuration timeToNextEvent = trackDuration - timeSinceStart;
+            for (int i = 0; i < numTracks; ++i) {
+                traversers[i].greatestLowerBoundNextEvent(timeToNextEvent);
+            }
+
+            bool isFirstEvent = true;
+            for (int i = 0; i < numTracks; ++i) {
+                traversers[i].advance(timeToNextEvent, [&isFirstEvent, &timeToNextEvent, &timeSinceLastEventOut,
+                                                        &trackOut](const bw_music::TrackEvent& event) {
+                    bw_music::TrackEventHolder newEvent = event;
+                    newEvent->setTimeSinceLastEvent(isFirstEvent ? timeSinceLastEventOut + timeToNextEvent : 0);
+                    trackOut.addEvent(newEvent.release());
+                    isFirstEvent = false;
+                    timeSinceLastEventOut = 0;
+                });
+            }
+
+            timeSinceStart += timeToNextEvent;
+        }
+
+        return trackOut.finishAndGetTrack(trackDuration);
     }
 
-    bw_music::ModelDuration timeSinceStart = 0;
-    while (timeSinceStart < trackDuration) {
-        bw_music::ModelDuration timeToNextEvent = trackDuration - timeSinceStart;
-        for (int i = 0; i < numTracks; ++i) {
-            traversers[i].greatestLowerBoundNextEvent(timeToNextEvent);
+    /// Get a time before which the two tracks have the same events.
+    bw_music::ModelDuration getTimeOfFirstDifference(const bw_music::Track& trackA, const bw_music::Track& trackB) {
+        bw_music::ModelDuration time = 0;
+        auto itA = trackA.begin();
+        auto itB = trackB.begin();
+        while ((itA != trackA.end()) && (itB != trackB.end()) && (*itA == *itB)) {
+            time += itA->getTimeSinceLastEvent();
+            ++itA;
+            ++itB;
         }
+        if (itA == trackA.end()) {
+            return (itB == trackB.end()) ? time : time + itB->getTimeSinceLastEvent();
+        } else if (itB == trackB.end()) {
+            return time + itA->getTimeSinceLastEvent();
+        }
+        return time + std::min(itA->getTimeSinceLastEvent(), itB->getTimeSinceLastEvent());
+    }
 
-        bool isFirstEvent = true;
-        for (int i = 0; i < numTracks; ++i) {
-            const bw_music::Track& track = *sourceTracks[i];
-            traversers[i].advance(timeToNextEvent,
-                                  [&isFirstEvent, &timeToNextEvent, &trackOut](const TrackEvent& event) {
-                                      TrackEventHolder newEvent = event;
-                                      newEvent->setTimeSinceLastEvent(isFirstEvent ? timeToNextEvent : 0);
-                                      trackOut.addEvent(newEvent.release());
-                                      isFirstEvent = false;
-                                  });
+    /// The time of the last event in any of the tracks.
+    bw_music::ModelDuration getTimeOfLastEvent(const std::vector<const bw_music::Track*>& tracks) {
+        bw_music::ModelDuration timeOfLastEvent = 0;
+        for (const bw_music::Track* track : tracks) {
+            timeOfLastEvent = std::max(timeOfLastEvent, track->getTotalEventDuration());
         }
+        return timeOfLastEvent;
+    }
+} // namespace
+
+babelwires::ResultT<bw_music::Track> bw_music::mergeTracks(const std::vector<const Track*>& sourceTracks) {
+    TrackBuilder trackOut;
+    return mergeTracksFrom(sourceTracks, trackOut, 0, 0);
+}
 
-        timeSinceStart += timeToNextEvent;
+babelwires::ResultT<bw_music::Track> bw_music::mergeTracks(const std::vector<const Track*>& sourceTracks,
+                                                           const std::vector<const Track*>& previousSourceTracks,
+                                                           const Track& previousMerge) {
+    assert((sourceTracks.size() == previousSourceTracks.size()) && "The number of tracks must be the same");
+
+    // The builder only looks at the events at one instant at a time, so its output before the first difference
+    // depends only on the events before it. The exception is the last instant of the tracks, when the builder drops
+    // the start of groups and ends any open groups, so that instant is always merged again.
+    ModelDuration startTime = std::min(getTimeOfLastEvent(sourceTracks), getTimeOfLastEvent(previousSourceTracks));
+    for (unsigned int i = 0; i < sourceTracks.size(); ++i) {
+        if (sourceTracks[i] != previousSourceTracks[i]) {
+            startTime = std::min(startTime, getTimeOfFirstDifference(*sourceTracks[i], *previousSourceTracks[i]));
+        }
     }
 
-    return trackOut.finishAndGetTrack(trackDuration);
+    TrackBuilder trackOut;
+    const ModelDuration timeOfLastEventOut = trackOut.addEventsOfTrackBefore(previousMerge, startTime);
+    return mergeTracksFrom(sourceTracks, trackOut, startTime, timeOfLastEventOut);
 }
@@ -16,4 +16,13 @@
 namespace bw_music {
     /// Merge the events of the sourceTracks into targetTrack.
     MUSICLIB_API babelwires::ResultT<Track> mergeTracks(const std::vector<const Track*>& sourceTracks);
+
+    /// Merge the sourceTracks, given that previousMerge is the merge of previousSourceTracks.
+    /// Corresponding tracks often have the same events up to some time (e.g. when one part is edited), and the merge
+    /// before that time cannot have changed. Those events of previousMerge are copied rather than merged again, so
+    /// only the events from the earliest difference onwards are merged.
+    /// There must be as many previousSourceTracks as sourceTracks. The result is the same as mergeTracks(sourceTracks).
+    MUSICLIB_API babelwires::ResultT<Track> mergeTracks(const std::vector<const Track*>& sourceTracks,
+                                                        const std::vector<const Track*>& previousSourceTracks,
+                                                        const Track& previousMerge);
 } // namespace bw_music
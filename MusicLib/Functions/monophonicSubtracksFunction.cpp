@@ -13,7 +13,11 @@
 #include <BaseLib/Identifiers/registeredIdentifier.hpp>
 
 #include <algorithm>
-#include <set>
+#include <array>
+#include <bit>
+#include <limits>
+#include <numeric>
+#include <queue>
 
 ENUM_DEFINE_ENUM_VALUE_SOURCE(bw_music::MonophonicSubtracksPolicyEnum, MONOPHONIC_SUBTRACK_POLICY);
 
@@ -32,95 +36,183 @@ namespace {
     };
 
     struct NoteEventInfo {
-        /// Notes only.
-        bw_music::TrackEventHolder m_event;
+        /// Notes only. This points into the input track, so the event is only copied when it is emitted.
+        const bw_music::TrackEvent* m_event;
+        /// Cached so sorting does not need to query the event.
+        bw_music::TrackEvent::GroupingInfo m_groupInfo;
         /// This is used to ensure sorting is stable when other factors compare equal.
         int m_originalIndex;
     };
 
-    using PitchSet = std::set<bw_music::TrackEvent::GroupKey::GroupValue>;
+    /// A set of pitches which can find its lowest and highest member without scanning every pitch.
+    class PitchSet {
+      public:
+        void insert(bw_music::Pitch pitch) { m_words[pitch / 64] |= (std::uint64_t(1) << (pitch % 64)); }
+        void erase(bw_music::Pitch pitch) { m_words[pitch / 64] &= ~(std::uint64_t(1) << (pitch % 64)); }
+        bool contains(bw_music::Pitch pitch) const { return m_words[pitch / 64] & (std::uint64_t(1) << (pitch % 64)); }
 
-    void moveEventToOtherTrack(bw_music::ModelDuration& timeSinceLastEventOther, bw_music::TrackEventHolder& event,
-                               TrackBuilders& result) {
-        event->setTimeSinceLastEvent(timeSinceLastEventOther);
-        result.m_other.addEvent(event.release());
-        timeSinceLastEventOther = 0;
-    }
+        /// Returns -1 if the set is empty.
+        int getLowest() const {
+            for (int w = 0; w < c_numWords; ++w) {
+                if (m_words[w] != 0) {
+                    return (w * 64) + std::countr_zero(m_words[w]);
+                }
+            }
+            return -1;
+        }
 
-    void moveNoteEventToTrack(std::vector<TrackInfo>& trackInfos, NoteEventInfo& noteEvent, int trackToUse,
-                              TrackBuilders& result) {
-        const bw_music::TrackEvent::GroupingInfo groupInfo = noteEvent.m_event->getGroupingInfo();
-        auto& t = trackInfos[trackToUse];
-        noteEvent.m_event->setTimeSinceLastEvent(t.m_timeSinceLastEvent);
-        result.m_noteTracks[trackToUse].addEvent(noteEvent.m_event.release());
-        if (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::StartOfGroup) {
-            // Too strong?
-            assert(t.m_activeValue == bw_music::TrackEvent::GroupKey::c_notAValue);
-            t.m_activeValue = groupInfo.m_groupKey.m_groupValue;
-        } else if (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::EndOfGroup) {
-            t.m_activeValue = bw_music::TrackEvent::GroupKey::c_notAValue;
+        /// Returns -1 if the set is empty.
+        int getHighest() const {
+            for (int w = c_numWords - 1; w >= 0; --w) {
+                if (m_words[w] != 0) {
+                    return (w * 64) + 63 - std::countl_zero(m_words[w]);
+                }
+            }
+            return -1;
         }
-        t.m_timeSinceLastEvent = 0;
-    }
 
-    void evictEvent(std::vector<TrackInfo>& trackInfos, int trackToUse, PitchSet& evictedPitches,
-                    TrackBuilders& result) {
-        auto& t = trackInfos[trackToUse];
-        const bw_music::Pitch pitchToEvict = trackInfos[trackToUse].m_activeValue;
-        assert((evictedPitches.find(pitchToEvict) == evictedPitches.end()) && "Evicting an already evicted pitch");
-        evictedPitches.insert(pitchToEvict);
-        result.m_noteTracks[trackToUse].addEvent(bw_music::NoteOffEvent{t.m_timeSinceLastEvent, pitchToEvict});
-        t.m_activeValue = bw_music::TrackEvent::GroupKey::c_notAValue;
-        t.m_timeSinceLastEvent = 0;
-    }
+      private:
+        static constexpr int c_numWords = (std::numeric_limits<bw_music::Pitch>::max() + 1) / 64;
+        std::array<std::uint64_t, c_numWords> m_words = {};
+    };
+
+    /// The state needed to assign note events to tracks without scanning the tracks.
+    class TrackAssignment {
+      public:
+        TrackAssignment(int numTracks, bw_music::MonophonicSubtracksPolicyEnum::Value policy)
+            : m_trackInfos(numTracks)
+            , m_isEvicting((policy == bw_music::MonophonicSubtracksPolicyEnum::Value::HighEv) ||
+                           (policy == bw_music::MonophonicSubtracksPolicyEnum::Value::LowEv))
+            , m_preferHigherPitches((policy == bw_music::MonophonicSubtracksPolicyEnum::Value::High) ||
+                                    (policy == bw_music::MonophonicSubtracksPolicyEnum::Value::HighEv)) {
+            m_trackWithPitch.fill(-1);
+            std::vector<int> freeTracks(numTracks);
+            std::iota(freeTracks.begin(), freeTracks.end(), 0);
+            m_freeTracks = FreeTracks(std::greater<int>(), std::move(freeTracks));
+        }
 
-    /// Returns [trackToUse, shouldEvict]
-    std::tuple<int, bool> getTrackToUse(const std::vector<TrackInfo>& trackInfos,
-                                        const bw_music::TrackEventHolder& event,
-                                        bw_music::MonophonicSubtracksPolicyEnum::Value policy) {
-        const bool isEvicting = (policy == bw_music::MonophonicSubtracksPolicyEnum::Value::HighEv) ||
-                                (policy == bw_music::MonophonicSubtracksPolicyEnum::Value::LowEv);
-        const bool preferHigherPitches = (policy == bw_music::MonophonicSubtracksPolicyEnum::Value::High) ||
-                                         (policy == bw_music::MonophonicSubtracksPolicyEnum::Value::HighEv);
-        int trackToUse = -1;
-        bool shouldEvict = false;
-        const auto& groupInfo = event->getGroupingInfo();
-        assert(groupInfo.m_groupKey.m_category == bw_music::NoteEvent::getNoteEventCategory());
-        for (int i = 0; i < trackInfos.size(); ++i) {
-            auto& t = trackInfos[i];
-            if (t.m_activeValue == groupInfo.m_groupKey.m_groupValue) {
-                trackToUse = i;
-                break;
-            } else if ((trackToUse == -1) && (t.m_activeValue == bw_music::TrackEvent::GroupKey::c_notAValue) &&
-                        (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::StartOfGroup)) {
-                trackToUse = i;
+        bool preferHigherPitches() const { return m_preferHigherPitches; }
+
+        void advanceTime(bw_music::ModelDuration timeSinceLastEvent) {
+            for (auto& t : m_trackInfos) {
+                t.m_timeSinceLastEvent += timeSinceLastEvent;
             }
         }
-        if (isEvicting && (trackToUse == -1)) {
-            bw_music::Pitch bestEvictablePitch = preferHigherPitches ? std::numeric_limits<bw_music::Pitch>::max()
-                                                                     : std::numeric_limits<bw_music::Pitch>::min();
-            for (int i = 0; i < trackInfos.size(); ++i) {
-                auto& t = trackInfos[i];
-                if (((groupInfo.m_groupKey.m_groupValue > t.m_activeValue) == preferHigherPitches) &&
-                    ((t.m_activeValue < bestEvictablePitch) == preferHigherPitches)) {
-                    trackToUse = i;
-                    bestEvictablePitch = t.m_activeValue;
-                    shouldEvict = true;
+
+        /// Returns [trackToUse, shouldEvict].
+        /// If a free track is returned, it is considered no longer free.
+        std::tuple<int, bool> getTrackToUse(const bw_music::TrackEvent::GroupingInfo& groupInfo) {
+            assert(groupInfo.m_groupKey.m_category == bw_music::NoteEvent::getNoteEventCategory());
+            const bw_music::Pitch pitch = groupInfo.m_groupKey.m_groupValue;
+            if (const int trackWithPitch = m_trackWithPitch[pitch]; trackWithPitch != -1) {
+                return {trackWithPitch, false};
+            }
+            if (groupInfo.m_groupRole != bw_music::TrackEvent::GroupRole::StartOfGroup) {
+                return {-1, false};
+            }
+            if (!m_freeTracks.empty()) {
+                // Prefer the lowest free track.
+                const int trackToUse = m_freeTracks.top();
+                m_freeTracks.pop();
+                return {trackToUse, false};
+            }
+            if (m_isEvicting) {
+                // Evict the active pitch furthest from the preferred direction, if the new pitch beats it.
+                if (m_preferHigherPitches) {
+                    const int lowestPitch = m_activePitches.getLowest();
+                    if ((lowestPitch != -1) && (lowestPitch < pitch)) {
+                        return {m_trackWithPitch[lowestPitch], true};
+                    }
+                } else {
+                    const int highestPitch = m_activePitches.getHighest();
+                    if ((highestPitch != -1) && (highestPitch > pitch)) {
+                        return {m_trackWithPitch[highestPitch], true};
+                    }
                 }
             }
+            return {-1, false};
         }
-        return {trackToUse, shouldEvict};
+
+        void moveNoteEventToTrack(NoteEventInfo& noteEvent, int trackToUse, TrackBuilders& result) {
+            const bw_music::TrackEvent::GroupingInfo& groupInfo = noteEvent.m_groupInfo;
+            const bw_music::Pitch pitch = groupInfo.m_groupKey.m_groupValue;
+            auto& t = m_trackInfos[trackToUse];
+            bw_music::TrackEventHolder event = *noteEvent.m_event;
+            event->setTimeSinceLastEvent(t.m_timeSinceLastEvent);
+            result.m_noteTracks[trackToUse].addEvent(event.release());
+            if (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::StartOfGroup) {
+                // Too strong?
+                assert(t.m_activeValue == bw_music::TrackEvent::GroupKey::c_notAValue);
+                t.m_activeValue = pitch;
+                m_trackWithPitch[pitch] = trackToUse;
+                m_activePitches.insert(pitch);
+            } else if (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::EndOfGroup) {
+                t.m_activeValue = bw_music::TrackEvent::GroupKey::c_notAValue;
+                m_trackWithPitch[pitch] = -1;
+                m_activePitches.erase(pitch);
+                m_freeTracks.push(trackToUse);
+            }
+            t.m_timeSinceLastEvent = 0;
+        }
+
+        void evictEvent(int trackToUse, TrackBuilders& result) {
+            auto& t = m_trackInfos[trackToUse];
+            const bw_music::Pitch pitchToEvict = t.m_activeValue;
+            assert(!m_evictedPitches.contains(pitchToEvict) && "Evicting an already evicted pitch");
+            m_evictedPitches.insert(pitchToEvict);
+            result.m_noteTracks[trackToUse].addEvent(bw_music::NoteOffEvent{t.m_timeSinceLastEvent, pitchToEvict});
+            t.m_activeValue = bw_music::TrackEvent::GroupKey::c_notAValue;
+            t.m_timeSinceLastEvent = 0;
+            m_trackWithPitch[pitchToEvict] = -1;
+            m_activePitches.erase(pitchToEvict);
+            // The track is not returned to m_freeTracks, since the evicting event is about to occupy it.
+        }
+
+        /// Returns true if the event belongs to an evicted note, in which case it should be dropped.
+        bool consumeIfEvicted(const bw_music::TrackEvent::GroupingInfo& groupInfo) {
+            const bw_music::Pitch pitch = groupInfo.m_groupKey.m_groupValue;
+            if (!m_evictedPitches.contains(pitch)) {
+                return false;
+            }
+            if (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::EndOfGroup) {
+                m_evictedPitches.erase(pitch);
+            }
+            return true;
+        }
+
+      private:
+        std::vector<TrackInfo> m_trackInfos;
+
+        /// The track in which each pitch is currently active, or -1.
+        std::array<int, std::numeric_limits<bw_music::Pitch>::max() + 1> m_trackWithPitch;
+
+        /// A min-heap of the tracks with no active note.
+        using FreeTracks = std::priority_queue<int, std::vector<int>, std::greater<int>>;
+        FreeTracks m_freeTracks;
+
+        PitchSet m_activePitches;
+
+        /// Pitches whose notes were evicted, and whose remaining events should be dropped.
+        PitchSet m_evictedPitches;
+
+        bool m_isEvicting;
+        bool m_preferHigherPitches;
+    };
+
+    void moveEventToOtherTrack(bw_music::ModelDuration& timeSinceLastEventOther, const bw_music::TrackEvent& event,
+                               TrackBuilders& result) {
+        bw_music::TrackEventHolder otherEvent = event;
+        otherEvent->setTimeSinceLastEvent(timeSinceLastEventOther);
+        result.m_other.addEvent(otherEvent.release());
+        timeSinceLastEventOther = 0;
     }
 
-    void assignNoteEventsToTracks(std::vector<TrackInfo>& trackInfos, bw_music::ModelDuration& timeSinceLastEventOther,
-                                  std::vector<NoteEventInfo>& noteEvents, PitchSet& evictedPitches,
-                                  bw_music::MonophonicSubtracksPolicyEnum::Value policy,
-                                  TrackBuilders& result) {
-        const bool preferHigherPitches = (policy == bw_music::MonophonicSubtracksPolicyEnum::Value::High) ||
-                                         (policy == bw_music::MonophonicSubtracksPolicyEnum::Value::HighEv);
-        const auto lessThan = [preferHigherPitches](NoteEventInfo& a, NoteEventInfo& b) {
-            const auto& groupInfoA = a.m_event->getGroupingInfo();
-            const auto& groupInfoB = b.m_event->getGroupingInfo();
+    void assignNoteEventsToTracks(TrackAssignment& assignment, bw_music::ModelDuration& timeSinceLastEventOther,
+                                  std::vector<NoteEventInfo>& noteEvents, TrackBuilders& result) {
+        const bool preferHigherPitches = assignment.preferHigherPitches();
+        const auto lessThan = [preferHigherPitches](const NoteEventInfo& a, const NoteEventInfo& b) {
+            const auto& groupInfoA = a.m_groupInfo;
+            const auto& groupInfoB = b.m_groupInfo;
             if ((groupInfoA.m_groupRole == bw_music::TrackEvent::GroupRole::EndOfGroup) &&
                 (groupInfoB.m_groupRole == bw_music::TrackEvent::GroupRole::StartOfGroup)) {
                 return true;
@@ -142,21 +234,15 @@ namespace {
         std::sort(noteEvents.begin(), noteEvents.end(), lessThan);
 
         for (auto& noteEvent : noteEvents) {
-            const bw_music::TrackEvent::GroupingInfo groupInfo = noteEvent.m_event->getGroupingInfo();
-            const auto it = evictedPitches.find(groupInfo.m_groupKey.m_groupValue);
-            if (it != evictedPitches.end()) {
-                if (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::EndOfGroup) {
-                    evictedPitches.erase(it);
-                } // else ignore this event.
-            } else {
-                const auto [trackToUse, shouldEvict] = getTrackToUse(trackInfos, noteEvent.m_event, policy);
+            if (!assignment.consumeIfEvicted(noteEvent.m_groupInfo)) {
+                const auto [trackToUse, shouldEvict] = assignment.getTrackToUse(noteEvent.m_groupInfo);
                 if (trackToUse != -1) {
                     if (shouldEvict) {
-                        evictEvent(trackInfos, trackToUse, evictedPitches, result);
+                        assignment.evictEvent(trackToUse, result);
                     }
-                    moveNoteEventToTrack(trackInfos, noteEvent, trackToUse, result);
+                    assignment.moveNoteEventToTrack(noteEvent, trackToUse, result);
                 } else {
-                    moveEventToOtherTrack(timeSinceLastEventOther, noteEvent.m_event, result);
+                    moveEventToOtherTrack(timeSinceLastEventOther, *noteEvent.m_event, result);
                 }
             }
         }
@@ -168,37 +254,29 @@ babelwires::ResultT<bw_music::MonophonicSubtracksResult> bw_music::getMonophonic
     assert(numTracks > 0);
     TrackBuilders builders;
 
-    std::vector<TrackInfo> trackInfos;
-    trackInfos.resize(numTracks);
+    TrackAssignment assignment(numTracks, policy);
     builders.m_noteTracks.resize(numTracks);
     ModelDuration timeSinceLastEventOther;
 
     std::vector<NoteEventInfo> noteEventsNow;
-    PitchSet evictedPitches;
 
     for (auto& event : trackIn) {
         if (event.getTimeSinceLastEvent() != 0) {
-            assignNoteEventsToTracks(trackInfos, timeSinceLastEventOther, noteEventsNow, evictedPitches, policy,
-                                     builders);
+            assignNoteEventsToTracks(assignment, timeSinceLastEventOther, noteEventsNow, builders);
             noteEventsNow.clear();
 
-            for (auto& t : trackInfos) {
-                t.m_timeSinceLastEvent += event.getTimeSinceLastEvent();
-            }
+            assignment.advanceTime(event.getTimeSinceLastEvent());
             timeSinceLastEventOther += event.getTimeSinceLastEvent();
         }
 
         const TrackEvent::GroupingInfo groupInfo = event.getGroupingInfo();
         if (groupInfo.m_groupKey.m_category == bw_music::NoteEvent::getNoteEventCategory()) {
-            NoteEventInfo& noteInfo = noteEventsNow.emplace_back();
-            noteInfo.m_event = event;
-            noteInfo.m_originalIndex = noteEventsNow.size() - 1;
+            noteEventsNow.emplace_back(NoteEventInfo{&event, groupInfo, static_cast<int>(noteEventsNow.size())});
         } else {
-            TrackEventHolder otherEvent = event;
-            moveEventToOtherTrack(timeSinceLastEventOther, otherEvent, builders);
+            moveEventToOtherTrack(timeSinceLastEventOther, event, builders);
         }
     }
-    assignNoteEventsToTracks(trackInfos, timeSinceLastEventOther, noteEventsNow, evictedPitches, policy, builders);
+    assignNoteEventsToTracks(assignment, timeSinceLastEventOther, noteEventsNow, builders);
 
     bw_music::MonophonicSubtracksResult result;
     result.m_noteTracks.reserve(builders.m_noteTracks.size());
@@ -1,5 +1,5 @@
 /**
- * Function which applies maps to chord events.
+ * Function which applies maps to percussion events.
  *
  * (C) 2021 Malcolm Tyrrell
  *
@@ -8,9 +8,11 @@
 #include <MusicLib/Functions/percussionMapFunction.hpp>
 
 #include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
+#include <MusicLib/Percussion/percussionInstrumentIndex.hpp>
 #include <MusicLib/Percussion/percussionTypeTag.hpp>
 #include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
 #include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Utilities/concurrentEventModifier.hpp>
 
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
 #include <BabelWiresLib/Types/Enum/enumAtomTypeConstructor.hpp>
@@ -23,6 +25,99 @@
 
 #include <BaseLib/Result/error.hpp>
 
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    /// A percussion map compiled into a table indexed by the PercussionInstrumentIndex of the source instrument, so
+    /// mapping an event which carries its index costs one indexed load.
+    /// Each entry is resolved through the map when its instrument is first seen. Events which were created without an
+    /// index fall back to a hash table keyed by the instrument.
+    class PercussionMapTable {
+      public:
+        struct Target {
+            /// The blank value means the event should be dropped.
+            babelwires::ShortId m_instrument = babelwires::getBlankValueId();
+            bw_music::PercussionInstrumentIndex::Index m_instrumentIndex =
+                bw_music::PercussionInstrumentIndex::c_notInterned;
+            bool m_isResolved = false;
+        };
+
+        PercussionMapTable(const babelwires::MapValue& percussionMapValue)
+            : m_mapApplicator{percussionMapValue, m_enumToIdentifierAdapter, m_enumToIdentifierAdapter}
+            , m_targetsFromIndex(bw_music::PercussionInstrumentIndex::getNumInstruments()) {}
+
+        const Target& getTarget(const bw_music::PercussionEvent& event) {
+            const bw_music::PercussionInstrumentIndex::Index sourceIndex = event.getInstrumentIndex();
+            if (sourceIndex < m_targetsFromIndex.size()) {
+                Target& target = m_targetsFromIndex[sourceIndex];
+                if (!target.m_isResolved) {
+                    target = resolve(event.getInstrument());
+                }
+                return target;
+            }
+            const auto [it, wasInserted] = m_targetsFromInstrument.try_emplace(event.getInstrument());
+            if (wasInserted) {
+                it->second = resolve(event.getInstrument());
+            }
+            return it->second;
+        }
+
+        /// Get the target of an event whose instrument getTarget has already resolved.
+        /// Unlike getTarget, this is safe to call concurrently.
+        const Target& getMemoizedTarget(const bw_music::PercussionEvent& event) const {
+            const bw_music::PercussionInstrumentIndex::Index sourceIndex = event.getInstrumentIndex();
+            if (sourceIndex < m_targetsFromIndex.size()) {
+                assert(m_targetsFromIndex[sourceIndex].m_isResolved && "The target of this instrument was not resolved");
+                return m_targetsFromIndex[sourceIndex];
+            }
+            const auto it = m_targetsFromInstrument.find(event.getInstrument());
+            assert((it != m_targetsFromInstrument.end()) && "The target of this instrument was not resolved");
+            return it->second;
+        }
+
+        /// Whether every instrument looked up so far has a target and no two of them have the same target.
+        /// This is conservative: an instrument seen both with and without an index counts as two sources.
+        bool areResolvedTargetsDistinct() const {
+            std::vector<bool> isTargetUsed(m_targetsFromIndex.size());
+            const auto useTarget = [&isTargetUsed](const Target& target) {
+                // Targets which were not interned (including the blank value) cannot be checked.
+                if ((target.m_instrumentIndex >= isTargetUsed.size()) || isTargetUsed[target.m_instrumentIndex]) {
+                    return false;
+                }
+                isTargetUsed[target.m_instrumentIndex] = true;
+                return true;
+            };
+            for (const auto& target : m_targetsFromIndex) {
+                if (target.m_isResolved && !useTarget(target)) {
+                    return false;
+                }
+            }
+            for (const auto& [sourceInstrument, target] : m_targetsFromInstrument) {
+                if (!useTarget(target)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+      private:
+        Target resolve(babelwires::ShortId sourceInstrument) {
+            Target target;
+            target.m_instrument = m_mapApplicator[sourceInstrument];
+            target.m_instrumentIndex = bw_music::PercussionInstrumentIndex::tryGetIndex(target.m_instrument);
+            target.m_isResolved = true;
+            return target;
+        }
+
+      private:
+        const babelwires::EnumToIdentifierValueAdapter m_enumToIdentifierAdapter;
+        babelwires::UnorderedMapApplicator<babelwires::ShortId, babelwires::ShortId> m_mapApplicator;
+        std::vector<Target> m_targetsFromIndex;
+        std::unordered_map<babelwires::ShortId, Target> m_targetsFromInstrument;
+    };
+} // namespace
+
 babelwires::ResultT<babelwires::TypePtr>
 bw_music::PercussionMapType::constructType(const babelwires::TypeSystem& typeSystem, babelwires::TypeExp newTypeExp,
                                            const babelwires::TypeConstructorArguments& arguments,
@@ -60,38 +155,60 @@ babelwires::ResultT<bw_music::Track> bw_music::mapPercussionFunction(const babel
         return babelwires::Error() << "The Percussion Map is not valid.";
     }
 
-    const babelwires::EnumToIdentifierValueAdapter enumToIdentifierAdapter;
-    babelwires::UnorderedMapApplicator<babelwires::ShortId, babelwires::ShortId> mapApplicator{
-        percussionMapValue, enumToIdentifierAdapter, enumToIdentifierAdapter};
-
-    // The map could make two overlapping notes use the same instrument, which violates the track invariants.
-    // Using the TrackBuilder ensures this is fixed.
-    TrackBuilder trackOut;
-    // If an event is dropped, then we need to carry its time forward for the next event.
-    ModelDuration timeFromDroppedEvent;
-
-    for (auto it = trackIn.begin(); it != trackIn.end(); ++it) {
-        const TrackEvent::GroupingInfo info = it->getGroupingInfo();
-        if (info.m_groupKey.m_category == PercussionEvent::getPercussionEventCategory()) {
-            TrackEventHolder holder(*it);
-            PercussionEvent& percussionEvent = static_cast<PercussionEvent&>(*holder);
-            babelwires::ShortId newInstrument = mapApplicator[percussionEvent.getInstrument()];
-            if (newInstrument != babelwires::getBlankValueId()) {
-                percussionEvent.setInstrument(newInstrument);
-                percussionEvent.setTimeSinceLastEvent(holder->getTimeSinceLastEvent() + timeFromDroppedEvent);
-                timeFromDroppedEvent = 0;
-                trackOut.addEvent(holder.release());
-            } else {
-                timeFromDroppedEvent += it->getTimeSinceLastEvent();
-            }
-        } else if (timeFromDroppedEvent > 0) {
-            TrackEventHolder holder(*it);
-            holder->setTimeSinceLastEvent(holder->getTimeSinceLastEvent() + timeFromDroppedEvent);
-            timeFromDroppedEvent = 0;
-            trackOut.addEvent(holder.release());
-        } else {
-            trackOut.addEvent(*it);
+    PercussionMapTable mapTable(percussionMapValue);
+    const babelwires::ShortId blankValueId = babelwires::getBlankValueId();
+
+    // Resolve all the targets first, so the table is only read while events are modified concurrently.
+    for (const auto& event : trackIn) {
+        if (event.getGroupingInfo().m_groupKey.m_category == PercussionEvent::getPercussionEventCategory()) {
+            mapTable.getTarget(static_cast<const PercussionEvent&>(event));
         }
     }
-    return trackOut.finishAndGetTrack(trackIn.getDuration());
+    // The map could make two overlapping notes use the same instrument. That violates the track invariants,
+    // but the builders used by modifyEventsConcurrently fix it.
+    // Only the percussion events whose instrument changes are copied before they are added.
+    const auto isMapped = [&mapTable](const TrackEvent& event) {
+        if (event.getGroupingInfo().m_groupKey.m_category != PercussionEvent::getPercussionEventCategory()) {
+            return false;
+        }
+        const PercussionEvent& percussionEvent = static_cast<const PercussionEvent&>(event);
+        return mapTable.getMemoizedTarget(percussionEvent).m_instrument != percussionEvent.getInstrument();
+    };
+    return modifyEventsConcurrently(trackIn, isMapped, [&mapTable, blankValueId](TrackEvent& event) {
+        PercussionEvent& percussionEvent = static_cast<PercussionEvent&>(event);
+        const PercussionMapTable::Target& target = mapTable.getMemoizedTarget(percussionEvent);
+        if (target.m_instrument == blankValueId) {
+            return false;
+        }
+        percussionEvent.setInstrument(target.m_instrument, target.m_instrumentIndex);
+        return true;
+    });
+}
+
+babelwires::ResultT<bw_music::Track> bw_music::mapPercussionFunction(const babelwires::TypeSystem& typeSystem, Track&& trackIn,
+                                                const babelwires::MapValue& percussionMapValue) {
+    if (!percussionMapValue.isValid(typeSystem)) {
+        return babelwires::Error() << "The Percussion Map is not valid.";
+    }
+
+    PercussionMapTable mapTable(percussionMapValue);
+
+    // The events can only be modified in place if none are dropped and no two instruments are merged.
+    for (const auto& event : trackIn) {
+        if (event.getGroupingInfo().m_groupKey.m_category == PercussionEvent::getPercussionEventCategory()) {
+            mapTable.getTarget(static_cast<const PercussionEvent&>(event));
+        }
+    }
+    if (!mapTable.areResolvedTargetsDistinct()) {
+        return mapPercussionFunction(typeSystem, static_cast<const Track&>(trackIn), percussionMapValue);
+    }
+
+    trackIn.modifyEventsInPlace([&mapTable](TrackEvent& event) {
+        if (event.getGroupingInfo().m_groupKey.m_category == PercussionEvent::getPercussionEventCategory()) {
+            PercussionEvent& percussionEvent = static_cast<PercussionEvent&>(event);
+            const PercussionMapTable::Target& target = mapTable.getMemoizedTarget(percussionEvent);
+            percussionEvent.setInstrument(target.m_instrument, target.m_instrumentIndex);
+        }
+    });
+    return std::move(trackIn);
 }
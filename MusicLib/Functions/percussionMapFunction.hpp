@@ -39,4 +39,9 @@ namespace bw_music {
     ///
     MUSICLIB_API babelwires::ResultT<Track> mapPercussionFunction(const babelwires::TypeSystem& typeSystem, const Track& sourceTrack,
                                 const babelwires::MapValue& percussionMapValue);
+
+    /// As above, but when no events are dropped and no two instruments are mapped to the same instrument, the events
+    /// of sourceTrack are modified in place.
+    MUSICLIB_API babelwires::ResultT<Track> mapPercussionFunction(const babelwires::TypeSystem& typeSystem, Track&& sourceTrack,
+                                const babelwires::MapValue& percussionMapValue);
 } // namespace bw_music
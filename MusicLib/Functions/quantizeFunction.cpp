@@ -9,41 +9,256 @@
 
 #include <MusicLib/Types/Track/trackBuilder.hpp>
 
+#include <BaseLib/Result/resultDSL.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <vector>
+
 namespace {
-    bw_music::ModelDuration getIdealTime(bw_music::ModelDuration time, bw_music::ModelDuration beat) {
+    /// Times measured as a whole number of ticks of a common denominator.
+    using Ticks = std::int64_t;
+
+    /// Keep tick arithmetic well inside the range of the Rational components, so results convert back safely.
+    constexpr Ticks c_maxTicks = std::numeric_limits<babelwires::Rational::ComponentType>::max() / 2;
+
+    bw_music::ModelDuration roundToBeat(bw_music::ModelDuration time, bw_music::ModelDuration beat) {
         auto [div, mod] = time.divmod(beat);
         if (mod >= beat / 2) {
             ++div;
         }
         return beat * div;
     }
+
+    Ticks roundToBeat(Ticks time, Ticks beat) {
+        Ticks div = time / beat;
+        if ((time % beat) * 2 >= beat) {
+            ++div;
+        }
+        return beat * div;
+    }
+
+    /// The grid point nearest to time among all the grids, preferring the later point on a tie.
+    template <typename T> T getIdealTime(T time, const std::vector<T>& beats) {
+        T bestTime = roundToBeat(time, beats[0]);
+        T bestDistance = (bestTime > time) ? bestTime - time : time - bestTime;
+        for (std::size_t i = 1; i < beats.size(); ++i) {
+            const T candidate = roundToBeat(time, beats[i]);
+            const T distance = (candidate > time) ? candidate - time : time - candidate;
+            if ((distance < bestDistance) || ((distance == bestDistance) && (candidate > bestTime))) {
+                bestTime = candidate;
+                bestDistance = distance;
+            }
+        }
+        return bestTime;
+    }
+
+    /// The lcm of a and b, or nullopt if it would exceed c_maxTicks.
+    std::optional<Ticks> checkedLcm(Ticks a, Ticks b) {
+        const Ticks aOverGcd = a / std::gcd(a, b);
+        if (b > c_maxTicks / aOverGcd) {
+            return {};
+        }
+        return aOverGcd * b;
+    }
+
+    /// Whether d is a whole number of ticks no larger than c_maxTicks, where a tick is 1/ticksPerUnit.
+    bool fitsInTicks(bw_music::ModelDuration d, Ticks ticksPerUnit) {
+        const Ticks denominator = d.getDenominator();
+        return (ticksPerUnit % denominator == 0) && (d.getNumerator() <= c_maxTicks / (ticksPerUnit / denominator));
+    }
+
+    Ticks toTicks(bw_music::ModelDuration d, Ticks ticksPerUnit) {
+        return d.getNumerator() * (ticksPerUnit / d.getDenominator());
+    }
+
+    /// Find a denominator which makes every event time and every beat a whole number of ticks, if there is one
+    /// for which the tick arithmetic cannot overflow.
+    std::optional<Ticks> getCommonTicksPerUnit(const bw_music::Track& trackIn,
+                                               const std::vector<bw_music::ModelDuration>& beats) {
+        // The track maintains the lcm of the denominators of its event times, so the events need not be visited.
+        const auto trackTicksPerUnit = checkedLcm(trackIn.getDuration().getDenominator(), trackIn.getMinimumDenominator());
+        if (!trackTicksPerUnit) {
+            return {};
+        }
+        Ticks ticksPerUnit = *trackTicksPerUnit;
+        for (const auto& beat : beats) {
+            const auto lcm = checkedLcm(ticksPerUnit, beat.getDenominator());
+            if (!lcm) {
+                return {};
+            }
+            ticksPerUnit = *lcm;
+        }
+        // Event times are bounded by the track duration, so checking the duration is enough.
+        // The last grid point may lie a beat beyond the duration.
+        if (!fitsInTicks(trackIn.getDuration(), ticksPerUnit)) {
+            return {};
+        }
+        const Ticks durationInTicks = toTicks(trackIn.getDuration(), ticksPerUnit);
+        for (const auto& beat : beats) {
+            if (!fitsInTicks(beat, ticksPerUnit) || (toTicks(beat, ticksPerUnit) > c_maxTicks - durationInTicks)) {
+                return {};
+            }
+        }
+        return ticksPerUnit;
+    }
+
+    /// Snaps times to the grids using integer arithmetic, when all times are whole numbers of ticks.
+    class TickQuantizer {
+      public:
+        TickQuantizer(const std::vector<bw_music::ModelDuration>& beats, Ticks ticksPerUnit)
+            : m_ticksPerUnit(ticksPerUnit) {
+            m_beats.reserve(beats.size());
+            for (const auto& beat : beats) {
+                m_beats.emplace_back(toTicks(beat, ticksPerUnit));
+            }
+        }
+
+        /// Given the time since the last event of the input, return the time since the last quantized event.
+        bw_music::ModelDuration advance(bw_music::ModelDuration timeSinceLastEvent) {
+            m_trackInAbsoluteTime += toTicks(timeSinceLastEvent, m_ticksPerUnit);
+            const Ticks idealTime = getIdealTime(m_trackInAbsoluteTime, m_beats);
+            const bw_music::ModelDuration newTimeSinceLastEvent(idealTime - m_trackOutAbsoluteTime, m_ticksPerUnit);
+            m_trackOutAbsoluteTime = idealTime;
+            return newTimeSinceLastEvent;
+        }
+
+        bw_music::ModelDuration getIdealDuration(bw_music::ModelDuration duration) const {
+            return bw_music::ModelDuration(getIdealTime(toTicks(duration, m_ticksPerUnit), m_beats), m_ticksPerUnit);
+        }
+
+      private:
+        std::vector<Ticks> m_beats;
+        Ticks m_ticksPerUnit;
+        Ticks m_trackInAbsoluteTime = 0;
+        Ticks m_trackOutAbsoluteTime = 0;
+    };
+
+    /// Snaps times to the grids with rational arithmetic, which works for any times and beats.
+    class RationalQuantizer {
+      public:
+        RationalQuantizer(const std::vector<bw_music::ModelDuration>& beats)
+            : m_beats(beats) {}
+
+        /// Given the time since the last event of the input, return the time since the last quantized event.
+        bw_music::ModelDuration advance(bw_music::ModelDuration timeSinceLastEvent) {
+            m_trackInAbsoluteTime += timeSinceLastEvent;
+            const bw_music::ModelDuration idealTime = getIdealTime(m_trackInAbsoluteTime, m_beats);
+            const bw_music::ModelDuration newTimeSinceLastEvent = idealTime - m_trackOutAbsoluteTime;
+            m_trackOutAbsoluteTime = idealTime;
+            return newTimeSinceLastEvent;
+        }
+
+        bw_music::ModelDuration getIdealDuration(bw_music::ModelDuration duration) const {
+            return getIdealTime(duration, m_beats);
+        }
+
+      private:
+        std::vector<bw_music::ModelDuration> m_beats;
+        bw_music::ModelDuration m_trackInAbsoluteTime;
+        bw_music::ModelDuration m_trackOutAbsoluteTime;
+    };
+
+    template <typename QUANTIZER> bw_music::Track quantizeWithBuilder(const bw_music::Track& trackIn, QUANTIZER quantizer) {
+        bw_music::TrackBuilder track;
+
+        for (auto it = trackIn.begin(); it != trackIn.end(); ++it) {
+            const bw_music::ModelDuration timeSinceLastEvent = it->getTimeSinceLastEvent();
+            if (timeSinceLastEvent > 0) {
+                bw_music::TrackEventHolder event = *it;
+                event->setTimeSinceLastEvent(quantizer.advance(timeSinceLastEvent));
+                track.addEvent(event.release());
+            } else {
+                track.addEvent(*it);
+            }
+        }
+        return track.finishAndGetTrack(quantizer.getIdealDuration(trackIn.getDuration()));
+    }
+
+    /// Quantizing in place is safe if no group collapses to zero length.
+    /// Events keep their order, so groups cannot otherwise start to overlap.
+    template <typename QUANTIZER> bool canQuantizeInPlace(const bw_music::Track& trackIn, QUANTIZER quantizer) {
+        // Count the distinct quantized times, which is enough to tell whether a group has zero length.
+        int currentInstant = 0;
+        std::map<bw_music::TrackEvent::GroupKey, int> groupStartInstants;
+        for (const auto& event : trackIn) {
+            const bw_music::ModelDuration timeSinceLastEvent = event.getTimeSinceLastEvent();
+            if ((timeSinceLastEvent > 0) && (quantizer.advance(timeSinceLastEvent) > 0)) {
+                ++currentInstant;
+            }
+            const bw_music::TrackEvent::GroupingInfo groupInfo = event.getGroupingInfo();
+            if (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::StartOfGroup) {
+                groupStartInstants.insert_or_assign(groupInfo.m_groupKey, currentInstant);
+            } else if (groupInfo.m_groupRole == bw_music::TrackEvent::GroupRole::EndOfGroup) {
+                const auto it = groupStartInstants.find(groupInfo.m_groupKey);
+                if (it != groupStartInstants.end()) {
+                    if (it->second == currentInstant) {
+                        return false;
+                    }
+                    groupStartInstants.erase(it);
+                }
+            }
+        }
+        return true;
+    }
+
+    babelwires::ResultT<std::vector<bw_music::ModelDuration>>
+    getPositiveBeats(std::span<const bw_music::ModelDuration> beats) {
+        std::vector<bw_music::ModelDuration> positiveBeats;
+        positiveBeats.reserve(beats.size());
+        for (const auto& beat : beats) {
+            if (beat < 0) {
+                return babelwires::Error() << "Cannot quantize to a negative beat";
+            }
+            // A zero beat is treated as an unused grid.
+            if (beat > 0) {
+                positiveBeats.emplace_back(beat);
+            }
+        }
+        if (positiveBeats.empty()) {
+            return babelwires::Error() << "Cannot quantize without a non-zero beat";
+        }
+        return positiveBeats;
+    }
 } // namespace
 
 babelwires::ResultT<bw_music::Track> bw_music::quantize(const Track& trackIn, ModelDuration beat) {
-    TrackBuilder track;
-
-    ModelDuration currentTimeSinceLastEvent;
+    return quantize(trackIn, std::span<const ModelDuration>(&beat, 1));
+}
 
-    // The absolute time of the current event in trackIn.
-    ModelDuration trackInAbsoluteTime;
-    ModelDuration trackOutAbsoluteTime;
+babelwires::ResultT<bw_music::Track> bw_music::quantize(const Track& trackIn, std::span<const ModelDuration> beats) {
+    ASSIGN_OR_ERROR(const auto positiveBeats, getPositiveBeats(beats));
+    if (const auto ticksPerUnit = getCommonTicksPerUnit(trackIn, positiveBeats)) {
+        return quantizeWithBuilder(trackIn, TickQuantizer(positiveBeats, *ticksPerUnit));
+    }
+    return quantizeWithBuilder(trackIn, RationalQuantizer(positiveBeats));
+}
 
-    for (auto it = trackIn.begin(); it != trackIn.end(); ++it) {
-        const ModelDuration timeSinceLastEvent = it->getTimeSinceLastEvent();
+babelwires::ResultT<bw_music::Track> bw_music::quantize(Track&& trackIn, ModelDuration beat) {
+    return quantize(std::move(trackIn), std::span<const ModelDuration>(&beat, 1));
+}
 
-        ModelDuration newTimeSinceLastEvent;
-        if (timeSinceLastEvent > 0) {
-            trackInAbsoluteTime += timeSinceLastEvent;
-            const ModelDuration idealTime = getIdealTime(trackInAbsoluteTime, beat);
-            const ModelDuration newTimeSinceLastEvent = idealTime - trackOutAbsoluteTime;
-            TrackEventHolder event = *it;
-            event->setTimeSinceLastEvent(newTimeSinceLastEvent);
-            track.addEvent(event.release());
-            trackOutAbsoluteTime += newTimeSinceLastEvent;
-        } else {
-            track.addEvent(*it);
+babelwires::ResultT<bw_music::Track> bw_music::quantize(Track&& trackIn, std::span<const ModelDuration> beats) {
+    ASSIGN_OR_ERROR(const auto positiveBeats, getPositiveBeats(beats));
+    // Only this function is allowed to modify the events of the track in place.
+    const auto quantizeInPlace = [&trackIn](auto quantizer) -> Track {
+        if (!canQuantizeInPlace(trackIn, quantizer)) {
+            return quantizeWithBuilder(trackIn, quantizer);
         }
+        trackIn.modifyEventsInPlace([&quantizer](TrackEvent& event) {
+            const ModelDuration timeSinceLastEvent = event.getTimeSinceLastEvent();
+            if (timeSinceLastEvent > 0) {
+                event.setTimeSinceLastEvent(quantizer.advance(timeSinceLastEvent));
+            }
+        });
+        trackIn.setDuration(quantizer.getIdealDuration(trackIn.getDuration()));
+        return std::move(trackIn);
+    };
+    if (const auto ticksPerUnit = getCommonTicksPerUnit(trackIn, positiveBeats)) {
+        return quantizeInPlace(TickQuantizer(positiveBeats, *ticksPerUnit));
     }
-    const ModelDuration idealDuration = getIdealTime(trackIn.getDuration(), beat);
-    return track.finishAndGetTrack(idealDuration);
+    return quantizeInPlace(RationalQuantizer(positiveBeats));
 }
@@ -13,7 +13,18 @@
 
 #include <BaseLib/Result/result.hpp>
 
+#include <span>
+
 namespace bw_music {
     /// Move the time at which events occur to the nearest beat.
     MUSICLIB_API babelwires::ResultT<Track> quantize(const Track& trackIn, ModelDuration beat);
+
+    /// Move the time at which events occur to the nearest point on any of the grids defined by the beats.
+    /// For example, beats of 1/8 and 1/12 snap events to straight and triplet eighths in a single pass.
+    /// When two grid points are equally near, the later one is chosen.
+    MUSICLIB_API babelwires::ResultT<Track> quantize(const Track& trackIn, std::span<const ModelDuration> beats);
+
+    /// As above, but when no group collapses to zero length, the events of trackIn are moved in place.
+    MUSICLIB_API babelwires::ResultT<Track> quantize(Track&& trackIn, ModelDuration beat);
+    MUSICLIB_API babelwires::ResultT<Track> quantize(Track&& trackIn, std::span<const ModelDuration> beats);
 }
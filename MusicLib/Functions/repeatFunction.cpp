@@ -7,7 +7,7 @@
  **/
 #include <MusicLib/Functions/repeatFunction.hpp>
 
-#include <MusicLib/Functions/appendTrackFunction.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
 
 #include <BaseLib/Result/error.hpp>
 
@@ -17,11 +17,18 @@ babelwires::ResultT<bw_music::Track> bw_music::repeatTrack(const Track& trackIn,
         return babelwires::Error() << "You cannot have repeat a negative number of times";
     }
 
-    Track trackOut;
+    if (count == 0) {
+        return Track();
+    }
 
-    for (int i = 0; i < count; ++i) {
-        appendTrack(trackOut, trackIn);
+    // The copies are conformant, so this is just a matter of copying events and adjusting the time of the first
+    // event of each copy.
+    TrackBuilder trackOut;
+    const ModelDuration gapAtEnd = trackIn.getDuration() - trackIn.getTotalEventDuration();
+    trackOut.addEventsOfTrack(trackIn, 0);
+    for (int i = 1; i < count; ++i) {
+        trackOut.addEventsOfTrack(trackIn, gapAtEnd);
     }
 
-    return trackOut;
+    return trackOut.finishAndGetTrack(trackIn.getDuration() * count);
 }
@@ -0,0 +1,85 @@
+/**
+ * A function which cuts a track into consecutive slices.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Functions/sliceFunction.hpp>
+
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+
+#include <map>
+#include <optional>
+
+babelwires::ResultT<std::vector<bw_music::Track>> bw_music::sliceTrack(const Track& trackIn,
+                                                                       std::span<const ModelDuration> boundaries) {
+    for (std::size_t i = 1; i < boundaries.size(); ++i) {
+        if (boundaries[i] < boundaries[i - 1]) {
+            return babelwires::Error() << "The boundaries of the slices must not decrease";
+        }
+    }
+
+    std::vector<Track> slices;
+    slices.reserve(boundaries.size() + 1);
+
+    // The start events of the groups which are open at the current time in trackIn.
+    std::map<TrackEvent::GroupKey, const TrackEvent*> activeGroups;
+
+    std::optional<TrackBuilder> sliceBuilder;
+    sliceBuilder.emplace();
+    ModelDuration sliceStart;
+    // The time of the most recent event in the current slice, relative to the start of the slice.
+    ModelDuration timeInSlice;
+    std::size_t nextBoundary = 0;
+
+    const auto startNextSlice = [&]() {
+        const ModelDuration sliceEnd = boundaries[nextBoundary];
+        slices.emplace_back(sliceBuilder->finishAndGetTrack(sliceEnd - sliceStart));
+        sliceBuilder.emplace();
+        sliceStart = sliceEnd;
+        timeInSlice = 0;
+        ++nextBoundary;
+        // Groups which continue across the boundary start again at the beginning of the new slice.
+        for (const auto& [groupKey, startEvent] : activeGroups) {
+            TrackEventHolder reopenedEvent = *startEvent;
+            reopenedEvent->setTimeSinceLastEvent(0);
+            sliceBuilder->addEvent(reopenedEvent.release());
+        }
+    };
+
+    ModelDuration absoluteTime;
+    for (const auto& event : trackIn) {
+        absoluteTime += event.getTimeSinceLastEvent();
+        // Events at a boundary belong to the earlier slice. Start events there are discarded by the builder as
+        // zero-length groups and reach the next slice as reopened groups.
+        while ((nextBoundary < boundaries.size()) && (absoluteTime > boundaries[nextBoundary])) {
+            startNextSlice();
+        }
+
+        const ModelDuration timeSinceLastEventInSlice = absoluteTime - sliceStart - timeInSlice;
+        if (timeSinceLastEventInSlice == event.getTimeSinceLastEvent()) {
+            sliceBuilder->addEvent(event);
+        } else {
+            TrackEventHolder newEvent = event;
+            newEvent->setTimeSinceLastEvent(timeSinceLastEventInSlice);
+            sliceBuilder->addEvent(newEvent.release());
+        }
+        timeInSlice += timeSinceLastEventInSlice;
+
+        const TrackEvent::GroupingInfo groupInfo = event.getGroupingInfo();
+        if (groupInfo.m_groupRole == TrackEvent::GroupRole::StartOfGroup) {
+            activeGroups.insert_or_assign(groupInfo.m_groupKey, &event);
+        } else if (groupInfo.m_groupRole == TrackEvent::GroupRole::EndOfGroup) {
+            activeGroups.erase(groupInfo.m_groupKey);
+        }
+    }
+
+    while (nextBoundary < boundaries.size()) {
+        startNextSlice();
+    }
+    const ModelDuration remainingDuration = trackIn.getDuration() - sliceStart;
+    slices.emplace_back(sliceBuilder->finishAndGetTrack((remainingDuration > 0) ? remainingDuration : ModelDuration(0)));
+
+    return slices;
+}
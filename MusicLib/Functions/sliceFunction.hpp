@@ -0,0 +1,27 @@
+/**
+ * A function which cuts a track into consecutive slices.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <BaseLib/Result/result.hpp>
+
+#include <span>
+#include <vector>
+
+namespace bw_music {
+    /// Cut the track at each of the boundaries, which must not decrease, returning one more track than there are
+    /// boundaries. Each slice has the duration of its window, and the final slice runs to the end of the track.
+    /// Unlike getTrackExcerpt, groups which cross a boundary are not dropped: they are ended at the end of one slice
+    /// and started again at the beginning of the next.
+    /// The track is traversed once, regardless of the number of slices.
+    MUSICLIB_API babelwires::ResultT<std::vector<Track>> sliceTrack(const Track& trackIn,
+                                                                    std::span<const ModelDuration> boundaries);
+} // namespace bw_music
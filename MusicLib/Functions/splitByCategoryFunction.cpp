@@ -0,0 +1,82 @@
+/**
+ * Function which splits a track based on the category of its events.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Functions/splitByCategoryFunction.hpp>
+
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace {
+    enum OutputIndex { Notes, Chords, Percussion, Other, NumOutputs };
+
+    /// Builds one of the output tracks.
+    struct Output {
+        bw_music::TrackBuilder m_builder;
+        /// The time in the source track of the last event added to this output.
+        bw_music::ModelDuration m_timeOfLastEvent;
+    };
+} // namespace
+
+bw_music::SplitByCategoryResult bw_music::splitByCategory(const Track& sourceTrack) {
+    const std::array<TrackEvent::GroupKey::Category, Other> categories = {
+        NoteEvent::getNoteEventCategory(), ChordEvent::getChordEventCategory(),
+        PercussionEvent::getPercussionEventCategory()};
+    const auto getOutputIndex = [&categories](const TrackEvent::GroupKey::Category& category) {
+        for (int i = 0; i < Other; ++i) {
+            if (categories[i] == category) {
+                return static_cast<OutputIndex>(i);
+            }
+        }
+        return Other;
+    };
+
+    // Use the summary to find out which outputs will receive any events.
+    // Ungrouped events are counted in the summary under their own category, so generic events mark the Other output
+    // as used, and a track which mixes them with a single category is split below.
+    std::array<bool, NumOutputs> outputIsUsed{};
+    for (const auto& [category, numGroups] : sourceTrack.getNumEventGroupsByCategory()) {
+        if (numGroups > 0) {
+            outputIsUsed[getOutputIndex(category)] = true;
+        }
+    }
+
+    std::array<Track, NumOutputs> tracksOut;
+    const int numOutputsUsed = std::count(outputIsUsed.begin(), outputIsUsed.end(), true);
+    if (numOutputsUsed <= 1) {
+        // All the events go to the same output, so the source track can be used as it is.
+        for (int i = 0; i < NumOutputs; ++i) {
+            tracksOut[i] = outputIsUsed[i] ? sourceTrack : Track(sourceTrack.getDuration());
+        }
+    } else {
+        std::array<Output, NumOutputs> outputs;
+        ModelDuration currentTime = 0;
+        for (const auto& event : sourceTrack) {
+            const ModelDuration timeOfPreviousEvent = currentTime;
+            currentTime += event.getTimeSinceLastEvent();
+            Output& output = outputs[getOutputIndex(event.getGroupingInfo().m_groupKey.m_category)];
+            if (output.m_timeOfLastEvent == timeOfPreviousEvent) {
+                output.m_builder.addEvent(event);
+            } else {
+                TrackEventHolder holder = event;
+                holder->setTimeSinceLastEvent(currentTime - output.m_timeOfLastEvent);
+                output.m_builder.addEvent(holder.release());
+            }
+            output.m_timeOfLastEvent = currentTime;
+        }
+        for (int i = 0; i < NumOutputs; ++i) {
+            tracksOut[i] = outputs[i].m_builder.finishAndGetTrack(sourceTrack.getDuration());
+        }
+    }
+
+    return SplitByCategoryResult{std::move(tracksOut[Notes]), std::move(tracksOut[Chords]),
+                                 std::move(tracksOut[Percussion]), std::move(tracksOut[Other])};
+}
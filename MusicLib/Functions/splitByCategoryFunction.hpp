@@ -0,0 +1,29 @@
+/**
+ * Function which splits a track based on the category of its events.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <MusicLib/Types/Track/track.hpp>
+
+namespace bw_music {
+    struct MUSICLIB_API SplitByCategoryResult {
+        /// Events in the note category.
+        Track m_notes;
+        /// Events in the chord category.
+        Track m_chords;
+        /// Events in the percussion category.
+        Track m_percussion;
+        /// Events in any other category.
+        Track m_other;
+    };
+
+    /// Split the events in the track by their category, in a single traversal of the track.
+    /// All the resulting tracks have the duration of the source track.
+    MUSICLIB_API SplitByCategoryResult splitByCategory(const Track& sourceTrack);
+} // namespace bw_music
@@ -7,33 +7,58 @@
  **/
 #include <MusicLib/Functions/transposeFunction.hpp>
 
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
 #include <MusicLib/Types/Track/TrackEvents/transposable.hpp>
 #include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Utilities/concurrentEventModifier.hpp>
+
+#include <algorithm>
 
 babelwires::ResultT<bw_music::Track> bw_music::transposeTrack(const Track& trackIn, int pitchOffset, TransposeOutOfRangePolicy outOfRangePolicy) {
     assert(pitchOffset >= -127 && "pitchOffset too low");
     assert(pitchOffset <= 127 && "pitchOffset too high");
 
-    TrackBuilder trackOut;
-    ModelDuration durationOfDroppedEvents = 0;
-    
-    for (auto it = trackIn.begin(); it != trackIn.end(); ++it) {
-        TrackEventHolder holder(*it);
-        if (auto* transposable = holder->tryInterface<Transposable>()) {
-            if (!transposable->transpose(pitchOffset, outOfRangePolicy)) {
-                durationOfDroppedEvents += holder->getTimeSinceLastEvent();
-                continue;
+    return modifyEventsConcurrently(
+        trackIn, [](const TrackEvent& event) { return event.tryInterface<Transposable>() != nullptr; },
+        [pitchOffset, outOfRangePolicy](TrackEvent& event) {
+            return event.tryInterface<Transposable>()->transpose(pitchOffset, outOfRangePolicy);
+        });
+}
+
+namespace {
+    /// Transposing is safe in place if no event would be dropped or wrapped to another octave, since then the
+    /// pitches of distinct groups stay distinct.
+    bool canTransposeInPlace(const bw_music::Track& trackIn, int pitchOffset) {
+        int lowestPitch = 127;
+        int highestPitch = 0;
+        for (const auto& event : trackIn) {
+            if (const auto* noteEvent = event.tryAs<bw_music::NoteEvent>()) {
+                lowestPitch = std::min(lowestPitch, static_cast<int>(noteEvent->getPitch()));
+                highestPitch = std::max(highestPitch, static_cast<int>(noteEvent->getPitch()));
+            } else if (event.tryInterface<bw_music::Transposable>() && !event.tryAs<bw_music::ChordOnEvent>()) {
+                // Chord roots are always transposed within an octave, but other events are not understood here.
+                return false;
             }
         }
+        return (lowestPitch > highestPitch) ||
+               ((lowestPitch + pitchOffset >= 0) && (highestPitch + pitchOffset <= 127));
+    }
+} // namespace
 
-        if (durationOfDroppedEvents > 0) {
-            holder->setTimeSinceLastEvent(holder->getTimeSinceLastEvent() + durationOfDroppedEvents);
-            durationOfDroppedEvents = 0;
-        }
+babelwires::ResultT<bw_music::Track> bw_music::transposeTrack(Track&& trackIn, int pitchOffset, TransposeOutOfRangePolicy outOfRangePolicy) {
+    assert(pitchOffset >= -127 && "pitchOffset too low");
+    assert(pitchOffset <= 127 && "pitchOffset too high");
 
-        trackOut.addEvent(holder.release());
+    if (!canTransposeInPlace(trackIn, pitchOffset)) {
+        return transposeTrack(static_cast<const Track&>(trackIn), pitchOffset, outOfRangePolicy);
     }
 
-    return trackOut.finishAndGetTrack(trackIn.getDuration());
+    trackIn.modifyEventsInPlace([pitchOffset, outOfRangePolicy](TrackEvent& event) {
+        if (auto* transposable = event.tryInterface<Transposable>()) {
+            [[maybe_unused]] const bool isValid = transposable->transpose(pitchOffset, outOfRangePolicy);
+            assert(isValid && "Transposition should not have failed");
+        }
+    });
+    return std::move(trackIn);
 }
-
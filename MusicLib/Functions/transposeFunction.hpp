@@ -20,4 +20,7 @@ namespace bw_music {
 
     /// Return a track with the same events as trackIn, except the pitches have been adjusted.
     MUSICLIB_API babelwires::ResultT<Track> transposeTrack(const Track& trackIn, int pitchOffset, TransposeOutOfRangePolicy outOfRangePolicy = TransposeOutOfRangePolicy::Discard);
+
+    /// As above, but when every pitch stays in range, the events of trackIn are transposed in place.
+    MUSICLIB_API babelwires::ResultT<Track> transposeTrack(Track&& trackIn, int pitchOffset, TransposeOutOfRangePolicy outOfRangePolicy = TransposeOutOfRangePolicy::Discard);
 } // namespace bw_music
@@ -0,0 +1,100 @@
+/**
+ * A function which removes the silence at the start or end of a track.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Functions/trimFunction.hpp>
+
+#include <MusicLib/Functions/excerptFunction.hpp>
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
+
+#include <optional>
+
+ENUM_DEFINE_ENUM_VALUE_SOURCE(bw_music::TrimModeEnum, TRIM_MODE);
+
+bw_music::TrimModeEnum::TrimModeEnum()
+    : babelwires::EnumType(getThisIdentifier(), getStaticValueSet(), 2) {}
+
+namespace {
+    using TrimmedInterval = bw_music::TrimmedInterval;
+
+    /// The interval from the start of the first sounding event to the end of the last, if there are any.
+    std::optional<TrimmedInterval> getSoundingInterval(const bw_music::Track& trackIn) {
+        std::optional<TrimmedInterval> soundingInterval;
+        const bw_music::NoteSpanIndex& noteSpanIndex = trackIn.getNoteSpanIndex();
+        if (const std::optional<bw_music::ModelDuration> startOfFirstNote = noteSpanIndex.getStartOfFirstNote()) {
+            soundingInterval = TrimmedInterval{*startOfFirstNote, *noteSpanIndex.getEndOfLastNote()};
+        }
+
+        const auto percussionCategory = bw_music::PercussionEvent::getPercussionEventCategory();
+        const auto chordCategory = bw_music::ChordEvent::getChordEventCategory();
+        const auto& numEventGroupsByCategory = trackIn.getNumEventGroupsByCategory();
+        if (!numEventGroupsByCategory.contains(percussionCategory) &&
+            !numEventGroupsByCategory.contains(chordCategory)) {
+            return soundingInterval;
+        }
+
+        // Percussion and chords are not indexed, so scan for them.
+        bw_music::ModelDuration trackTime = 0;
+        for (const auto& event : trackIn) {
+            trackTime += event.getTimeSinceLastEvent();
+            const bw_music::TrackEvent::GroupingInfo groupingInfo = event.getGroupingInfo();
+            if ((groupingInfo.m_groupKey.m_category != percussionCategory) &&
+                (groupingInfo.m_groupKey.m_category != chordCategory)) {
+                continue;
+            }
+            if (groupingInfo.m_groupRole == bw_music::TrackEvent::GroupRole::StartOfGroup) {
+                if (!soundingInterval) {
+                    soundingInterval = TrimmedInterval{trackTime, trackTime};
+                } else if (trackTime < soundingInterval->m_start) {
+                    soundingInterval->m_start = trackTime;
+                }
+            } else if ((groupingInfo.m_groupRole == bw_music::TrackEvent::GroupRole::EndOfGroup) && soundingInterval &&
+                       (soundingInterval->m_end < trackTime)) {
+                soundingInterval->m_end = trackTime;
+            }
+        }
+        return soundingInterval;
+    }
+} // namespace
+
+bw_music::TrimmedInterval bw_music::getTrimmedInterval(const Track& trackIn, TrimModeEnum::Value mode) {
+    TrimmedInterval interval{0, trackIn.getDuration()};
+    const std::optional<TrimmedInterval> soundingInterval = getSoundingInterval(trackIn);
+    if (!soundingInterval) {
+        // Without sounding events, there is nothing to trim to, so the track is left alone.
+        return interval;
+    }
+    if (mode != TrimModeEnum::Value::End) {
+        interval.m_start = soundingInterval->m_start;
+    }
+    if (mode != TrimModeEnum::Value::Start) {
+        interval.m_end = soundingInterval->m_end;
+    }
+    return interval;
+}
+
+bool bw_music::isTrimmed(const Track& trackIn, const TrimmedInterval& interval) {
+    return (interval.m_start == 0) && (interval.m_end == trackIn.getDuration());
+}
+
+bool bw_music::isTrimmed(const Track& trackIn, TrimModeEnum::Value mode) {
+    return isTrimmed(trackIn, getTrimmedInterval(trackIn, mode));
+}
+
+babelwires::ResultT<bw_music::Track> bw_music::trimTrack(const Track& trackIn, const TrimmedInterval& interval) {
+    if ((interval.m_start == 0) && (trackIn.getTotalEventDuration() <= interval.m_end)) {
+        // Only trailing silence is removed, so the events can be kept as they are.
+        Track trackOut = trackIn;
+        trackOut.setDuration(interval.m_end);
+        return trackOut;
+    }
+    return getTrackExcerpt(trackIn, interval.m_start, interval.m_end - interval.m_start);
+}
+
+babelwires::ResultT<bw_music::Track> bw_music::trimTrack(const Track& trackIn, TrimModeEnum::Value mode) {
+    return trimTrack(trackIn, getTrimmedInterval(trackIn, mode));
+}
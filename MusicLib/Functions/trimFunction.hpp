@@ -0,0 +1,59 @@
+/**
+ * A function which removes the silence at the start or end of a track.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <BabelWiresLib/TypeSystem/registeredType.hpp>
+
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <BaseLib/Result/result.hpp>
+
+namespace bw_music {
+#define TRIM_MODE(X)                                                                                                   \
+    X(Start, "Start", "fae2d200-10ee-4262-a84f-b8fa9aa4c1d7")                                                          \
+    X(End, "End", "4b72dd9a-5d51-4bfa-95d1-d40b9a89125d")                                                              \
+    X(Both, "Start and end", "6c251b1a-b1b1-428a-85e4-2e0b5d3b61ec")
+
+    /// The enum that determines which silence is trimmed from a track.
+    class MUSICLIB_API TrimModeEnum : public babelwires::EnumType {
+      public:
+        DOWNCASTABLE(TrimModeEnum, babelwires::EnumType);
+        REGISTERED_TYPE("TrimMode", "Trim Mode", "75542ab2-e7ae-4607-a454-434bf09e7d2c", 1);
+        TrimModeEnum();
+
+        ENUM_DEFINE_CPP_ENUM(TRIM_MODE);
+    };
+
+    /// The part of a track which trimming keeps.
+    struct TrimmedInterval {
+        ModelDuration m_start;
+        ModelDuration m_end;
+    };
+
+    /// The interval from the first sounding event and/or to the last sounding event of the track.
+    /// Notes, percussion and chords are sounding. For a track without sounding events, this is the whole track.
+    /// Notes are found using the note span index of the track. The events are only scanned when the track has
+    /// percussion or chords.
+    MUSICLIB_API TrimmedInterval getTrimmedInterval(const Track& trackIn, TrimModeEnum::Value mode);
+
+    /// Returns true if trimming the track to the interval would leave it unchanged.
+    MUSICLIB_API bool isTrimmed(const Track& trackIn, const TrimmedInterval& interval);
+
+    /// Returns true if trimming the track would leave it unchanged.
+    MUSICLIB_API bool isTrimmed(const Track& trackIn, TrimModeEnum::Value mode);
+
+    /// Remove the time outside the interval, which should be obtained from getTrimmedInterval.
+    /// Other events outside the interval are handled as they would be by getTrackExcerpt.
+    MUSICLIB_API babelwires::ResultT<Track> trimTrack(const Track& trackIn, const TrimmedInterval& interval);
+
+    /// Remove the time before the first sounding event and/or after the last sounding event of the track.
+    /// See getTrimmedInterval.
+    MUSICLIB_API babelwires::ResultT<Track> trimTrack(const Track& trackIn, TrimModeEnum::Value mode);
+} // namespace bw_music
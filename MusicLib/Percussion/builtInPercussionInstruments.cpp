@@ -7,6 +7,7 @@
  **/
 #include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
 
+#include <MusicLib/Percussion/percussionInstrumentIndex.hpp>
 #include <MusicLib/Percussion/percussionTypeTag.hpp>
 
 ENUM_DEFINE_ENUM_VALUE_SOURCE(bw_music::BuiltInPercussionInstruments, BUILT_IN_PERCUSSION_INSTRUMENTS);
@@ -14,5 +15,6 @@ ENUM_DEFINE_ENUM_VALUE_SOURCE(bw_music::BuiltInPercussionInstruments, BUILT_IN_P
 bw_music::BuiltInPercussionInstruments::BuiltInPercussionInstruments()
     : EnumType(getThisIdentifier(), getStaticValueSet(), 0) {
         addTag(percussionTypeTag());
+        PercussionInstrumentIndex::internInstruments(getValueSet());
     }
 
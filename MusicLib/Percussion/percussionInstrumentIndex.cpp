@@ -0,0 +1,63 @@
+/**
+ * The instruments of registered percussion sets are interned into a dense index.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Percussion/percussionInstrumentIndex.hpp>
+
+#include <cassert>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    struct InstrumentTable {
+        /// Interning only happens at registration time, but lookups can happen in processors running on other
+        /// threads.
+        std::shared_mutex m_mutex;
+        std::unordered_map<babelwires::ShortId, bw_music::PercussionInstrumentIndex::Index> m_instrumentToIndex;
+        std::vector<babelwires::ShortId> m_indexToInstrument;
+    };
+
+    InstrumentTable& getInstrumentTable() {
+        static InstrumentTable s_table;
+        return s_table;
+    }
+} // namespace
+
+void bw_music::PercussionInstrumentIndex::internInstruments(const babelwires::EnumType::ValueSet& instruments) {
+    InstrumentTable& table = getInstrumentTable();
+    std::unique_lock lock(table.m_mutex);
+    for (babelwires::ShortId instrument : instruments) {
+        const auto [it, wasInserted] =
+            table.m_instrumentToIndex.try_emplace(instrument, static_cast<Index>(table.m_indexToInstrument.size()));
+        if (wasInserted) {
+            assert((table.m_indexToInstrument.size() < c_notInterned) && "Too many percussion instruments");
+            table.m_indexToInstrument.emplace_back(instrument);
+        }
+    }
+}
+
+bw_music::PercussionInstrumentIndex::Index
+bw_music::PercussionInstrumentIndex::tryGetIndex(babelwires::ShortId instrument) {
+    InstrumentTable& table = getInstrumentTable();
+    std::shared_lock lock(table.m_mutex);
+    const auto it = table.m_instrumentToIndex.find(instrument);
+    return (it != table.m_instrumentToIndex.end()) ? it->second : c_notInterned;
+}
+
+babelwires::ShortId bw_music::PercussionInstrumentIndex::getInstrument(Index index) {
+    InstrumentTable& table = getInstrumentTable();
+    std::shared_lock lock(table.m_mutex);
+    assert((index < table.m_indexToInstrument.size()) && "Index out of range");
+    return table.m_indexToInstrument[index];
+}
+
+bw_music::PercussionInstrumentIndex::Index bw_music::PercussionInstrumentIndex::getNumInstruments() {
+    InstrumentTable& table = getInstrumentTable();
+    std::shared_lock lock(table.m_mutex);
+    return static_cast<Index>(table.m_indexToInstrument.size());
+}
@@ -0,0 +1,48 @@
+/**
+ * The instruments of registered percussion sets are interned into a dense index.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <BabelWiresLib/Types/Enum/enumType.hpp>
+
+#include <BaseLib/Identifiers/identifier.hpp>
+
+#include <cstdint>
+#include <limits>
+
+namespace bw_music {
+
+    /// Percussion types intern their instruments when they are constructed, so operations on instruments (e.g. applying
+    /// a percussion map) can use arrays instead of hashing identifiers. PercussionEvents can carry the index of their
+    /// instrument for this purpose.
+    /// Lookups take a lock, so callers should resolve each distinct instrument once rather than once per event.
+    /// Instruments can be shared by several percussion sets, but each instrument has only one index.
+    /// Indices are stable for the lifetime of the process but not between runs, so they must not be serialized.
+    class MUSICLIB_API PercussionInstrumentIndex {
+      public:
+        using Index = std::uint16_t;
+
+        /// The index of instruments which were not interned.
+        static constexpr Index c_notInterned = std::numeric_limits<Index>::max();
+
+        /// Give an index to each instrument which does not already have one.
+        /// This is expected to be called when percussion types are registered.
+        static void internInstruments(const babelwires::EnumType::ValueSet& instruments);
+
+        /// Get the index of an instrument, or c_notInterned.
+        static Index tryGetIndex(babelwires::ShortId instrument);
+
+        /// Get the instrument with the given index, which must be less than getNumInstruments().
+        static babelwires::ShortId getInstrument(Index index);
+
+        /// All indices of interned instruments are less than this.
+        static Index getNumInstruments();
+    };
+
+} // namespace bw_music
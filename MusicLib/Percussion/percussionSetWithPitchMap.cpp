@@ -7,6 +7,7 @@
  **/
 #include <MusicLib/Percussion/percussionSetWithPitchMap.hpp>
 
+#include <MusicLib/Percussion/percussionInstrumentIndex.hpp>
 #include <MusicLib/Percussion/percussionTypeTag.hpp>
 
 #include <unordered_set>
@@ -14,7 +15,7 @@
 class bw_music::PercussionSetWithPitchMap::ComplexConstructorArguments {
   public:
     babelwires::EnumType::ValueSet m_enumValues;
-    std::unordered_map<bw_music::Pitch, babelwires::ShortId> m_pitchToInstrument;
+    std::unordered_map<bw_music::Pitch, IndexedInstrument> m_pitchToInstrument;
     std::unordered_map<babelwires::ShortId, bw_music::Pitch> m_instrumentToPitch;
     int m_indexOfDefaultValue = -1;
 
@@ -47,7 +48,8 @@ class bw_music::PercussionSetWithPitchMap::ComplexConstructorArguments {
             }
             assert((m_pitchToInstrument.find(pitch) == m_pitchToInstrument.end()) &&
                    "Duplicate pitch probably because of overlapping blocks");
-            m_pitchToInstrument[pitch] = id;
+            // The index is resolved once the instruments have been interned.
+            m_pitchToInstrument[pitch] = {id, PercussionInstrumentIndex::c_notInterned};
             ++pitch;
         }
     }
@@ -66,6 +68,10 @@ bw_music::PercussionSetWithPitchMap::PercussionSetWithPitchMap(babelwires::TypeE
     , m_pitchToInstrument(std::move(removeDuplicates.m_pitchToInstrument))
     , m_instrumentToPitch(std::move(removeDuplicates.m_instrumentToPitch)) {
     addTag(percussionTypeTag());
+    PercussionInstrumentIndex::internInstruments(getValueSet());
+    for (auto& [pitch, indexedInstrument] : m_pitchToInstrument) {
+        indexedInstrument.m_instrumentIndex = PercussionInstrumentIndex::tryGetIndex(indexedInstrument.m_instrument);
+    }
 }
 
 bw_music::PercussionSetWithPitchMap::PercussionSetWithPitchMap(babelwires::TypeExp typeExp, InstrumentBlock instruments,
@@ -87,6 +93,15 @@ bw_music::PercussionSetWithPitchMap::tryGetPitchFromInstrument(babelwires::Short
 
 std::optional<babelwires::ShortId>
 bw_music::PercussionSetWithPitchMap::tryGetInstrumentFromPitch(bw_music::Pitch pitch) const {
+    const auto it = m_pitchToInstrument.find(pitch);
+    if (it != m_pitchToInstrument.end()) {
+        return it->second.m_instrument;
+    }
+    return {};
+}
+
+std::optional<bw_music::PercussionSetWithPitchMap::IndexedInstrument>
+bw_music::PercussionSetWithPitchMap::tryGetIndexedInstrumentFromPitch(bw_music::Pitch pitch) const {
     const auto it = m_pitchToInstrument.find(pitch);
     if (it != m_pitchToInstrument.end()) {
         return it->second;
@@ -11,6 +11,7 @@
 
 #include <MusicLib/musicTypes.hpp>
 #include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
+#include <MusicLib/Percussion/percussionInstrumentIndex.hpp>
 
 #include <variant>
 
@@ -48,6 +49,16 @@ namespace bw_music {
         /// Get the instrument corresponding to the pitch, if it is in this set.
         std::optional<babelwires::ShortId> tryGetInstrumentFromPitch(bw_music::Pitch pitch) const;
 
+        /// An instrument together with its PercussionInstrumentIndex.
+        struct IndexedInstrument {
+            babelwires::ShortId m_instrument;
+            PercussionInstrumentIndex::Index m_instrumentIndex;
+        };
+
+        /// Get the instrument corresponding to the pitch and its index, if it is in this set.
+        /// The indices are resolved when the set is constructed, so this costs no more than tryGetInstrumentFromPitch.
+        std::optional<IndexedInstrument> tryGetIndexedInstrumentFromPitch(bw_music::Pitch pitch) const;
+
       private:
         // Private class just used to pass complex calculated arguments to the base class constructor.
         class ComplexConstructorArguments;
@@ -55,7 +66,7 @@ namespace bw_music {
         PercussionSetWithPitchMap(babelwires::TypeExp typeExp, ComplexConstructorArguments&& removeDuplicates);
 
       private:
-        std::unordered_map<bw_music::Pitch, babelwires::ShortId> m_pitchToInstrument;
+        std::unordered_map<bw_music::Pitch, IndexedInstrument> m_pitchToInstrument;
         std::unordered_map<babelwires::ShortId, bw_music::Pitch> m_instrumentToPitch;
     };
 }
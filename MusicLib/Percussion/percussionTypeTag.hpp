@@ -15,6 +15,7 @@
 namespace bw_music {
 
     /// Percussion types should use this tag.
+    /// They should also intern their instruments with PercussionInstrumentIndex.
     MUSICLIB_API babelwires::Type::Tag percussionTypeTag();
 
 } // namespace bw_music
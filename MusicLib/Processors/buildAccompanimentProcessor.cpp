@@ -64,13 +64,13 @@ namespace {
                 // Skip if an error already occurred.
                 if (result.has_value()) {
                     auto& track = v.as<bw_music::Track>();
-                    auto fitResult = bw_music::fitToChordFunction(track, chord);
+                    auto fitResult = bw_music::fitToChordFunction(std::move(track), chord);
                     if (!fitResult) {
                         // TODO Add details about chord
                         result = fitResult.error();
                         return;
                     }
-                    track = *fitResult;
+                    track = std::move(*fitResult);
                 }
             });
 
@@ -16,6 +16,7 @@
 #include <BabelWiresLib/Types/Map/mapValue.hpp>
 
 #include <BaseLib/Identifiers/registeredIdentifier.hpp>
+#include <BaseLib/Result/error.hpp>
 #include <BaseLib/Result/resultDSL.hpp>
 
 bw_music::ChordMapProcessorInput::ChordMapProcessorInput(const babelwires::TypeSystem& typeSystem)
@@ -34,6 +35,11 @@ bw_music::ChordMapProcessor::ChordMapProcessor(const babelwires::Context& contex
     : babelwires::ParallelProcessor(context, ChordMapProcessorInput::getThisIdentifier(),
                                     ChordMapProcessorOutput::getThisIdentifier()) {}
 
+struct bw_music::ChordMapProcessor::CachedChordMap {
+    babelwires::ValueHolder m_chordMapValue;
+    CompiledChordMap m_compiledChordMap;
+};
+
 babelwires::ShortId bw_music::ChordMapProcessor::getCommonArrayId() {
     return BW_SHORT_ID("Tracks", "Tracks", "24e56b0d-eb1e-4c93-97fd-ba4d639e112a");
 }
@@ -42,13 +48,32 @@ babelwires::Result bw_music::ChordMapProcessor::processEntry(babelwires::UserLog
                                                const babelwires::ValueTreeNode& input,
                                                const babelwires::ValueTreeNode& inputEntry,
                                                babelwires::ValueTreeNode& outputEntry) const {
-    ChordMapProcessorInput::ConstInstance in{input};
     babelwires::ConstInstance<TrackType> entryIn{inputEntry};
     babelwires::Instance<TrackType> entryOut{outputEntry};
 
-    const auto& chordMap = in.getChrdMp()->getValue()->as<babelwires::MapValue>();
+    ASSIGN_OR_ERROR(const auto cachedChordMap, getCompiledChordMap(input));
 
-    ASSIGN_OR_ERROR(auto result, mapChordsFunction(in->getTypeSystem(), entryIn.get(), chordMap));
+    ASSIGN_OR_ERROR(auto result, mapChordsFunction(entryIn.get(), cachedChordMap->m_compiledChordMap));
     entryOut.set(std::move(result));
     return {};
 }
+
+babelwires::ResultT<std::shared_ptr<const bw_music::ChordMapProcessor::CachedChordMap>>
+bw_music::ChordMapProcessor::getCompiledChordMap(const babelwires::ValueTreeNode& input) const {
+    ChordMapProcessorInput::ConstInstance in{input};
+    const babelwires::ValueHolder& chordMapValueHolder = in.getChrdMp()->getValue();
+
+    // Holding the lock while compiling means entries processed concurrently wait for a single compilation.
+    std::lock_guard lock(m_mutex);
+    if (m_cachedChordMap && (*m_cachedChordMap->m_chordMapValue == *chordMapValueHolder)) {
+        return m_cachedChordMap;
+    }
+    const auto& chordMapValue = chordMapValueHolder->as<babelwires::MapValue>();
+    // TODO Could an invalid map ever reach here? Clarify this somewhere.
+    if (!chordMapValue.isValid(in->getTypeSystem())) {
+        return babelwires::Error() << "The Chord Type Map is not valid.";
+    }
+    m_cachedChordMap = std::make_shared<const CachedChordMap>(
+        CachedChordMap{chordMapValueHolder, CompiledChordMap(in->getTypeSystem(), chordMapValue)});
+    return m_cachedChordMap;
+}
@@ -16,7 +16,13 @@
 #include <BabelWiresLib/Types/Map/mapType.hpp>
 #include <BabelWiresLib/Processors/processorFactory.hpp>
 
+#include <BaseLib/Result/result.hpp>
+
+#include <memory>
+#include <mutex>
+
 namespace bw_music {
+    class CompiledChordMap;
 
     class MUSICLIB_API ChordMapProcessorInput : public babelwires::ParallelProcessorInputBase {
       public:
@@ -49,6 +55,19 @@ namespace bw_music {
 
         babelwires::Result processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
                           const babelwires::ValueTreeNode& inputEntry, babelwires::ValueTreeNode& outputEntry) const override;
+
+      private:
+        struct CachedChordMap;
+
+        /// Get the compiled map of the input, which all entries share.
+        /// The map is only compiled when its value differs from the one compiled last.
+        babelwires::ResultT<std::shared_ptr<const CachedChordMap>>
+        getCompiledChordMap(const babelwires::ValueTreeNode& input) const;
+
+      private:
+        /// Entries can be processed concurrently.
+        mutable std::mutex m_mutex;
+        mutable std::shared_ptr<const CachedChordMap> m_cachedChordMap;
     };
 
 } // namespace bw_music
@@ -32,15 +32,15 @@ babelwires::Result bw_music::ConcatenateProcessor::processValue(babelwires::User
                                                   babelwires::ValueTreeNode& output) const {
     ConcatenateProcessorInput::ConstInstance in{input};
     if (in->isChanged(babelwires::ValueTreeNode::Changes::SomethingChanged)) {
-        Track trackOut;
-
+        std::vector<const Track*> tracks;
+        tracks.reserve(in.getInput().getSize());
         for (int i = 0; i < in.getInput().getSize(); ++i) {
-            appendTrack(trackOut, in.getInput().getEntry(i).get());
+            tracks.emplace_back(&in.getInput().getEntry(i).get());
         }
 
         ConcatenateProcessorOutput::Instance out{output};
 
-        out.getOutput().set(std::move(trackOut));
+        out.getOutput().set(concatenateTracks(tracks));
     }
     return {};
 }
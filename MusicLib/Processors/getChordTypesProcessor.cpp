@@ -35,8 +35,9 @@ babelwires::Result bw_music::GetChordTypesProcessor::processValue(babelwires::Us
     if (in->isChanged(babelwires::ValueTreeNode::Changes::SomethingChanged)) {
         GetChordTypesProcessorOutput::Instance out{output};
         const ChordTypeSet& chordTypeSetType = out.getChords()->getType()->as<ChordTypeSet>();
-        ASSIGN_OR_ERROR(auto setOfChordTypes, bw_music::getChordTypesFunction(in.getTrack().get()));
-        out.getChords()->assertSetValue(chordTypeSetType.createValueFromChordTypes(in->getTypeSystem(), setOfChordTypes));
+        // The track keeps a summary of its chord types, so there is no need to scan its events.
+        const ChordTypeBitset& chordTypes = in.getTrack().get().getChordTypesUsed();
+        out.getChords()->assertSetValue(chordTypeSetType.createValueFromChordTypes(in->getTypeSystem(), chordTypes));
     }
     return {};
 }
\ No newline at end of file
@@ -16,8 +16,6 @@
 #include <BaseLib/Identifiers/registeredIdentifier.hpp>
 #include <BaseLib/Result/resultDSL.hpp>
 
-#include <set>
-
 bw_music::MergeProcessorInput::MergeProcessorInput(const babelwires::TypeSystem& typeSystem)
     : babelwires::RecordType(getThisIdentifier(), typeSystem,
           {{BW_SHORT_ID("Input", "Input tracks", "80b175ae-c954-4943-96d8-eaffcd7ed6e1"),
@@ -34,13 +32,38 @@ babelwires::Result bw_music::MergeProcessor::processValue(babelwires::UserLogger
                                             babelwires::ValueTreeNode& output) const {
     MergeProcessorInput::ConstInstance in{input};
     if (in->isChanged(babelwires::ValueTreeNode::Changes::SomethingChanged)) {
+        const unsigned int numInputs = in.getInput().getSize();
+        std::vector<babelwires::ValueHolder> inputs;
         std::vector<const Track*> tracksIn;
-        for (int i = 0; i < in.getInput().getSize(); ++i) {
-            tracksIn.emplace_back(&in.getInput().getEntry(i).get());
+        inputs.reserve(numInputs);
+        tracksIn.reserve(numInputs);
+        for (unsigned int i = 0; i < numInputs; ++i) {
+            inputs.emplace_back(in.getInput().getEntry(i)->getValue());
+            tracksIn.emplace_back(&inputs.back()->as<Track>());
+        }
+
+        std::lock_guard lock(m_mutex);
+        std::vector<const Track*> previousTracksIn;
+        if (m_previousOutput && (m_previousInputs.size() == numInputs)) {
+            previousTracksIn.reserve(numInputs);
+            for (const auto& previousInput : m_previousInputs) {
+                previousTracksIn.emplace_back(&previousInput->as<Track>());
+            }
+            if (previousTracksIn == tracksIn) {
+                // None of the entries changed.
+                return {};
+            }
         }
+        auto result = previousTracksIn.empty() ? mergeTracks(tracksIn)
+                                                : mergeTracks(tracksIn, previousTracksIn, (*m_previousOutput)->as<Track>());
+        m_previousInputs.clear();
+        m_previousOutput.reset();
+        ASSIGN_OR_ERROR(auto track, std::move(result));
+
+        m_previousInputs = std::move(inputs);
+        m_previousOutput = babelwires::ValueHolder::makeValue<Track>(std::move(track));
         MergeProcessorOutput::Instance out{output};
-        ASSIGN_OR_ERROR(auto track, mergeTracks(tracksIn));
-        out.getOutput().set(std::move(track));
+        out.getOutput().set(*m_previousOutput);
     }
     return {};
 }
@@ -18,6 +18,10 @@
 #include <BabelWiresLib/TypeSystem/registeredType.hpp>
 #include <BabelWiresLib/Types/Record/recordType.hpp>
 
+#include <mutex>
+#include <optional>
+#include <vector>
+
 namespace bw_music {
     class MUSICLIB_API MergeProcessorInput : public babelwires::RecordType {
       public:
@@ -52,6 +56,13 @@ namespace bw_music {
       protected:
         babelwires::Result processValue(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
                           babelwires::ValueTreeNode& output) const override;
+
+      private:
+        /// The inputs and output of the last merge are kept, so only the events from the first change in the inputs
+        /// onwards need to be merged again.
+        mutable std::mutex m_mutex;
+        mutable std::vector<babelwires::ValueHolder> m_previousInputs;
+        mutable std::optional<babelwires::ValueHolder> m_previousOutput;
     };
 
 } // namespace bw_music
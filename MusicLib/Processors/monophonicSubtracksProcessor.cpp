@@ -16,7 +16,7 @@
 
 bw_music::MonophonicSubtracksProcessorInput::MonophonicSubtracksProcessorInput(const babelwires::TypeSystem& typeSystem)
     : babelwires::RecordType(getThisIdentifier(), typeSystem, {{BW_SHORT_ID("NumTrk", "Num subtracks", "30bc74d2-b678-4986-8296-929db40fc8c2"),
-                               babelwires::IntTypeConstructor::makeTypeExp(1, 16, 1)},
+                               babelwires::IntTypeConstructor::makeTypeExp(1, 32, 1)},
                               {BW_SHORT_ID("Policy", "Policy", "c3192ee7-adec-4239-83a1-ef2d130ce421"),
                                MonophonicSubtracksPolicyEnum::getThisIdentifier()},
                               {BW_SHORT_ID("Input", "Input Track", "16e6745d-2456-489f-b73b-8704a442591b"),
@@ -25,7 +25,7 @@ bw_music::MonophonicSubtracksProcessorInput::MonophonicSubtracksProcessorInput(c
 bw_music::MonophonicSubtracksProcessorOutput::MonophonicSubtracksProcessorOutput(const babelwires::TypeSystem& typeSystem)
     : babelwires::RecordType(getThisIdentifier(), typeSystem,
           {{BW_SHORT_ID("Sbtrks", "Mono tracks", "27c5fbe2-1060-4dc4-b46a-735b48128e17"),
-            babelwires::ArrayTypeConstructor::makeTypeExp(DefaultTrackType::getThisIdentifier(), 0, 16)},
+            babelwires::ArrayTypeConstructor::makeTypeExp(DefaultTrackType::getThisIdentifier(), 0, 32)},
            {BW_SHORT_ID("Other", "Other", "bc3a5261-630c-43d7-bda5-f85dd6a1fe2b"), DefaultTrackType::getThisIdentifier()}}) {}
 
 bw_music::MonophonicSubtracksProcessor::MonophonicSubtracksProcessor(const babelwires::Context& context)
@@ -15,14 +15,17 @@
 #include <BaseLib/Identifiers/registeredIdentifier.hpp>
 #include <BaseLib/Result/resultDSL.hpp>
 
-#include <set>
+#include <array>
 
 bw_music::QuantizeProcessorInput::QuantizeProcessorInput(const babelwires::TypeSystem& typeSystem)
     : babelwires::ParallelProcessorInputBase(
           getThisIdentifier(), typeSystem,
           {{BW_SHORT_ID("Beat", "Beat", "1651ab49-3313-4cd3-b92d-16742b7f5921"),
             babelwires::RationalTypeConstructor::makeTypeExp(
-                0, std::numeric_limits<babelwires::Rational::ComponentType>::max(), babelwires::Rational(1, 16))}},
+                0, std::numeric_limits<babelwires::Rational::ComponentType>::max(), babelwires::Rational(1, 16))},
+           {BW_SHORT_ID("Beat2", "Second beat", "e607dfca-e42d-4165-9d61-7dcb85154e3c"),
+            babelwires::RationalTypeConstructor::makeTypeExp(
+                0, std::numeric_limits<babelwires::Rational::ComponentType>::max(), 0)}},
           QuantizeProcessor::getCommonArrayId(), bw_music::DefaultTrackType::getThisIdentifier()) {}
 
 bw_music::QuantizeProcessorOutput::QuantizeProcessorOutput(const babelwires::TypeSystem& typeSystem)
@@ -45,7 +48,9 @@ babelwires::Result bw_music::QuantizeProcessor::processEntry(babelwires::UserLog
     babelwires::ConstInstance<TrackType> entryIn{inputEntry};
     babelwires::Instance<TrackType> entryOut{outputEntry};
 
-    ASSIGN_OR_ERROR(auto track, quantize(entryIn.get(), in.getBeat().get()));
+    // A second beat of zero means it is not used.
+    const std::array<ModelDuration, 2> beats = {in.getBeat().get(), in.getBeat2().get()};
+    ASSIGN_OR_ERROR(auto track, quantize(entryIn.get(), beats));
     entryOut.set(std::move(track));
     return {};
 }
@@ -27,6 +27,7 @@ namespace bw_music {
 
         DECLARE_INSTANCE_BEGIN(QuantizeProcessorInput)
         DECLARE_INSTANCE_FIELD(Beat, babelwires::RationalType)
+        DECLARE_INSTANCE_FIELD(Beat2, babelwires::RationalType)
         // No need to mention the array here.
         DECLARE_INSTANCE_END()
     };
@@ -39,7 +40,7 @@ namespace bw_music {
         QuantizeProcessorOutput(const babelwires::TypeSystem& typeSystem);
     };
 
-    /// A processor which quantizes the events in a track a specified number of times.
+    /// A processor which quantizes the events in a track to the nearest point on one or two grids.
     class MUSICLIB_API QuantizeProcessor : public babelwires::ParallelProcessor {
       public:
         BW_PROCESSOR_WITH_DEFAULT_FACTORY("QuantizeTracks", "Quantize", "1ae89077-2cfb-4071-910c-2f5dcfc85b17");
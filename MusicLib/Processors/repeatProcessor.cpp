@@ -7,13 +7,14 @@
  **/
 #include <MusicLib/Processors/repeatProcessor.hpp>
 
-#include <MusicLib/Functions/appendTrackFunction.hpp>
+#include <MusicLib/Functions/repeatFunction.hpp>
 #include <MusicLib/Types/Track/trackInstance.hpp>
 
 #include <BabelWiresLib/Types/Int/intTypeConstructor.hpp>
 #include <BabelWiresLib/Types/Int/intValue.hpp>
 
 #include <BaseLib/Identifiers/registeredIdentifier.hpp>
+#include <BaseLib/Result/resultDSL.hpp>
 
 bw_music::RepeatProcessorInput::RepeatProcessorInput(const babelwires::TypeSystem& typeSystem)
     : babelwires::ParallelProcessorInputBase(
@@ -41,12 +42,8 @@ babelwires::Result bw_music::RepeatProcessor::processEntry(babelwires::UserLogge
     RepeatProcessorInput::ConstInstance in{input};
     babelwires::ConstInstance<TrackType> entryIn{inputEntry};
     babelwires::Instance<TrackType> entryOut{outputEntry};
-    Track trackOut;
 
-    const Track& trackIn = entryIn.get();
-    for (int i = 0; i < in.getCount().get(); ++i) {
-        appendTrack(trackOut, trackIn);
-    }
+    ASSIGN_OR_ERROR(auto trackOut, repeatTrack(entryIn.get(), in.getCount().get()));
     entryOut.set(std::move(trackOut));
     return {};
 }
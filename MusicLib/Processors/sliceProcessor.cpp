@@ -0,0 +1,60 @@
+/**
+ * A processor which cuts a track into consecutive slices.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Processors/sliceProcessor.hpp>
+
+#include <MusicLib/Functions/sliceFunction.hpp>
+
+#include <BaseLib/Context/context.hpp>
+#include <BabelWiresLib/TypeSystem/typeSystem.hpp>
+#include <BabelWiresLib/Types/Array/arrayTypeConstructor.hpp>
+#include <BabelWiresLib/Types/Rational/rationalValue.hpp>
+
+#include <BaseLib/Result/resultDSL.hpp>
+
+namespace {
+    constexpr unsigned int c_maxNumBoundaries = 256;
+} // namespace
+
+bw_music::SliceProcessorInput::SliceProcessorInput(const babelwires::TypeSystem& typeSystem)
+    : babelwires::RecordType(getThisIdentifier(), typeSystem,
+          {{BW_SHORT_ID("Bounds", "Boundaries", "aa495870-79a3-4ed5-adc2-261ee68c3dfd"),
+            babelwires::ArrayTypeConstructor::makeTypeExp(Duration::getThisIdentifier(), 0, c_maxNumBoundaries)},
+           {BW_SHORT_ID("Input", "Input Track", "a599a10b-b3dc-42b0-8785-2f18eb1a2af4"), DefaultTrackType::getThisIdentifier()}}) {}
+
+bw_music::SliceProcessorOutput::SliceProcessorOutput(const babelwires::TypeSystem& typeSystem)
+    : babelwires::RecordType(getThisIdentifier(), typeSystem,
+          {{BW_SHORT_ID("Slices", "Slices", "e60c9d95-257d-4521-92b0-d2d5c1147188"),
+            babelwires::ArrayTypeConstructor::makeTypeExp(DefaultTrackType::getThisIdentifier(), 1,
+                                                          c_maxNumBoundaries + 1)}}) {}
+
+bw_music::SliceProcessor::SliceProcessor(const babelwires::Context& context)
+    : Processor(context, context.get<babelwires::TypeSystem>().getRegisteredType<SliceProcessorInput>(),
+                context.get<babelwires::TypeSystem>().getRegisteredType<SliceProcessorOutput>()) {}
+
+babelwires::Result bw_music::SliceProcessor::processValue(babelwires::UserLogger& userLogger,
+                                                          const babelwires::ValueTreeNode& input,
+                                                          babelwires::ValueTreeNode& output) const {
+    SliceProcessorInput::ConstInstance in{input};
+    if (in->isChanged(babelwires::ValueTreeNode::Changes::SomethingChanged)) {
+        const auto boundsIn = in.getBounds();
+        std::vector<ModelDuration> boundaries;
+        boundaries.reserve(boundsIn.getSize());
+        for (unsigned int i = 0; i < boundsIn.getSize(); ++i) {
+            boundaries.emplace_back(boundsIn.getEntry(i).get());
+        }
+        ASSIGN_OR_ERROR(auto slices, sliceTrack(in.getInput().get(), boundaries));
+
+        SliceProcessorOutput::Instance out{output};
+        auto slicesOut = out.getSlices();
+        slicesOut.setSize(slices.size());
+        for (unsigned int i = 0; i < slices.size(); ++i) {
+            slicesOut.getEntry(i).set(std::move(slices[i]));
+        }
+    }
+    return {};
+}
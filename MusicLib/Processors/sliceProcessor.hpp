@@ -0,0 +1,60 @@
+/**
+ * A processor which cuts a track into consecutive slices.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <MusicLib/Types/Track/trackInstance.hpp>
+#include <MusicLib/Types/Track/trackType.hpp>
+#include <MusicLib/Types/duration.hpp>
+
+#include <BabelWiresLib/Instance/instance.hpp>
+#include <BabelWiresLib/Processors/processorFactory.hpp>
+#include <BabelWiresLib/Processors/processor.hpp>
+#include <BabelWiresLib/TypeSystem/registeredType.hpp>
+#include <BabelWiresLib/Types/Record/recordType.hpp>
+
+namespace bw_music {
+    class MUSICLIB_API SliceProcessorInput : public babelwires::RecordType {
+      public:
+        DOWNCASTABLE(SliceProcessorInput, babelwires::RecordType);
+        REGISTERED_TYPE("SliceIn", "Slice Input", "b7d17755-7463-4e06-8fbb-30b3320ae938", 1);
+
+        SliceProcessorInput(const babelwires::TypeSystem& typeSystem);
+
+        DECLARE_INSTANCE_BEGIN(SliceProcessorInput)
+        DECLARE_INSTANCE_ARRAY_FIELD(Bounds, bw_music::Duration)
+        DECLARE_INSTANCE_FIELD(Input, bw_music::TrackType)
+        DECLARE_INSTANCE_END()
+    };
+
+    class MUSICLIB_API SliceProcessorOutput : public babelwires::RecordType {
+      public:
+        DOWNCASTABLE(SliceProcessorOutput, babelwires::RecordType);
+        REGISTERED_TYPE("SliceOut", "Slice Output", "7149eee4-dc38-459d-aea2-cde448b2673d", 1);
+
+        SliceProcessorOutput(const babelwires::TypeSystem& typeSystem);
+
+        DECLARE_INSTANCE_BEGIN(SliceProcessorOutput)
+        DECLARE_INSTANCE_ARRAY_FIELD(Slices, bw_music::TrackType)
+        DECLARE_INSTANCE_END()
+    };
+
+    /// A processor which cuts a track at a sequence of boundaries, producing an array of tracks.
+    class MUSICLIB_API SliceProcessor : public babelwires::Processor {
+      public:
+        BW_PROCESSOR_WITH_DEFAULT_FACTORY("SliceProcessor", "Slice", "c49ff75e-fc47-409c-9975-31a03d03b34b");
+
+        SliceProcessor(const babelwires::Context& context);
+
+      protected:
+        babelwires::Result processValue(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
+                          babelwires::ValueTreeNode& output) const override;
+    };
+
+} // namespace bw_music
@@ -0,0 +1,50 @@
+/**
+ * A processor which splits a track based on the category of its events.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Processors/splitByCategoryProcessor.hpp>
+
+#include <MusicLib/Functions/splitByCategoryFunction.hpp>
+
+#include <BaseLib/Context/context.hpp>
+#include <BabelWiresLib/TypeSystem/typeSystem.hpp>
+
+#include <BaseLib/Identifiers/registeredIdentifier.hpp>
+#include <BaseLib/Result/resultDSL.hpp>
+
+bw_music::SplitByCategoryProcessorInput::SplitByCategoryProcessorInput(const babelwires::TypeSystem& typeSystem)
+    : babelwires::RecordType(getThisIdentifier(), typeSystem, {{BW_SHORT_ID("Input", "Input Track", "fd500a96-a354-4d30-9cfa-a13347298a99"),
+                               DefaultTrackType::getThisIdentifier()}}) {}
+
+bw_music::SplitByCategoryProcessorOutput::SplitByCategoryProcessorOutput(const babelwires::TypeSystem& typeSystem)
+    : babelwires::RecordType(getThisIdentifier(), typeSystem, {
+          {BW_SHORT_ID("Notes", "Notes", "9f0442f2-99e6-4784-b1cd-742274ad3688"),
+           DefaultTrackType::getThisIdentifier()},
+          {BW_SHORT_ID("Chords", "Chords", "6b76be98-8ef9-42d4-a126-0a238944e820"),
+           DefaultTrackType::getThisIdentifier()},
+          {BW_SHORT_ID("Percus", "Percussion", "c221681f-28ef-4072-baf1-2d09e41328da"),
+           DefaultTrackType::getThisIdentifier()},
+          {BW_SHORT_ID("Other", "Other", "455e3419-9c8f-4097-acb8-d85995055585"),
+           DefaultTrackType::getThisIdentifier()},
+      }) {}
+
+bw_music::SplitByCategoryProcessor::SplitByCategoryProcessor(const babelwires::Context& context)
+    : Processor(context, context.get<babelwires::TypeSystem>().getRegisteredType<SplitByCategoryProcessorInput>(),
+                     context.get<babelwires::TypeSystem>().getRegisteredType<SplitByCategoryProcessorOutput>()) {}
+
+babelwires::Result bw_music::SplitByCategoryProcessor::processValue(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input, babelwires::ValueTreeNode& output) const {
+    SplitByCategoryProcessorInput::ConstInstance in{input};
+    auto trackIn = in.getInput();
+    if (trackIn->isChanged(babelwires::ValueTreeNode::Changes::SomethingChanged)) {
+        auto newTracksOut = splitByCategory(trackIn.get());
+        SplitByCategoryProcessorOutput::Instance out{output};
+        out.getNotes().set(std::move(newTracksOut.m_notes));
+        out.getChords().set(std::move(newTracksOut.m_chords));
+        out.getPercus().set(std::move(newTracksOut.m_percussion));
+        out.getOther().set(std::move(newTracksOut.m_other));
+    }
+    return {};
+}
@@ -0,0 +1,60 @@
+/**
+ * A processor which splits a track based on the category of its events.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <MusicLib/Types/Track/trackInstance.hpp>
+#include <MusicLib/Types/Track/trackType.hpp>
+
+#include <BabelWiresLib/Instance/instance.hpp>
+#include <BabelWiresLib/Processors/processorFactory.hpp>
+#include <BabelWiresLib/Processors/processor.hpp>
+#include <BabelWiresLib/TypeSystem/registeredType.hpp>
+#include <BabelWiresLib/Types/Record/recordType.hpp>
+
+namespace bw_music {
+    class MUSICLIB_API SplitByCategoryProcessorInput : public babelwires::RecordType {
+      public:
+        DOWNCASTABLE(SplitByCategoryProcessorInput, babelwires::RecordType);
+        REGISTERED_TYPE("CategorySplitIn", "Split By Category Input", "cc4def84-8a91-4d37-b805-573ded80f299", 1);
+
+        SplitByCategoryProcessorInput(const babelwires::TypeSystem& typeSystem);
+
+        DECLARE_INSTANCE_BEGIN(SplitByCategoryProcessorInput)
+        DECLARE_INSTANCE_FIELD(Input, bw_music::TrackType)
+        DECLARE_INSTANCE_END()
+    };
+
+    class MUSICLIB_API SplitByCategoryProcessorOutput : public babelwires::RecordType {
+      public:
+        DOWNCASTABLE(SplitByCategoryProcessorOutput, babelwires::RecordType);
+        REGISTERED_TYPE("CategorySplitOut", "Split By Category Output", "5e4a6131-4399-4395-a9d1-cf5fcf755082", 1);
+
+        SplitByCategoryProcessorOutput(const babelwires::TypeSystem& typeSystem);
+
+        DECLARE_INSTANCE_BEGIN(SplitByCategoryProcessorOutput)
+        DECLARE_INSTANCE_FIELD(Notes, bw_music::TrackType)
+        DECLARE_INSTANCE_FIELD(Chords, bw_music::TrackType)
+        DECLARE_INSTANCE_FIELD(Percus, bw_music::TrackType)
+        DECLARE_INSTANCE_FIELD(Other, bw_music::TrackType)
+        DECLARE_INSTANCE_END()
+    };
+
+    class MUSICLIB_API SplitByCategoryProcessor : public babelwires::Processor {
+      public:
+        BW_PROCESSOR_WITH_DEFAULT_FACTORY("SplitByCategoryProcessor", "Split By Category", "8c12382e-65bf-4bd8-8588-cd2a8851ae53");
+
+        SplitByCategoryProcessor(const babelwires::Context& context);
+
+      protected:
+        babelwires::Result processValue(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
+                          babelwires::ValueTreeNode& output) const override;
+    };
+
+} // namespace bw_music
@@ -0,0 +1,50 @@
+/**
+ * A processor which removes the silence at the start or end of tracks.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Processors/trimProcessor.hpp>
+
+#include <MusicLib/Types/Track/trackInstance.hpp>
+
+#include <BaseLib/Identifiers/registeredIdentifier.hpp>
+#include <BaseLib/Result/resultDSL.hpp>
+
+bw_music::TrimProcessorInput::TrimProcessorInput(const babelwires::TypeSystem& typeSystem)
+    : babelwires::ParallelProcessorInputBase(getThisIdentifier(), typeSystem,
+          {{BW_SHORT_ID("Mode", "Trim", "d562fa68-6c42-4a72-934f-88377224c0a3"), TrimModeEnum::getThisIdentifier()}},
+          TrimProcessor::getCommonArrayId(), bw_music::DefaultTrackType::getThisIdentifier()) {}
+
+bw_music::TrimProcessorOutput::TrimProcessorOutput(const babelwires::TypeSystem& typeSystem)
+    : babelwires::ParallelProcessorOutputBase(getThisIdentifier(), typeSystem, TrimProcessor::getCommonArrayId(),
+                                              bw_music::DefaultTrackType::getThisIdentifier()) {}
+
+babelwires::ShortId bw_music::TrimProcessor::getCommonArrayId() {
+    return BW_SHORT_ID("Tracks", "Tracks", "8679b91b-a5df-4590-bf50-c7cdc8d15249");
+}
+
+bw_music::TrimProcessor::TrimProcessor(const babelwires::Context& context)
+    : babelwires::ParallelProcessor(context, TrimProcessorInput::getThisIdentifier(),
+                                    TrimProcessorOutput::getThisIdentifier()) {}
+
+babelwires::Result bw_music::TrimProcessor::processEntry(babelwires::UserLogger& userLogger,
+                                              const babelwires::ValueTreeNode& input,
+                                              const babelwires::ValueTreeNode& inputEntry,
+                                              babelwires::ValueTreeNode& outputEntry) const {
+    TrimProcessorInput::ConstInstance in{input};
+    babelwires::ConstInstance<TrackType> entryIn{inputEntry};
+    babelwires::Instance<TrackType> entryOut{outputEntry};
+
+    const Track& trackIn = entryIn.get();
+    const TrimmedInterval interval = getTrimmedInterval(trackIn, in.getMode().get());
+    if (isTrimmed(trackIn, interval)) {
+        // Share the input track rather than copying it.
+        entryOut.set(inputEntry.getValue());
+        return {};
+    }
+    ASSIGN_OR_ERROR(auto track, trimTrack(trackIn, interval));
+    entryOut.set(std::move(track));
+    return {};
+}
@@ -0,0 +1,55 @@
+/**
+ * A processor which removes the silence at the start or end of tracks.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <MusicLib/Functions/trimFunction.hpp>
+
+#include <BabelWiresLib/Instance/instance.hpp>
+#include <BabelWiresLib/Processors/parallelProcessor.hpp>
+#include <BabelWiresLib/Processors/processorFactory.hpp>
+
+namespace bw_music {
+
+    class MUSICLIB_API TrimProcessorInput : public babelwires::ParallelProcessorInputBase {
+      public:
+        DOWNCASTABLE(TrimProcessorInput, babelwires::ParallelProcessorInputBase);
+        REGISTERED_TYPE("TrimTrckIn", "Trim In", "c6183a14-9617-4c28-8567-f8d2e81ddbd4", 1);
+
+        TrimProcessorInput(const babelwires::TypeSystem& typeSystem);
+
+        DECLARE_INSTANCE_BEGIN(TrimProcessorInput)
+        DECLARE_INSTANCE_FIELD(Mode, TrimModeEnum)
+        // No need to mention the array here.
+        DECLARE_INSTANCE_END()
+    };
+
+    class MUSICLIB_API TrimProcessorOutput : public babelwires::ParallelProcessorOutputBase {
+      public:
+        DOWNCASTABLE(TrimProcessorOutput, babelwires::ParallelProcessorOutputBase);
+        REGISTERED_TYPE("TrimTrckOut", "Trim Out", "850a3832-e289-4205-b6e9-0f25d30b4b45", 1);
+
+        TrimProcessorOutput(const babelwires::TypeSystem& typeSystem);
+    };
+
+    /// A processor which removes the time before the first sounding event and/or after the last sounding event of
+    /// tracks. Notes, percussion and chords are sounding.
+    class MUSICLIB_API TrimProcessor : public babelwires::ParallelProcessor {
+      public:
+        BW_PROCESSOR_WITH_DEFAULT_FACTORY("TrackTrim", "Trim", "7b94abfc-4b3a-4bd3-9797-2fffb44a2281");
+
+        TrimProcessor(const babelwires::Context& context);
+
+        static babelwires::ShortId getCommonArrayId();
+
+        babelwires::Result processEntry(babelwires::UserLogger& userLogger, const babelwires::ValueTreeNode& input,
+                          const babelwires::ValueTreeNode& inputEntry, babelwires::ValueTreeNode& outputEntry) const override;
+    };
+
+} // namespace bw_music
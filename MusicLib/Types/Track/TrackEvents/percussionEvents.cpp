@@ -19,7 +19,7 @@ bw_music::TrackEvent::GroupKey::Category bw_music::PercussionEvent::getPercussio
 }
 
 void bw_music::PercussionOnEvent::createEndEvent(TrackEventHolder& dest, ModelDuration timeSinceLastEvent) const {
-    dest = PercussionOffEvent(timeSinceLastEvent, m_instrument, m_velocity);
+    dest = PercussionOffEvent(timeSinceLastEvent, m_instrument, m_velocity, m_instrumentIndex);
 }
 
 std::size_t bw_music::PercussionOnEvent::getHash() const {
@@ -9,6 +9,7 @@
 
 #include <MusicLib/musicLibExport.hpp>
 
+#include <MusicLib/Percussion/percussionInstrumentIndex.hpp>
 #include <MusicLib/Types/Track/TrackEvents/startEventInterface.hpp>
 #include <MusicLib/Types/Track/TrackEvents/trackEvent.hpp>
 
@@ -21,23 +22,38 @@ namespace bw_music {
 
         static GroupKey::Category getPercussionEventCategory();
 
-        void setInstrument(babelwires::ShortId instrument) { m_instrument = instrument; }
+        /// The instrumentIndex should be the PercussionInstrumentIndex of the instrument if the caller knows it.
+        void setInstrument(babelwires::ShortId instrument,
+                           PercussionInstrumentIndex::Index instrumentIndex = PercussionInstrumentIndex::c_notInterned) {
+            m_instrument = instrument;
+            m_instrumentIndex = instrumentIndex;
+        }
         babelwires::ShortId getInstrument() const { return m_instrument; }
 
+        /// The PercussionInstrumentIndex of the instrument, or c_notInterned if the event was created without it.
+        /// Events do not look the index up themselves, since that would take a lock. Producers which resolve their
+        /// instruments once (e.g. from a PercussionSetWithPitchMap) can supply it, so operations on the events can use
+        /// arrays instead of hashing the instrument.
+        /// The index is derived from the instrument, so it does not affect equality or hashing.
+        PercussionInstrumentIndex::Index getInstrumentIndex() const { return m_instrumentIndex; }
+
         void setVelocity(Velocity velocity) { m_velocity = velocity; }
         Velocity getVelocity() const { return m_velocity; }
 
       protected:
-        PercussionEvent(ModelDuration timeSinceLastEvent, babelwires::ShortId instrument, Velocity velocity)
+        PercussionEvent(ModelDuration timeSinceLastEvent, babelwires::ShortId instrument, Velocity velocity,
+                        PercussionInstrumentIndex::Index instrumentIndex)
             : TrackEvent(timeSinceLastEvent)
             , m_instrument(instrument)
-            , m_velocity(velocity) {}
+            , m_velocity(velocity)
+            , m_instrumentIndex(instrumentIndex) {}
 
         bool doIsEqualTo(const TrackEvent& other) const override;
 
       protected:
         babelwires::ShortId m_instrument;
         Velocity m_velocity;
+        PercussionInstrumentIndex::Index m_instrumentIndex;
     };
 
     /// The start of a percussion event.
@@ -45,8 +61,9 @@ namespace bw_music {
         DOWNCASTABLE(PercussionOnEvent, PercussionEvent);
         STREAM_EVENT(PercussionOnEvent);
         QUERYABLE_INTERFACE_PROVIDER(PercussionEvent, StartEventInterface);
-        PercussionOnEvent(ModelDuration timeSinceLastEvent, babelwires::ShortId instrument, Velocity velocity = 127)
-            : PercussionEvent(timeSinceLastEvent, instrument, velocity) {}
+        PercussionOnEvent(ModelDuration timeSinceLastEvent, babelwires::ShortId instrument, Velocity velocity = 127,
+                          PercussionInstrumentIndex::Index instrumentIndex = PercussionInstrumentIndex::c_notInterned)
+            : PercussionEvent(timeSinceLastEvent, instrument, velocity, instrumentIndex) {}
         void createEndEvent(TrackEventHolder& dest, ModelDuration timeSinceLastEvent) const override;
         virtual std::size_t getHash() const override;
         virtual GroupingInfo getGroupingInfo() const override;
@@ -56,8 +73,9 @@ namespace bw_music {
     struct MUSICLIB_API PercussionOffEvent : public PercussionEvent {
         DOWNCASTABLE(PercussionOffEvent, PercussionEvent);
         STREAM_EVENT(PercussionOffEvent);
-        PercussionOffEvent(ModelDuration timeSinceLastEvent, babelwires::ShortId instrument, Velocity velocity = 64)
-            : PercussionEvent(timeSinceLastEvent, instrument, velocity) {}
+        PercussionOffEvent(ModelDuration timeSinceLastEvent, babelwires::ShortId instrument, Velocity velocity = 64,
+                           PercussionInstrumentIndex::Index instrumentIndex = PercussionInstrumentIndex::c_notInterned)
+            : PercussionEvent(timeSinceLastEvent, instrument, velocity, instrumentIndex) {}
 
         virtual std::size_t getHash() const override;
         virtual GroupingInfo getGroupingInfo() const override;
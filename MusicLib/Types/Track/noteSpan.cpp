@@ -0,0 +1,70 @@
+/**
+ * A NoteSpan describes a note by its interval, rather than by its start and end events.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Types/Track/noteSpan.hpp>
+
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+#include <limits>
+#include <tuple>
+
+namespace {
+    /// The start or end of a span.
+    struct SpanBoundary {
+        bw_music::ModelDuration m_time;
+        bool m_isStart;
+        /// The index of the span in the sorted spans.
+        std::size_t m_spanIndex;
+
+        bool operator<(const SpanBoundary& other) const {
+            // At the same time, ends come before starts, which is how a TrackBuilder would order them.
+            return std::tie(m_time, m_isStart, m_spanIndex) < std::tie(other.m_time, other.m_isStart, other.m_spanIndex);
+        }
+    };
+} // namespace
+
+bw_music::Track bw_music::trackFromNoteSpans(std::span<const NoteSpan> noteSpans, ModelDuration duration) {
+    std::vector<NoteSpan> sortedSpans;
+    sortedSpans.reserve(noteSpans.size());
+    std::copy_if(noteSpans.begin(), noteSpans.end(), std::back_inserter(sortedSpans),
+                 [](const NoteSpan& span) { return span.m_duration > 0; });
+    std::stable_sort(sortedSpans.begin(), sortedSpans.end(),
+                     [](const NoteSpan& a, const NoteSpan& b) { return a.m_start < b.m_start; });
+
+    std::vector<SpanBoundary> boundaries;
+    boundaries.reserve(sortedSpans.size() * 2);
+    for (std::size_t i = 0; i < sortedSpans.size(); ++i) {
+        boundaries.emplace_back(SpanBoundary{sortedSpans[i].m_start, true, i});
+        boundaries.emplace_back(SpanBoundary{sortedSpans[i].m_start + sortedSpans[i].m_duration, false, i});
+    }
+    std::sort(boundaries.begin(), boundaries.end());
+
+    Track track;
+    ModelDuration timeOfLastEvent = 0;
+    // Ends come before starts at the same time, so spans which only touch are not treated as overlapping.
+    std::bitset<std::numeric_limits<Pitch>::max() + 1> isPitchActive;
+    for (const auto& boundary : boundaries) {
+        const NoteSpan& span = sortedSpans[boundary.m_spanIndex];
+        const ModelDuration timeSinceLastEvent = boundary.m_time - timeOfLastEvent;
+        if (boundary.m_isStart) {
+            assert(!isPitchActive[span.m_pitch] && "Spans of the same pitch must not overlap");
+            isPitchActive.set(span.m_pitch);
+            track.addEvent(NoteOnEvent{timeSinceLastEvent, span.m_pitch, span.m_velocity});
+        } else {
+            isPitchActive.reset(span.m_pitch);
+            track.addEvent(NoteOffEvent{timeSinceLastEvent, span.m_pitch,
+                                        std::min(span.m_velocity, NoteOffEvent::c_defaultVelocity)});
+        }
+        timeOfLastEvent = boundary.m_time;
+    }
+    track.setDuration(std::max(duration, timeOfLastEvent));
+    return track;
+}
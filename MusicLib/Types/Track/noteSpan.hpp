@@ -0,0 +1,41 @@
+/**
+ * A NoteSpan describes a note by its interval, rather than by its start and end events.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <MusicLib/musicTypes.hpp>
+
+#include <span>
+#include <vector>
+
+namespace bw_music {
+    class Track;
+
+    /// A note, described by its interval rather than by a NoteOnEvent and NoteOffEvent.
+    struct NoteSpan {
+        /// The time of the start of the note, measured from the start of the track.
+        ModelDuration m_start;
+        ModelDuration m_duration;
+        Pitch m_pitch;
+        /// The velocity of the NoteOnEvent.
+        Velocity m_velocity;
+
+        bool operator==(const NoteSpan& other) const = default;
+    };
+
+    /// The notes of a track, sorted by their start times.
+    using NoteSpans = std::vector<NoteSpan>;
+
+    /// Build a track with the given notes, which can be in any order.
+    /// Unlike a TrackBuilder, the events are not checked as they are added, so the spans must describe a conformant
+    /// track: Spans of the same pitch must not overlap. Spans which do not have a positive duration are ignored.
+    /// The NoteOffEvents get the velocity they would be given by NoteOnEvent::createEndEvent.
+    /// The track will have the given duration, unless that is shorter than the notes.
+    MUSICLIB_API Track trackFromNoteSpans(std::span<const NoteSpan> noteSpans, ModelDuration duration);
+} // namespace bw_music
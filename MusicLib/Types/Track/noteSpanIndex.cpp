@@ -0,0 +1,125 @@
+/**
+ * A NoteSpanIndex supports queries about which notes of a track sound in a range of time.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Types/Track/noteSpanIndex.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+bw_music::NoteSpanIndex::NoteSpanIndex(NoteSpans noteSpans)
+    : m_noteSpans(std::move(noteSpans)) {
+    assert(std::is_sorted(m_noteSpans.begin(), m_noteSpans.end(),
+                          [](const NoteSpan& a, const NoteSpan& b) { return a.m_start < b.m_start; }) &&
+           "The note spans must be sorted by start");
+    const std::uint32_t numSpans = static_cast<std::uint32_t>(m_noteSpans.size());
+    if (numSpans == 0) {
+        return;
+    }
+    m_latestEndTable.reserve(std::bit_width(numSpans));
+    auto& firstLevel = m_latestEndTable.emplace_back(numSpans);
+    for (std::uint32_t i = 0; i < numSpans; ++i) {
+        firstLevel[i] = i;
+    }
+    for (std::uint32_t width = 2; width <= numSpans; width *= 2) {
+        const std::vector<std::uint32_t>& previousLevel = m_latestEndTable.back();
+        std::vector<std::uint32_t> level(numSpans - width + 1);
+        for (std::uint32_t i = 0; i < level.size(); ++i) {
+            const std::uint32_t a = previousLevel[i];
+            const std::uint32_t b = previousLevel[i + width / 2];
+            level[i] = (getEnd(a) < getEnd(b)) ? b : a;
+        }
+        m_latestEndTable.emplace_back(std::move(level));
+    }
+}
+
+bw_music::ModelDuration bw_music::NoteSpanIndex::getEnd(std::uint32_t index) const {
+    const NoteSpan& span = m_noteSpans[index];
+    return span.m_start + span.m_duration;
+}
+
+std::uint32_t bw_music::NoteSpanIndex::getIndexOfLatestEnd(std::uint32_t begin, std::uint32_t end) const {
+    assert((begin < end) && "The range of spans must not be empty");
+    // Two overlapping ranges of the largest power-of-two width cover [begin, end).
+    const int level = std::bit_width(end - begin) - 1;
+    const std::uint32_t a = m_latestEndTable[level][begin];
+    const std::uint32_t b = m_latestEndTable[level][end - (std::uint32_t(1) << level)];
+    return (getEnd(a) < getEnd(b)) ? b : a;
+}
+
+void bw_music::NoteSpanIndex::addNotesEndingAfter(std::uint32_t numSpans, ModelDuration t,
+                                                  NoteSpans& notesOut) const {
+    // Each entry is a range of spans still to search or, if it is empty, the index of a span to add.
+    struct Range {
+        std::uint32_t m_begin;
+        std::uint32_t m_end;
+    };
+    if (numSpans == 0) {
+        return;
+    }
+    std::vector<Range> stack;
+    stack.emplace_back(Range{0, numSpans});
+    while (!stack.empty()) {
+        const Range range = stack.back();
+        stack.pop_back();
+        if (range.m_begin == range.m_end) {
+            notesOut.emplace_back(m_noteSpans[range.m_begin]);
+            continue;
+        }
+        const std::uint32_t latest = getIndexOfLatestEnd(range.m_begin, range.m_end);
+        if (getEnd(latest) <= t) {
+            // Every note in this range ends too early.
+            continue;
+        }
+        // Pushed in reverse, so the notes are added in order.
+        if (latest + 1 < range.m_end) {
+            stack.emplace_back(Range{latest + 1, range.m_end});
+        }
+        stack.emplace_back(Range{latest, latest});
+        if (range.m_begin < latest) {
+            stack.emplace_back(Range{range.m_begin, latest});
+        }
+    }
+}
+
+const bw_music::NoteSpans& bw_music::NoteSpanIndex::getNoteSpans() const {
+    return m_noteSpans;
+}
+
+bw_music::NoteSpans bw_music::NoteSpanIndex::getNotesActiveAt(ModelDuration t) const {
+    const auto firstStartAfterT =
+        std::upper_bound(m_noteSpans.begin(), m_noteSpans.end(), t,
+                         [](ModelDuration time, const NoteSpan& span) { return time < span.m_start; });
+    NoteSpans notesOut;
+    addNotesEndingAfter(static_cast<std::uint32_t>(firstStartAfterT - m_noteSpans.begin()), t, notesOut);
+    return notesOut;
+}
+
+bw_music::NoteSpans bw_music::NoteSpanIndex::getNotesOverlapping(ModelDuration t0, ModelDuration t1) const {
+    NoteSpans notesOut;
+    if (t0 < t1) {
+        const auto firstStartAtT1 =
+            std::lower_bound(m_noteSpans.begin(), m_noteSpans.end(), t1,
+                             [](const NoteSpan& span, ModelDuration time) { return span.m_start < time; });
+        addNotesEndingAfter(static_cast<std::uint32_t>(firstStartAtT1 - m_noteSpans.begin()), t0, notesOut);
+    }
+    return notesOut;
+}
+
+std::optional<bw_music::ModelDuration> bw_music::NoteSpanIndex::getStartOfFirstNote() const {
+    if (m_noteSpans.empty()) {
+        return {};
+    }
+    return m_noteSpans.front().m_start;
+}
+
+std::optional<bw_music::ModelDuration> bw_music::NoteSpanIndex::getEndOfLastNote() const {
+    if (m_noteSpans.empty()) {
+        return {};
+    }
+    return getEnd(getIndexOfLatestEnd(0, static_cast<std::uint32_t>(m_noteSpans.size())));
+}
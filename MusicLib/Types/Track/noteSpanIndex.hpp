@@ -0,0 +1,61 @@
+/**
+ * A NoteSpanIndex supports queries about which notes of a track sound in a range of time.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <MusicLib/Types/Track/noteSpan.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace bw_music {
+    /// Holds the note spans of a track, arranged so the notes sounding in a range of time can be found without
+    /// visiting every note.
+    /// The spans are sorted by start, so the notes which start early enough are a prefix of them, found by binary
+    /// search. A sparse table gives the span with the latest end in any range of spans in constant time. Splitting the
+    /// prefix at that span finds each note which ends late enough, in order, with at most two failed lookups per note
+    /// found. A query takes O(log n + k) time, where k is the number of notes found. The table takes O(n log n) space.
+    /// Obtain the index of a track using Track::getNoteSpanIndex.
+    class MUSICLIB_API NoteSpanIndex {
+      public:
+        /// The noteSpans must be sorted by start.
+        NoteSpanIndex(NoteSpans noteSpans);
+
+        /// All the notes, sorted by start.
+        const NoteSpans& getNoteSpans() const;
+
+        /// The notes which sound at time t, i.e. which start at or before t and end after it, sorted by start.
+        NoteSpans getNotesActiveAt(ModelDuration t) const;
+
+        /// The notes which sound at some time in the interval [t0, t1), sorted by start.
+        NoteSpans getNotesOverlapping(ModelDuration t0, ModelDuration t1) const;
+
+        /// The time at which the first note starts, if there are any notes.
+        std::optional<ModelDuration> getStartOfFirstNote() const;
+
+        /// The time at which the last note to finish ends, if there are any notes.
+        std::optional<ModelDuration> getEndOfLastNote() const;
+
+      private:
+        ModelDuration getEnd(std::uint32_t index) const;
+
+        /// The index of a span with the latest end among the spans in [begin, end), which must not be empty.
+        std::uint32_t getIndexOfLatestEnd(std::uint32_t begin, std::uint32_t end) const;
+
+        /// Add the notes among the first numSpans spans which end after t, in order.
+        void addNotesEndingAfter(std::uint32_t numSpans, ModelDuration t, NoteSpans& notesOut) const;
+
+      private:
+        NoteSpans m_noteSpans;
+
+        /// Entry i of level k is the index of a span with the latest end among the 2^k spans from i.
+        std::vector<std::vector<std::uint32_t>> m_latestEndTable;
+    };
+} // namespace bw_music
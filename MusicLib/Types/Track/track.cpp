@@ -7,35 +7,81 @@
  **/
 #include <MusicLib/Types/Track/track.hpp>
 
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+
 #include <BaseLib/Hash/hash.hpp>
 
+#include <array>
+#include <limits>
+
 bw_music::Track::Track() = default;
 
 bw_music::Track::Track(ModelDuration duration) {
     setDuration(duration);
 }
 
+struct bw_music::Track::DeferredContents {
+    std::once_flag m_onceFlag;
+    std::function<Track()> m_loader;
+    Track m_track;
+};
+
+bw_music::Track bw_music::Track::createDeferred(std::function<Track()> loader) {
+    Track track;
+    track.m_deferredContents = std::make_shared<DeferredContents>();
+    track.m_deferredContents->m_loader = std::move(loader);
+    return track;
+}
+
+bool bw_music::Track::isDeferred() const {
+    return m_deferredContents != nullptr;
+}
+
+const bw_music::Track& bw_music::Track::getContents() const {
+    if (!m_deferredContents) {
+        return *this;
+    }
+    DeferredContents& deferredContents = *m_deferredContents;
+    std::call_once(deferredContents.m_onceFlag, [&deferredContents]() {
+        deferredContents.m_track = deferredContents.m_loader();
+        assert(!deferredContents.m_track.isDeferred() && "The loader of a deferred track returned a deferred track");
+        // Release anything the loader holds, such as the data it was loaded from.
+        deferredContents.m_loader = nullptr;
+    });
+    return deferredContents.m_track;
+}
+
+void bw_music::Track::loadDeferredContents() {
+    if (m_deferredContents) {
+        Track contents = getContents();
+        *this = std::move(contents);
+    }
+}
+
 int bw_music::Track::getNumEvents() const {
-    return m_blockStream.getNumEvents();
+    return getContents().m_blockStream.getNumEvents();
 }
 
 bw_music::ModelDuration bw_music::Track::getDuration() const {
-    return m_duration;
+    return getContents().m_duration;
 }
 
 bw_music::ModelDuration bw_music::Track::getTotalEventDuration() const {
-    return m_totalEventDuration;
+    return getContents().m_totalEventDuration;
 }
 
 void bw_music::Track::setDuration(ModelDuration d) {
     assert((d >= getTotalEventDuration()) && "Attempt to set a duration shorter than the event duration");
+    loadDeferredContents();
     m_duration = d;
 }
 
 std::size_t bw_music::Track::getHash() const {
+    const Track& contents = getContents();
     // The duration can be changed without invalidating cached info. But hash will change.
-    std::size_t hash = m_eventHash;
-    babelwires::hash::mixInto(hash, m_duration);
+    std::size_t hash = contents.m_eventHash;
+    babelwires::hash::mixInto(hash, contents.m_duration);
     return hash;
 }
 
@@ -44,10 +90,14 @@ bool bw_music::Track::operator==(const Value& other) const {
     if (!otherTrack) {
         return false;
     }
+    if (m_deferredContents && (otherTrack->m_deferredContents == m_deferredContents)) {
+        // Copies of the same deferred track are equal without being built.
+        return true;
+    }
     if (otherTrack->getNumEvents() != getNumEvents()) {
         return false;
     }
-    if (otherTrack->m_duration != m_duration) {
+    if (otherTrack->getDuration() != getDuration()) {
         return false;
     }
     if (otherTrack->getHash() != getHash()) {
@@ -68,41 +118,121 @@ bool bw_music::Track::operator==(const Value& other) const {
 }
 
 void bw_music::Track::addEvent(const TrackEvent& event) {
+    loadDeferredContents();
     onNewEvent(m_blockStream.addEvent(event));
 }
 
 void bw_music::Track::addEvent(TrackEvent&& event) {
+    loadDeferredContents();
     onNewEvent(m_blockStream.addEvent(std::move(event)));
 };
 
 void bw_music::Track::onNewEvent(const TrackEvent& event) {
     m_totalEventDuration += event.getTimeSinceLastEvent();
+    const int denominator = event.getTimeSinceLastEvent().getDenominator();
+    if (m_minimumDenominator % denominator != 0) {
+        m_minimumDenominator = babelwires::lcm(m_minimumDenominator, denominator);
+    }
+    // Only a track being built or modified gets new events, so no other thread can be reading the note spans.
+    m_noteSpansCache.m_noteSpanIndex.reset();
     babelwires::hash::mixInto(m_eventHash, event.getHash());
     TrackEvent::GroupingInfo groupingInfo = event.getGroupingInfo();
     if ((groupingInfo.m_groupRole == TrackEvent::GroupRole::NotInGroup) ||
         (groupingInfo.m_groupRole == TrackEvent::GroupRole::StartOfGroup)) {
         assert(groupingInfo.m_groupKey.m_category.getDiscriminator() != 0 && "Unresolved category identifier");
         ++m_numEventGroupsByCategory[groupingInfo.m_groupKey.m_category];
+        if ((groupingInfo.m_groupRole == TrackEvent::GroupRole::StartOfGroup) &&
+            (groupingInfo.m_groupKey.m_category == ChordEvent::getChordEventCategory())) {
+            const Chord& chord = event.as<ChordOnEvent>().m_chord;
+            if (chord.m_chordType < ChordType::Value::NUM_VALUES) {
+                m_chordTypesUsed.set(static_cast<std::size_t>(chord.m_chordType));
+            }
+            if (chord.m_root < PitchClass::Value::NUM_VALUES) {
+                m_chordRootsUsed.set(static_cast<std::size_t>(chord.m_root));
+            }
+        }
     }
 }
 
+void bw_music::Track::clearCachedInfo() {
+    m_totalEventDuration = 0;
+    m_eventHash = 0;
+    m_numEventGroupsByCategory.clear();
+    m_chordTypesUsed.reset();
+    m_chordRootsUsed.reset();
+    m_minimumDenominator = 1;
+    m_noteSpansCache.m_noteSpanIndex.reset();
+}
+
 bw_music::Track::const_iterator bw_music::Track::end() const {
-    return m_blockStream.end_impl<TrackEvent>();
+    return getContents().m_blockStream.end_impl<TrackEvent>();
 }
 
 bw_music::Track::const_iterator bw_music::Track::begin() const {
-    return m_blockStream.begin_impl<TrackEvent>();
+    return getContents().m_blockStream.begin_impl<TrackEvent>();
 }
 
 std::reverse_iterator<bw_music::Track::const_iterator> bw_music::Track::rbegin() const {
-    return m_blockStream.rbegin_impl<TrackEvent>();
+    return getContents().m_blockStream.rbegin_impl<TrackEvent>();
 }
 
 std::reverse_iterator<bw_music::Track::const_iterator> bw_music::Track::rend() const {
-    return m_blockStream.rend_impl<TrackEvent>();
+    return getContents().m_blockStream.rend_impl<TrackEvent>();
 }
 
 
 const std::unordered_map<bw_music::TrackEvent::GroupKey::Category, int>& bw_music::Track::getNumEventGroupsByCategory() const {
-    return m_numEventGroupsByCategory;
+    return getContents().m_numEventGroupsByCategory;
+}
+
+const bw_music::ChordTypeBitset& bw_music::Track::getChordTypesUsed() const {
+    return getContents().m_chordTypesUsed;
+}
+
+const bw_music::PitchClassBitset& bw_music::Track::getChordRootsUsed() const {
+    return getContents().m_chordRootsUsed;
+}
+
+int bw_music::Track::getMinimumDenominator() const {
+    return getContents().m_minimumDenominator;
+}
+
+const bw_music::NoteSpans& bw_music::Track::getNoteSpans() const {
+    return getNoteSpanIndex().getNoteSpans();
+}
+
+const bw_music::NoteSpanIndex& bw_music::Track::getNoteSpanIndex() const {
+    if (m_deferredContents) {
+        return getContents().getNoteSpanIndex();
+    }
+    std::lock_guard lock(m_noteSpansCache.m_mutex);
+    if (!m_noteSpansCache.m_noteSpanIndex) {
+        const TrackEvent::GroupKey::Category noteCategory = NoteEvent::getNoteEventCategory();
+        constexpr std::size_t c_noActiveSpan = std::numeric_limits<std::size_t>::max();
+        std::array<std::size_t, std::numeric_limits<Pitch>::max() + 1> activeSpanFromPitch;
+        activeSpanFromPitch.fill(c_noActiveSpan);
+
+        NoteSpans noteSpans;
+        ModelDuration currentTime = 0;
+        for (const auto& event : *this) {
+            currentTime += event.getTimeSinceLastEvent();
+            const TrackEvent::GroupingInfo groupInfo = event.getGroupingInfo();
+            if (groupInfo.m_groupKey.m_category != noteCategory) {
+                continue;
+            }
+            const NoteEvent& noteEvent = event.as<NoteEvent>();
+            if (groupInfo.m_groupRole == TrackEvent::GroupRole::StartOfGroup) {
+                activeSpanFromPitch[noteEvent.getPitch()] = noteSpans.size();
+                noteSpans.emplace_back(NoteSpan{currentTime, 0, noteEvent.getPitch(), noteEvent.getVelocity()});
+            } else if (groupInfo.m_groupRole == TrackEvent::GroupRole::EndOfGroup) {
+                std::size_t& spanIndex = activeSpanFromPitch[noteEvent.getPitch()];
+                assert((spanIndex != c_noActiveSpan) && "Note end without a start in a conformant track");
+                NoteSpan& span = noteSpans[spanIndex];
+                span.m_duration = currentTime - span.m_start;
+                spanIndex = c_noActiveSpan;
+            }
+        }
+        m_noteSpansCache.m_noteSpanIndex = std::make_shared<NoteSpanIndex>(std::move(noteSpans));
+    }
+    return *m_noteSpansCache.m_noteSpanIndex;
 }
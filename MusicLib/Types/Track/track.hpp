@@ -10,19 +10,31 @@
 #include <MusicLib/musicLibExport.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/trackEvent.hpp>
+#include <MusicLib/Types/Track/noteSpanIndex.hpp>
+#include <MusicLib/chord.hpp>
 #include <MusicLib/musicTypes.hpp>
 
 #include <BabelWiresLib/TypeSystem/value.hpp>
 
+#include <BaseLib/Result/result.hpp>
 #include <BaseLib/common.hpp>
 
 #include <cassert>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
+namespace babelwires {
+    class MapValue;
+    class TypeSystem;
+} // namespace babelwires
+
 namespace bw_music {
     class TrackBuilder;
     class UnsafeTrack;
+    enum class TransposeOutOfRangePolicy;
 
     /// A track carries a stream of TrackEvents.
     /// Construct a track using a TrackBuilder.
@@ -39,6 +51,21 @@ namespace bw_music {
         /// Create an empty track with a given duration.
         Track(ModelDuration duration);
 
+        Track(const Track& other) = default;
+        Track& operator=(const Track& other) = default;
+        /// Moves are noexcept, so containers of tracks move rather than copy them when they grow.
+        Track(Track&& other) noexcept = default;
+        Track& operator=(Track&& other) noexcept = default;
+
+        /// Create a track whose contents are built by the loader when they are first needed.
+        /// This lets a file format avoid building tracks which are never used. The loader is called at most once,
+        /// even when copies of the track are read from several threads, and the copies share the track it returns.
+        /// Modifying a deferred track builds its contents first.
+        static Track createDeferred(std::function<Track()> loader);
+
+        /// True if the contents of the track have not been built yet.
+        bool isDeferred() const;
+
       public:
         /// Get the total number of events in the track.
         int getNumEvents() const;
@@ -63,9 +90,52 @@ namespace bw_music {
         /// Get a summary of the track contents, by category.
         const std::unordered_map<TrackEvent::GroupKey::Category, int>& getNumEventGroupsByCategory() const;
 
+        /// Get the set of chord types used by the chords in the track.
+        const ChordTypeBitset& getChordTypesUsed() const;
+
+        /// Get the set of pitch classes used as roots by the chords in the track.
+        const PitchClassBitset& getChordRootsUsed() const;
+
+        /// Get the minimum denominator sufficient to represent the durations of all events in the track.
+        int getMinimumDenominator() const;
+
+        /// Get the notes of the track as intervals, sorted by their start times.
+        /// These are computed when first requested, and are shared by copies of the track.
+        /// The reference is valid until the track is modified or destroyed.
+        const NoteSpans& getNoteSpans() const;
+
+        /// Get an index of the note spans which supports time range queries.
+        /// Like the note spans, this is computed when first requested and shared by copies of the track.
+        const NoteSpanIndex& getNoteSpanIndex() const;
+
       private:
         friend TrackBuilder;
         friend UnsafeTrack;
+        friend Track trackFromNoteSpans(std::span<const NoteSpan> noteSpans, ModelDuration duration);
+        // These functions can modify the events of a track they own in place.
+        friend babelwires::ResultT<Track> transposeTrack(Track&& trackIn, int pitchOffset,
+                                                         TransposeOutOfRangePolicy outOfRangePolicy);
+        friend babelwires::ResultT<Track> quantize(Track&& trackIn, std::span<const ModelDuration> beats);
+        friend babelwires::ResultT<Track> fitToChordFunction(Track&& sourceTrack, const Chord& chord);
+        friend babelwires::ResultT<Track> mapPercussionFunction(const babelwires::TypeSystem& typeSystem,
+                                                                Track&& sourceTrack,
+                                                                const babelwires::MapValue& percussionMapValue);
+
+        /// Apply the modifier to each event in place, and recompute the cached info.
+        /// This avoids building a new track when a function changes the data of events but not their number or
+        /// types. The caller is responsible for ensuring the events still meet the rules enforced by TrackBuilder.
+        /// The duration is not changed, so the caller must call setDuration if the times of events change.
+        template <typename MODIFIER> void modifyEventsInPlace(MODIFIER&& modifier) {
+            loadDeferredContents();
+            clearCachedInfo();
+            for (auto it = m_blockStream.begin_impl<TrackEvent>(); it != m_blockStream.end_impl<TrackEvent>(); ++it) {
+                modifier(*it);
+                onNewEvent(*it);
+            }
+        }
+
+        /// Clear the info which onNewEvent accumulates.
+        void clearCachedInfo();
 
         /// Add a TrackEvent by copying it into the track.
         void addEvent(const TrackEvent& event);
@@ -85,6 +155,16 @@ namespace bw_music {
         /// Update the cached info.
         void onNewEvent(const TrackEvent& event);
 
+      private:
+        struct DeferredContents;
+
+        /// The track whose members describe the contents of this one: the loaded track if this track is deferred,
+        /// and otherwise this track.
+        const Track& getContents() const;
+
+        /// If this track is deferred, replace it by a copy of its loaded contents, so they can be modified.
+        void loadDeferredContents();
+
       protected:
         /// The track's events are stored in a BlockStream.
         babelwires::BlockStream m_blockStream;
@@ -101,6 +181,48 @@ namespace bw_music {
 
         /// A summary of information about the track.
         std::unordered_map<TrackEvent::GroupKey::Category, int> m_numEventGroupsByCategory;
+
+        /// The chord types used by chord events in the track.
+        ChordTypeBitset m_chordTypesUsed;
+
+        /// The roots used by chord events in the track.
+        PitchClassBitset m_chordRootsUsed;
+
+        /// The lcm of the denominators of the times of the events.
+        int m_minimumDenominator = 1;
+
+      private:
+        /// Holds the index of note spans once it has been computed.
+        /// Tracks are values which can be read from several threads, so access is guarded by a mutex.
+        struct NoteSpansCache {
+            NoteSpansCache() = default;
+            NoteSpansCache(const NoteSpansCache& other) {
+                std::lock_guard lock(other.m_mutex);
+                m_noteSpanIndex = other.m_noteSpanIndex;
+            }
+            NoteSpansCache& operator=(const NoteSpansCache& other) {
+                if (this != &other) {
+                    std::scoped_lock lock(m_mutex, other.m_mutex);
+                    m_noteSpanIndex = other.m_noteSpanIndex;
+                }
+                return *this;
+            }
+            /// A track being moved from cannot be read by anyone else, so the cache is transferred without locking.
+            NoteSpansCache(NoteSpansCache&& other) noexcept
+                : m_noteSpanIndex(std::move(other.m_noteSpanIndex)) {}
+            NoteSpansCache& operator=(NoteSpansCache&& other) noexcept {
+                m_noteSpanIndex = std::move(other.m_noteSpanIndex);
+                return *this;
+            }
+
+            mutable std::mutex m_mutex;
+            std::shared_ptr<const NoteSpanIndex> m_noteSpanIndex;
+        };
+
+        mutable NoteSpansCache m_noteSpansCache;
+
+        /// Non-null if the contents of this track are built on demand. See createDeferred.
+        std::shared_ptr<DeferredContents> m_deferredContents;
     };
 
     /// This is only intended for testing tracks.
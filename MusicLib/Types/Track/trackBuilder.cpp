@@ -14,6 +14,9 @@ bw_music::TrackBuilder::TrackBuilder() {}
 bw_music::TrackBuilder::TrackBuilder(Track startState)
     : m_track(std::move(startState)) {}
 
+bw_music::TrackBuilder::TrackBuilder(std::set<TrackEvent::GroupKey> activeGroupsAtStart)
+    : m_activeGroups(std::move(activeGroupsAtStart)) {}
+
 bool bw_music::TrackBuilder::onNewEvent(const TrackEvent& event) {
     const TrackEvent::GroupingInfo groupInfo = event.getGroupingInfo();
     if (groupInfo.m_groupRole == TrackEvent::GroupRole::NotInGroup) {
@@ -73,6 +76,53 @@ void bw_music::TrackBuilder::addEvent(TrackEvent&& event) {
     }
 }
 
+void bw_music::TrackBuilder::addEventsOfTrack(const Track& track, ModelDuration timeBeforeTrack) {
+    assert(!m_isFinished && "The TrackBuilder is already finished");
+    auto it = track.begin();
+    if (it == track.end()) {
+        return;
+    }
+    TrackEventHolder firstEvent = *it;
+    firstEvent->setTimeSinceLastEvent(firstEvent->getTimeSinceLastEvent() + timeBeforeTrack);
+    ++it;
+    if (m_activeGroups.empty() && m_eventsAtCurrentTime.empty()) {
+        // A finished track closes all its groups, so the builder has no open groups afterwards either.
+        issueEvent(firstEvent.release());
+        for (; it != track.end(); ++it) {
+            m_track.addEvent(*it);
+        }
+    } else {
+        // The events of the track could interact with the groups in progress, so they must be checked.
+        addEvent(firstEvent.release());
+        for (; it != track.end(); ++it) {
+            addEvent(*it);
+        }
+    }
+}
+
+bw_music::ModelDuration bw_music::TrackBuilder::addEventsOfTrackBefore(const Track& track, ModelDuration endTime) {
+    assert(!m_isFinished && "The TrackBuilder is already finished");
+    assert((m_track.getNumEvents() == 0) && m_activeGroups.empty() && m_eventsAtCurrentTime.empty() &&
+           "The TrackBuilder must be empty");
+    ModelDuration timeOfLastEvent = 0;
+    ModelDuration time = 0;
+    for (const TrackEvent& event : track) {
+        time += event.getTimeSinceLastEvent();
+        if (time >= endTime) {
+            break;
+        }
+        const TrackEvent::GroupingInfo groupInfo = event.getGroupingInfo();
+        if (groupInfo.m_groupRole == TrackEvent::GroupRole::StartOfGroup) {
+            m_activeGroups.emplace(groupInfo.m_groupKey);
+        } else if (groupInfo.m_groupRole == TrackEvent::GroupRole::EndOfGroup) {
+            m_activeGroups.erase(groupInfo.m_groupKey);
+        }
+        m_track.addEvent(event);
+        timeOfLastEvent = time;
+    }
+    return timeOfLastEvent;
+}
+
 void bw_music::TrackBuilder::issueEvent(const TrackEvent& event) {
     if (m_timeSinceLastEvent > 0) {
         TrackEventHolder tmp = event;
@@ -207,3 +257,30 @@ bw_music::Track bw_music::TrackBuilder::finishAndGetTrack(ModelDuration d) {
 bw_music::Track bw_music::TrackBuilder::finishAndGetTrack() {
     return finishAndGetTrack(m_track.getTotalEventDuration());    
 }
+
+bw_music::TrackBuilder::Segment bw_music::TrackBuilder::finishAndGetSegment(bool atEndOfTrack) {
+    processEventsAtCurrentTime(atEndOfTrack);
+    m_isFinished = true;
+    return Segment{std::move(m_track), std::move(m_activeGroups), m_timeSinceLastEvent};
+}
+
+void bw_music::TrackBuilder::addSegment(const Segment& segment) {
+    assert(!m_isFinished && "The TrackBuilder is already finished");
+    assert(m_eventsAtCurrentTime.empty() && "Cannot add a segment while events are pending");
+    auto it = segment.m_events.begin();
+    if (it != segment.m_events.end()) {
+        // Carry the time of any events this builder dropped.
+        issueEvent(*it);
+        for (++it; it != segment.m_events.end(); ++it) {
+            m_track.addEvent(*it);
+        }
+        m_timeSinceLastEvent = segment.m_timeAfterLastEvent;
+    } else {
+        m_timeSinceLastEvent += segment.m_timeAfterLastEvent;
+    }
+    m_activeGroups = segment.m_activeGroupsAtEnd;
+}
+
+const std::set<bw_music::TrackEvent::GroupKey>& bw_music::TrackBuilder::getActiveGroups() const {
+    return m_activeGroups;
+}
@@ -25,16 +25,52 @@ namespace bw_music {
         /// Add more events to the startTrack.
         TrackBuilder(Track startState);
 
+        /// Build a segment of a track, which starts while the given groups are active.
+        /// See finishAndGetSegment.
+        TrackBuilder(std::set<TrackEvent::GroupKey> activeGroupsAtStart);
+
         /// Add a TrackEvent by moving or copying it into the track.
         void addEvent(const TrackEvent& event);
         void addEvent(TrackEvent&& event);
 
+        /// Add copies of all the events of track, with the first event delayed by timeBeforeTrack.
+        /// Since a track is conformant, its events are copied without checking them when there are no open groups
+        /// or pending events in the builder. Otherwise, each event is added as if by addEvent.
+        void addEventsOfTrack(const Track& track, ModelDuration timeBeforeTrack);
+
+        /// Add copies of the events of track which occur before endTime, without checking them, leaving the groups they
+        /// start active. This allows a track to be rebuilt from the point at which its contents start to differ.
+        /// The builder must be empty. Returns the time of the last event added.
+        ModelDuration addEventsOfTrackBefore(const Track& track, ModelDuration endTime);
+
         /// Set the full duration of the track to d and obtain the track built by this builder.
         Track finishAndGetTrack(ModelDuration d);
 
         /// Set the duration of the track to be the duration of its events and obtain the track built by this builder.
         Track finishAndGetTrack();
 
+        /// The events of part of a track, built separately so parts of a track can be built concurrently.
+        struct Segment {
+            /// Groups can be open at either end, so these events do not form a conformant track by themselves.
+            Track m_events;
+            /// The groups active after the last event.
+            std::set<TrackEvent::GroupKey> m_activeGroupsAtEnd;
+            /// Time carried by events which were dropped after the last event.
+            ModelDuration m_timeAfterLastEvent;
+        };
+
+        /// Obtain the events built by this builder, leaving groups open.
+        /// Unless atEndOfTrack, events at the end of the segment are handled as if later events follow them.
+        Segment finishAndGetSegment(bool atEndOfTrack);
+
+        /// Add the events of a segment without checking them.
+        /// The segment must have been built starting with the groups which are active in this builder, and this
+        /// builder must have no events pending at the current time.
+        void addSegment(const Segment& segment);
+
+        /// The groups which are currently active.
+        const std::set<TrackEvent::GroupKey>& getActiveGroups() const;
+
       private:
         bool onNewEvent(const TrackEvent& event);
 
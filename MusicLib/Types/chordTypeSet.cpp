@@ -45,3 +45,21 @@ bw_music::ChordTypeSet::createValueFromChordTypes(const babelwires::TypeSystem&
     }
     return valueHolder;
 }
+
+babelwires::ValueHolder
+bw_music::ChordTypeSet::createValueFromChordTypes(const babelwires::TypeSystem& typeSystem, const ChordTypeBitset& chordTypes) const {
+    babelwires::ValueHolder valueHolder = createValue(typeSystem);
+    assertSetSize(typeSystem, valueHolder, static_cast<unsigned int>(chordTypes.count()));
+    const auto& chordTypeType = typeSystem.getRegisteredType<ChordType>();
+    unsigned int i = 0;
+    for (std::size_t chordTypeIndex = 0; chordTypeIndex < chordTypes.size(); ++chordTypeIndex) {
+        if (chordTypes.test(chordTypeIndex)) {
+            const auto [childValueHolder, childStep, childType] = getChildNonConst(valueHolder, i);
+            const babelwires::ShortId chordId =
+                chordTypeType->getIdentifierFromValue(static_cast<ChordType::Value>(chordTypeIndex));
+            *childValueHolder = babelwires::EnumValue(chordId);
+            ++i;
+        }
+    }
+    return valueHolder;
+}
@@ -34,6 +34,9 @@ namespace bw_music {
 
         /// Create a value holding the given set of chord types.
         babelwires::ValueHolder createValueFromChordTypes(const babelwires::TypeSystem& typeSystem, const std::set<ChordType::Value>& chordTypes) const;
+
+        /// Create a value holding the chord types in the given bitset.
+        babelwires::ValueHolder createValueFromChordTypes(const babelwires::TypeSystem& typeSystem, const ChordTypeBitset& chordTypes) const;
     };
 
 } // namespace bw_music
@@ -0,0 +1,187 @@
+/**
+ * Build a track from modified copies of the events of another track, using several threads.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Utilities/concurrentEventModifier.hpp>
+
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Utilities/runConcurrently.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+    using GroupKey = bw_music::TrackEvent::GroupKey;
+
+    /// Below this, the cost of starting threads and joining segments is not worthwhile.
+    constexpr int c_minEventsPerSegment = 1 << 14;
+
+    /// Choose where segments start, returning them followed by the end of the track.
+    /// A segment only starts at an event which comes strictly after the previous event, so events at the same time
+    /// are never split between segments.
+    std::vector<bw_music::Track::const_iterator> getSegmentBoundaries(const bw_music::Track& track,
+                                                                      unsigned int numSegments) {
+        std::vector<bw_music::Track::const_iterator> boundaries;
+        boundaries.reserve(numSegments + 1);
+        const int eventsPerSegment = track.getNumEvents() / numSegments;
+        int eventIndex = 0;
+        int nextBoundaryIndex = 0;
+        for (auto it = track.begin(); it != track.end(); ++it, ++eventIndex) {
+            if ((eventIndex >= nextBoundaryIndex) && ((eventIndex == 0) || (it->getTimeSinceLastEvent() > 0))) {
+                boundaries.emplace_back(it);
+                nextBoundaryIndex = eventIndex + eventsPerSegment;
+            }
+        }
+        boundaries.emplace_back(track.end());
+        return boundaries;
+    }
+
+    /// How a segment of a conformant track changes the set of active groups.
+    struct GroupChanges {
+        /// The groups started in the segment and still active at its end.
+        std::map<GroupKey, const bw_music::TrackEvent*> m_startedGroups;
+        /// The groups ended in the segment which were started before it.
+        std::vector<GroupKey> m_endedGroups;
+    };
+
+    GroupChanges getGroupChanges(bw_music::Track::const_iterator begin, bw_music::Track::const_iterator end) {
+        GroupChanges changes;
+        for (auto it = begin; it != end; ++it) {
+            const bw_music::TrackEvent::GroupingInfo info = it->getGroupingInfo();
+            if (info.m_groupRole == bw_music::TrackEvent::GroupRole::StartOfGroup) {
+                changes.m_startedGroups.insert_or_assign(info.m_groupKey, &*it);
+            } else if (info.m_groupRole == bw_music::TrackEvent::GroupRole::EndOfGroup) {
+                if (changes.m_startedGroups.erase(info.m_groupKey) == 0) {
+                    changes.m_endedGroups.emplace_back(info.m_groupKey);
+                }
+            }
+        }
+        return changes;
+    }
+
+    /// The groups which will be active after modifying the given start events, assuming the modifier does not make
+    /// any of them collide with other groups.
+    std::set<GroupKey> getModifiedGroups(const std::map<GroupKey, const bw_music::TrackEvent*>& startEvents,
+                                         const bw_music::EventSelector& selector,
+                                         const bw_music::EventModifier& modifier) {
+        std::set<GroupKey> groups;
+        for (const auto& [key, startEvent] : startEvents) {
+            if (!selector(*startEvent)) {
+                groups.insert(key);
+                continue;
+            }
+            bw_music::TrackEventHolder holder(*startEvent);
+            if (modifier(*holder)) {
+                const bw_music::TrackEvent::GroupingInfo info = holder->getGroupingInfo();
+                assert((info.m_groupRole == bw_music::TrackEvent::GroupRole::StartOfGroup) &&
+                       "The modifier changed the role of an event");
+                groups.insert(info.m_groupKey);
+            }
+        }
+        return groups;
+    }
+
+    /// Add the events to the builder, modifying copies of the selected ones, and return the time of dropped events
+    /// after the last event added.
+    bw_music::ModelDuration addModifiedEvents(bw_music::TrackBuilder& builder, bw_music::Track::const_iterator begin,
+                                              bw_music::Track::const_iterator end,
+                                              const bw_music::EventSelector& selector,
+                                              const bw_music::EventModifier& modifier) {
+        bw_music::ModelDuration durationOfDroppedEvents = 0;
+        for (auto it = begin; it != end; ++it) {
+            const bool isSelected = selector(*it);
+            if (!isSelected && (durationOfDroppedEvents == 0)) {
+                // The builder copies the event straight into the track.
+                builder.addEvent(*it);
+                continue;
+            }
+            bw_music::TrackEventHolder holder(*it);
+            if (isSelected && !modifier(*holder)) {
+                durationOfDroppedEvents += holder->getTimeSinceLastEvent();
+                continue;
+            }
+            if (durationOfDroppedEvents > 0) {
+                holder->setTimeSinceLastEvent(holder->getTimeSinceLastEvent() + durationOfDroppedEvents);
+                durationOfDroppedEvents = 0;
+            }
+            builder.addEvent(holder.release());
+        }
+        return durationOfDroppedEvents;
+    }
+
+    bw_music::TrackBuilder::Segment buildSegment(const bw_music::Track& trackIn, bw_music::Track::const_iterator begin,
+                                                 bw_music::Track::const_iterator end, bool isLastSegment,
+                                                 std::set<GroupKey> activeGroupsAtStart,
+                                                 const bw_music::EventSelector& selector,
+                                                 const bw_music::EventModifier& modifier) {
+        bw_music::TrackBuilder builder(std::move(activeGroupsAtStart));
+        const bw_music::ModelDuration durationOfDroppedEvents =
+            addModifiedEvents(builder, begin, end, selector, modifier);
+        // Pending events are only at the end of the track if nothing follows them, not even dropped events.
+        const bool atEndOfTrack = isLastSegment && (durationOfDroppedEvents == 0) &&
+                                  (trackIn.getTotalEventDuration() == trackIn.getDuration());
+        bw_music::TrackBuilder::Segment segment = builder.finishAndGetSegment(atEndOfTrack);
+        segment.m_timeAfterLastEvent += durationOfDroppedEvents;
+        return segment;
+    }
+} // namespace
+
+bw_music::Track bw_music::modifyEventsConcurrently(const Track& trackIn, const EventSelector& selector,
+                                                   const EventModifier& modifier, unsigned int numSegments) {
+    if (numSegments == 0) {
+        numSegments = std::clamp<unsigned int>(trackIn.getNumEvents() / c_minEventsPerSegment, 1,
+                                               std::max(std::thread::hardware_concurrency(), 1u));
+    }
+    numSegments = std::min<unsigned int>(numSegments, std::max(trackIn.getNumEvents(), 1));
+
+    if (numSegments == 1) {
+        TrackBuilder trackOut;
+        addModifiedEvents(trackOut, trackIn.begin(), trackIn.end(), selector, modifier);
+        return trackOut.finishAndGetTrack(trackIn.getDuration());
+    }
+
+    const std::vector<Track::const_iterator> boundaries = getSegmentBoundaries(trackIn, numSegments);
+    // There can be fewer segments than requested if many events are simultaneous.
+    numSegments = boundaries.size() - 1;
+
+    std::vector<GroupChanges> groupChanges(numSegments);
+    runConcurrently(numSegments,
+                    [&](std::size_t i) { groupChanges[i] = getGroupChanges(boundaries[i], boundaries[i + 1]); });
+
+    // The groups of trackIn which are active at the start of each segment.
+    std::vector<std::map<GroupKey, const TrackEvent*>> activeGroupsAtStart(numSegments);
+    for (unsigned int i = 1; i < numSegments; ++i) {
+        activeGroupsAtStart[i] = activeGroupsAtStart[i - 1];
+        for (const auto& key : groupChanges[i - 1].m_endedGroups) {
+            activeGroupsAtStart[i].erase(key);
+        }
+        for (const auto& [key, startEvent] : groupChanges[i - 1].m_startedGroups) {
+            activeGroupsAtStart[i].insert_or_assign(key, startEvent);
+        }
+    }
+
+    std::vector<std::set<GroupKey>> guessedGroupsAtStart(numSegments);
+    std::vector<TrackBuilder::Segment> segments(numSegments);
+    runConcurrently(numSegments, [&](std::size_t i) {
+        guessedGroupsAtStart[i] = getModifiedGroups(activeGroupsAtStart[i], selector, modifier);
+        segments[i] = buildSegment(trackIn, boundaries[i], boundaries[i + 1], (i + 1 == numSegments),
+                                   guessedGroupsAtStart[i], selector, modifier);
+    });
+
+    TrackBuilder trackOut;
+    for (unsigned int i = 0; i < numSegments; ++i) {
+        if (guessedGroupsAtStart[i] != trackOut.getActiveGroups()) {
+            segments[i] = buildSegment(trackIn, boundaries[i], boundaries[i + 1], (i + 1 == numSegments),
+                                       trackOut.getActiveGroups(), selector, modifier);
+        }
+        trackOut.addSegment(segments[i]);
+    }
+    return trackOut.finishAndGetTrack(trackIn.getDuration());
+}
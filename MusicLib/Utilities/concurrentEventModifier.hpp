@@ -0,0 +1,35 @@
+/**
+ * Build a track from modified copies of the events of another track, using several threads.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <MusicLib/Types/Track/track.hpp>
+
+#include <functional>
+
+namespace bw_music {
+
+    /// Whether the modifier could change or drop an event.
+    /// Events which are not selected are added to the result without being copied first.
+    using EventSelector = std::function<bool(const TrackEvent& event)>;
+
+    /// Modifies a copy of an event, returning false if the event should be dropped.
+    /// A modifier must not change the time of events and must be safe to call concurrently.
+    using EventModifier = std::function<bool(TrackEvent& event)>;
+
+    /// Build a track from the events of trackIn, with the events chosen by the selector modified by the modifier.
+    /// The result is the same as adding the modified events to a single TrackBuilder, but a long track is split into
+    /// segments which are modified and built concurrently. The groups active where the segments join are worked out
+    /// in advance from the groups of trackIn. A segment for which that guess was wrong, because the modifier made
+    /// groups collide, is rebuilt once the groups at its start are known.
+    /// If numSegments is 0, a number is chosen based on the hardware and the number of events.
+    MUSICLIB_API Track modifyEventsConcurrently(const Track& trackIn, const EventSelector& selector,
+                                                const EventModifier& modifier, unsigned int numSegments = 0);
+
+} // namespace bw_music
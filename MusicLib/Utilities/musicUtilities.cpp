@@ -10,13 +10,7 @@
 #include <MusicLib/Types/Track/track.hpp>
 
 int bw_music::getMinimumDenominator(const Track& track) {
-    int denominator = 1;
-
-    for (const auto& e : track) {
-        denominator = babelwires::lcm(denominator, e.getTimeSinceLastEvent().getDenominator());
-    }
-
-    return denominator;
+    return track.getMinimumDenominator();
 }
 
 std::optional<int> bw_music::transposePitch(int pitch, int offset, TransposeOutOfRangePolicy outOfRangePolicy, int lowerLimit, int upperLimit) {
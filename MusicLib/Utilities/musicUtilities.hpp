@@ -15,6 +15,7 @@ namespace bw_music {
     class Track;
 
     /// Get the minimum denominator sufficient to represent the durations of all events in the track.
+    /// This is maintained by the track as events are added, so it does not require a scan.
     MUSICLIB_API int getMinimumDenominator(const Track& track);
 
     /// How to treat pitches that go out of range when transposing.
@@ -0,0 +1,43 @@
+/**
+ * Run independent tasks on a small pool of threads.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <MusicLib/Utilities/runConcurrently.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+void bw_music::runConcurrently(std::size_t numTasks, const std::function<void(std::size_t)>& task,
+                               unsigned int maxNumThreads) {
+    if (maxNumThreads == 0) {
+        maxNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const unsigned int numThreads = static_cast<unsigned int>(std::min<std::size_t>(numTasks, maxNumThreads));
+    if (numThreads <= 1) {
+        for (std::size_t i = 0; i < numTasks; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> nextTask = 0;
+    const auto runTasks = [&]() {
+        for (std::size_t i = nextTask++; i < numTasks; i = nextTask++) {
+            task(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        threads.emplace_back(runTasks);
+    }
+    runTasks();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
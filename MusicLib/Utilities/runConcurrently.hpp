@@ -0,0 +1,24 @@
+/**
+ * Run independent tasks on a small pool of threads.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <MusicLib/musicLibExport.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace bw_music {
+
+    /// Call task(i) for each i less than numTasks, using at most maxNumThreads threads including the calling thread.
+    /// If maxNumThreads is 0, the hardware concurrency is used. Tasks are claimed in order of their index, so earlier
+    /// tasks start first. When one thread suffices, the tasks are run in order on the calling thread.
+    /// Tasks must be safe to run concurrently. This returns when all of them have finished.
+    MUSICLIB_API void runConcurrently(std::size_t numTasks, const std::function<void(std::size_t)>& task,
+                                      unsigned int maxNumThreads = 0);
+
+} // namespace bw_music
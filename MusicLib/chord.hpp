@@ -14,6 +14,8 @@
 #include <BabelWiresLib/Types/Enum/enumWithCppEnum.hpp>
 #include <BabelWiresLib/TypeSystem/registeredType.hpp>
 
+#include <bitset>
+
 /// Most chords below match the "Chord type" values from the XF Format Specifications v2.01
 /// Some additional chord types are not in the XF spec, but are needed for compatibility with
 /// other devices, such as the Roland PMA-5.
@@ -93,6 +95,9 @@ namespace bw_music {
         bool operator!=(Chord other) const { return (m_root != other.m_root) || (m_chordType != other.m_chordType); }
     };
 
+    /// A set of chord types, indexed by ChordType::Value.
+    using ChordTypeBitset = std::bitset<static_cast<std::size_t>(ChordType::Value::NUM_VALUES)>;
+
     /// A type with a single value meaning "NoChord".
     class MUSICLIB_API NoChord : public babelwires::EnumType {
       public:
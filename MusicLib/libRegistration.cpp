@@ -24,8 +24,11 @@
 #include <MusicLib/Processors/quantizeProcessor.hpp>
 #include <MusicLib/Processors/repeatProcessor.hpp>
 #include <MusicLib/Processors/silenceProcessor.hpp>
+#include <MusicLib/Processors/sliceProcessor.hpp>
 #include <MusicLib/Processors/splitAtPitchProcessor.hpp>
+#include <MusicLib/Processors/splitByCategoryProcessor.hpp>
 #include <MusicLib/Processors/transposeProcessor.hpp>
+#include <MusicLib/Processors/trimProcessor.hpp>
 #include <MusicLib/Types/chordTypeSet.hpp>
 #include <MusicLib/Types/Track/trackTypeConstructor.hpp>
 #include <MusicLib/Types/tempo.hpp>
@@ -59,6 +62,10 @@ void bw_music::registerLib(babelwires::Context& context) {
     typeSystem.addType<SplitAtPitchProcessorOutput>(typeSystem);
     processorFactoryRegistry.addProcessor<SplitAtPitchProcessor>();
 
+    typeSystem.addType<SplitByCategoryProcessorInput>(typeSystem);
+    typeSystem.addType<SplitByCategoryProcessorOutput>(typeSystem);
+    processorFactoryRegistry.addProcessor<SplitByCategoryProcessor>();
+
     typeSystem.addType<MonophonicSubtracksPolicyEnum>();
     typeSystem.addType<MonophonicSubtracksProcessorInput>(typeSystem);
     typeSystem.addType<MonophonicSubtracksProcessorOutput>(typeSystem);
@@ -93,6 +100,15 @@ void bw_music::registerLib(babelwires::Context& context) {
     typeSystem.addType<ExcerptProcessorOutput>(typeSystem);
     processorFactoryRegistry.addProcessor<ExcerptProcessor>();
 
+    typeSystem.addType<TrimModeEnum>();
+    typeSystem.addType<TrimProcessorInput>(typeSystem);
+    typeSystem.addType<TrimProcessorOutput>(typeSystem);
+    processorFactoryRegistry.addProcessor<TrimProcessor>();
+
+    typeSystem.addType<SliceProcessorInput>(typeSystem);
+    typeSystem.addType<SliceProcessorOutput>(typeSystem);
+    processorFactoryRegistry.addProcessor<SliceProcessor>();
+
     typeSystem.addType<RepeatProcessorInput>(typeSystem);
     typeSystem.addType<RepeatProcessorOutput>(typeSystem);
     processorFactoryRegistry.addProcessor<RepeatProcessor>();
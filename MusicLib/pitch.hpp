@@ -16,6 +16,7 @@
 #include <BaseLib/Result/result.hpp>
 #include <BaseLib/common.hpp>
 
+#include <bitset>
 #include <cstdint>
 #include <string>
 
@@ -52,6 +53,9 @@ namespace bw_music {
         static std::string valueToString(Value p);
     };
 
+    /// A set of pitch classes, indexed by PitchClass::Value.
+    using PitchClassBitset = std::bitset<static_cast<std::size_t>(PitchClass::Value::NUM_VALUES)>;
+
     /// Get the PitchClass of a Pitch.
     MUSICLIB_API PitchClass::Value pitchToPitchClass(Pitch p);
 
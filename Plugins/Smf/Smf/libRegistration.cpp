@@ -47,6 +47,7 @@
 #include <Smf/midiTrackAndChannel.hpp>
 #include <Smf/midiTrackAndChannelArray.hpp>
 #include <Smf/recordOfMidiTracks.hpp>
+#include <Smf/smfEncoding.hpp>
 #include <Smf/smfFormat.hpp>
 #include <Smf/smfSequence.hpp>
 
@@ -59,6 +60,7 @@ babelwires::Result smf::registerLib(babelwires::Context& context, babelwires::Us
 
     // Types
     typeSystem.addType<GMSpecType>();
+    typeSystem.addType<SmfEncodingType>();
     typeSystem.addType<MidiMetadata>(typeSystem);
     typeSystem.addType<MidiChannel>();
     typeSystem.addType<MidiTrackAndChannel>(typeSystem);
@@ -0,0 +1,117 @@
+/**
+ * A MappedFile gives read-only access to the whole contents of a file.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <Smf/mappedFile.hpp>
+
+#include <fstream>
+#include <utility>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#define SMF_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef SMF_USE_MMAP
+    /// Returns null if the file could not be mapped, in which case the caller should fall back to reading it.
+    /// Only regular files are mapped. If the file is truncated by another process while it is mapped, reading the
+    /// bytes past its new end raises SIGBUS, which cannot be turned into an Error.
+    const babelwires::Byte* tryMapFile(const std::filesystem::path& path, std::size_t& sizeOut) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat fileStatus;
+        void* mapping = MAP_FAILED;
+        // Empty files cannot be mapped.
+        if ((::fstat(fd, &fileStatus) == 0) && S_ISREG(fileStatus.st_mode) && (fileStatus.st_size > 0)) {
+            sizeOut = static_cast<std::size_t>(fileStatus.st_size);
+            mapping = ::mmap(nullptr, sizeOut, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        // The mapping keeps its own reference to the file.
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return nullptr;
+        }
+        ::madvise(mapping, sizeOut, MADV_SEQUENTIAL);
+        return static_cast<const babelwires::Byte*>(mapping);
+    }
+#endif
+} // namespace
+
+babelwires::ResultT<smf::MappedFile> smf::MappedFile::open(const std::filesystem::path& path) {
+    MappedFile file;
+#ifdef SMF_USE_MMAP
+    file.m_mappedBytes = tryMapFile(path, file.m_mappedSize);
+    if (file.m_mappedBytes) {
+        return std::move(file);
+    }
+#endif
+    return read(path);
+}
+
+babelwires::ResultT<smf::MappedFile> smf::MappedFile::read(const std::filesystem::path& path) {
+    MappedFile file;
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        return babelwires::Error() << "Could not open file " << path;
+    }
+    const std::streamsize size = stream.tellg();
+    if (size < 0) {
+        // The stream is not seekable, so its size is unknown.
+        return babelwires::Error() << "Could not determine the size of file " << path;
+    }
+    stream.seekg(0);
+    file.m_fileContents.resize(static_cast<std::size_t>(size));
+    if (!stream.read(reinterpret_cast<char*>(file.m_fileContents.data()), size)) {
+        return babelwires::Error() << "Could not read file " << path;
+    }
+    return std::move(file);
+}
+
+smf::MappedFile::MappedFile(MappedFile&& other)
+    : m_mappedBytes(std::exchange(other.m_mappedBytes, nullptr))
+    , m_mappedSize(std::exchange(other.m_mappedSize, 0))
+    , m_fileContents(std::move(other.m_fileContents)) {}
+
+smf::MappedFile& smf::MappedFile::operator=(MappedFile&& other) {
+    if (this != &other) {
+        unmap();
+        m_mappedBytes = std::exchange(other.m_mappedBytes, nullptr);
+        m_mappedSize = std::exchange(other.m_mappedSize, 0);
+        m_fileContents = std::move(other.m_fileContents);
+    }
+    return *this;
+}
+
+smf::MappedFile::~MappedFile() {
+    unmap();
+}
+
+void smf::MappedFile::unmap() {
+#ifdef SMF_USE_MMAP
+    if (m_mappedBytes) {
+        ::munmap(const_cast<babelwires::Byte*>(m_mappedBytes), m_mappedSize);
+        m_mappedBytes = nullptr;
+        m_mappedSize = 0;
+    }
+#endif
+}
+
+std::span<const babelwires::Byte> smf::MappedFile::getBytes() const {
+    if (m_mappedBytes) {
+        return {m_mappedBytes, m_mappedSize};
+    }
+    return m_fileContents;
+}
+
+bool smf::MappedFile::isMapped() const {
+    return m_mappedBytes != nullptr;
+}
@@ -0,0 +1,54 @@
+/**
+ * A MappedFile gives read-only access to the whole contents of a file.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BaseLib/IO/dataSource.hpp>
+#include <BaseLib/Result/result.hpp>
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace smf {
+    /// Gives access to the bytes of a file without reading them one at a time.
+    /// Where possible, the file is memory-mapped so the bytes are not copied. Otherwise the whole file is read into
+    /// memory.
+    /// A mapped file must not be truncated while this object exists: on POSIX systems, reading the missing bytes
+    /// raises SIGBUS. Only use open where that risk is acceptable, such as batch tools. Files loaded by the
+    /// application are read.
+    class MappedFile {
+      public:
+        /// Map the file if possible, or else read it.
+        static babelwires::ResultT<MappedFile> open(const std::filesystem::path& path);
+
+        /// Always read the whole file into memory, so later changes to the file cannot affect the bytes.
+        static babelwires::ResultT<MappedFile> read(const std::filesystem::path& path);
+
+        MappedFile(MappedFile&& other);
+        MappedFile& operator=(MappedFile&& other);
+        ~MappedFile();
+
+        /// The contents of the file, which remain valid while this object exists.
+        std::span<const babelwires::Byte> getBytes() const;
+
+        /// True if the bytes are mapped rather than copied.
+        bool isMapped() const;
+
+      private:
+        MappedFile() = default;
+        void unmap();
+
+      private:
+        /// Non-null when the file is mapped.
+        const babelwires::Byte* m_mappedBytes = nullptr;
+        std::size_t m_mappedSize = 0;
+
+        /// Used when the file could not be mapped.
+        std::vector<babelwires::Byte> m_fileContents;
+    };
+} // namespace smf
@@ -25,5 +25,6 @@ smf::MidiMetadata::MidiMetadata(const babelwires::TypeSystem& typeSystem)
            {BW_SHORT_ID("Name", "Name", "c2e4910f-d006-4a93-97a7-ae5973157ec8"),
             babelwires::StringType::getThisIdentifier(), babelwires::RecordType::Optionality::optionalDefaultInactive},
            {BW_SHORT_ID("CopyR", "Copyright", "a59dc914-d060-4f03-be83-5804fc4d6b6a"),
-            babelwires::StringType::getThisIdentifier(),
-            babelwires::RecordType::Optionality::optionalDefaultInactive}}) {}
+            babelwires::StringType::getThisIdentifier(), babelwires::RecordType::Optionality::optionalDefaultInactive},
+           {BW_SHORT_ID("Encode", "Encoding", "f22219f6-d243-4ff2-a424-3a8d17425c72"),
+            SmfEncodingType::getThisIdentifier(), babelwires::RecordType::Optionality::optionalDefaultInactive}}) {}
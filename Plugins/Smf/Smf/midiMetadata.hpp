@@ -8,6 +8,7 @@
 #pragma once
 
 #include <Smf/gmSpec.hpp>
+#include <Smf/smfEncoding.hpp>
 
 #include <MusicLib/Types/tempo.hpp>
 
@@ -28,6 +29,8 @@ namespace smf {
         DECLARE_INSTANCE_FIELD_OPTIONAL(Tempo, bw_music::Tempo)
         DECLARE_INSTANCE_FIELD_OPTIONAL(Name, babelwires::StringType)
         DECLARE_INSTANCE_FIELD_OPTIONAL(CopyR, babelwires::StringType)
+        /// Only used when writing. Files are read whatever their encoding.
+        DECLARE_INSTANCE_FIELD_OPTIONAL(Encode, SmfEncodingType)
         DECLARE_INSTANCE_END()
     };
 } // namespace smf
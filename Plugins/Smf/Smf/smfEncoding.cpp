@@ -0,0 +1,15 @@
+/**
+ * An enum which defines how compactly a Standard MIDI File is encoded.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <Smf/smfEncoding.hpp>
+
+#include <BaseLib/Identifiers/identifierRegistry.hpp>
+
+ENUM_DEFINE_ENUM_VALUE_SOURCE(smf::SmfEncodingType, SMF_ENCODING_VALUES);
+
+smf::SmfEncodingType::SmfEncodingType()
+    : EnumType(getThisIdentifier(), getStaticValueSet(), 0) {}
@@ -0,0 +1,30 @@
+/**
+ * An enum which defines how compactly a Standard MIDI File is encoded.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <BabelWiresLib/Types/Enum/enumWithCppEnum.hpp>
+#include <BabelWiresLib/TypeSystem/registeredType.hpp>
+#include <BabelWiresLib/Instance/enumTypeInstance.hpp>
+#include <BabelWiresLib/Instance/instance.hpp>
+
+#define SMF_ENCODING_VALUES(X)                                                                                         \
+    X(Plain, "Every status byte", "5a25322d-a2fc-42b7-bbf0-beea75d4593b")                                              \
+    X(RunSt, "Running status", "2be33a58-ccf7-4e83-88ed-014db4e7298b")                                                 \
+    X(Cmpact, "Running status and note on for note off", "ae2f730e-9d30-4a62-9fd0-faf13a2ebf3d")
+
+namespace smf {
+    /// Carries the enum of encodings, which correspond to the SmfWriterOptions.
+    class SmfEncodingType : public babelwires::EnumType {
+      public:
+        DOWNCASTABLE(SmfEncodingType, babelwires::EnumType);
+        REGISTERED_TYPE("SmfEnc", "MIDI Encoding", "6e40ec9f-83b1-4044-800f-92de4878bc21", 1);
+        SmfEncodingType();
+
+        ENUM_DEFINE_CPP_ENUM(SMF_ENCODING_VALUES);
+    };
+} // namespace smf
@@ -11,10 +11,10 @@
 #include <BabelWiresLib/Types/File/fileTypeT.hpp>
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
 
+#include <Smf/mappedFile.hpp>
 #include <Smf/smfParser.hpp>
 #include <Smf/smfWriter.hpp>
 
-#include <BaseLib/IO/fileDataSource.hpp>
 #include <BaseLib/IO/fileDataSink.hpp>
 
 namespace {
@@ -45,11 +45,12 @@ std::string smf::SmfSourceFormat::getProductName() const {
 babelwires::ResultT<std::unique_ptr<babelwires::ValueTreeRoot>>
 smf::SmfSourceFormat::loadFromFile(const std::filesystem::path& path, const babelwires::Context& context,
                                    babelwires::UserLogger& userLogger) const {
-    ASSIGN_OR_ERROR(auto dataSource, babelwires::FileDataSource::open(path));
-    ON_ERROR(dataSource.closeOnError());
-    ASSIGN_OR_ERROR(auto result, parseSmfSequence(dataSource, context, userLogger));
-    DO_OR_ERROR(dataSource.close());
-    return std::move(result);
+    // The file is read rather than mapped, since a mapped file truncated by another program would crash the
+    // application.
+    // The tracks are only built when they are first used, so they keep the bytes alive until then.
+    ASSIGN_OR_ERROR(auto file, MappedFile::read(path));
+    auto sharedFile = std::make_shared<const MappedFile>(std::move(file));
+    return parseSmfSequenceDeferred(sharedFile->getBytes(), sharedFile, context, userLogger);
 }
 
 smf::SmfTargetFormat::SmfTargetFormat()
@@ -76,7 +77,7 @@ babelwires::Result smf::SmfTargetFormat::writeToFile(const babelwires::Context&
                                                       const std::filesystem::path& path) const {
     ASSIGN_OR_ERROR(auto sink, babelwires::FileDataSink::open(path));
     ON_ERROR(sink.closeOnError());
-    writeToSmf(context, userLogger, contents, sink.stream());
+    writeToSmf(context, userLogger, contents, sink.stream(), getSmfWriterOptions(contents));
     DO_OR_ERROR(sink.close());
     return {};
 }
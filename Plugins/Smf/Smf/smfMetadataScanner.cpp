@@ -0,0 +1,191 @@
+/**
+ * Obtain a summary of a Standard MIDI File without building its tracks.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <Smf/smfMetadataScanner.hpp>
+
+#include <Smf/smfTrackReader.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+    using Byte = babelwires::Byte;
+
+    std::uint32_t readU16(const Byte* bytes) {
+        return (static_cast<std::uint32_t>(bytes[0]) << 8) | bytes[1];
+    }
+
+    std::uint32_t readU32(const Byte* bytes) {
+        return (static_cast<std::uint32_t>(bytes[0]) << 24) | (static_cast<std::uint32_t>(bytes[1]) << 16) |
+               (static_cast<std::uint32_t>(bytes[2]) << 8) | bytes[3];
+    }
+
+    bool hasTag(const Byte* bytes, const char* tag) {
+        return std::equal(bytes, bytes + 4, tag);
+    }
+
+    /// Record a note on or note off in the metadata.
+    void countNoteEvent(smf::SmfMetadata& metadata, Byte statusByte, Byte velocity) {
+        const Byte statusHi = statusByte >> 4;
+        const Byte channelNumber = statusByte & 0xf;
+        if ((statusHi == 0b1000) || (statusHi == 0b1001)) {
+            metadata.m_channelsUsed.set(channelNumber);
+            // A note on with zero velocity is a note off.
+            if ((statusHi == 0b1001) && (velocity != 0)) {
+                ++metadata.m_numNotesPerChannel[channelNumber];
+            }
+        }
+    }
+
+    std::string toString(std::span<const Byte> text) {
+        return std::string(reinterpret_cast<const char*>(text.data()), text.size());
+    }
+
+    /// Read the events of a track chunk, interpreting only the events which contribute to the SmfMetadata.
+    /// Returns the duration of the track in ticks.
+    babelwires::ResultT<std::uint64_t> scanTrack(smf::SmfTrackReader& reader, int trackIndex, bool hasMainMetadata,
+                                                 smf::SmfMetadata& metadata) {
+        std::uint64_t ticksSinceStart = 0;
+        Byte lastStatusByte = 0;
+        while (!reader.isAtEnd()) {
+            if (const auto message = reader.tryReadChannelMessage(lastStatusByte)) {
+                ticksSinceStart += message->m_deltaTicks;
+                countNoteEvent(metadata, message->m_statusByte, message->m_data1);
+                continue;
+            }
+            {
+                ASSIGN_OR_ERROR(const std::uint32_t numTicks, reader.readVariableLengthQuantity());
+                ticksSinceStart += numTicks;
+            }
+
+            ASSIGN_OR_ERROR(const Byte statusByte, reader.readStatusByte(lastStatusByte));
+            if ((statusByte >= 0x80) && (statusByte <= 0xEF)) {
+                ASSIGN_OR_ERROR(const auto data,
+                                reader.readBytes(smf::SmfTrackReader::getNumDataBytes(statusByte)));
+                countNoteEvent(metadata, statusByte, (data.size() == 2) ? data[1] : 0);
+            } else if ((statusByte == 0xF0) || (statusByte == 0xF7)) {
+                // SysEx message or continuation.
+                ASSIGN_OR_ERROR(const std::uint32_t length, reader.readVariableLengthQuantity());
+                ASSIGN_OR_ERROR(const auto message, reader.readBytes(length));
+                if (statusByte == 0xF0) {
+                    if (const auto gmSpec = smf::getGMSpecFromSysEx(message)) {
+                        metadata.m_gmSpec = *gmSpec;
+                    }
+                }
+            } else if (statusByte == 0xFF) {
+                // Meta-event.
+                ASSIGN_OR_ERROR(const Byte type, reader.getNext());
+                ASSIGN_OR_ERROR(const std::uint32_t length, reader.readVariableLengthQuantity());
+                if (type == 0x2F) {
+                    // End of track.
+                    if (!reader.isAtEnd()) {
+                        return babelwires::Error() << "MIDI track " << trackIndex
+                                                   << " had an unexpected end-of-track event at offset "
+                                                   << reader.getPosition();
+                    }
+                    return ticksSinceStart;
+                }
+                ASSIGN_OR_ERROR(const auto data, reader.readBytes(length));
+                if (hasMainMetadata) {
+                    if (type == 0x02) {
+                        metadata.m_copyright = toString(data);
+                    } else if (type == 0x03) {
+                        metadata.m_name = toString(data);
+                    } else if ((type == 0x51) && (length == 3)) {
+                        const double tempoValue = (static_cast<std::uint32_t>(data[0]) << 16) |
+                                                  (static_cast<std::uint32_t>(data[1]) << 8) | data[2];
+                        metadata.m_tempo = static_cast<int>(std::round(60'000'000 / tempoValue));
+                    }
+                }
+            } else {
+                return babelwires::Error() << "Unrecognized MIDI message with status byte "
+                                           << static_cast<int>(statusByte) << " at offset " << reader.getPosition();
+            }
+        }
+        return babelwires::Error() << "Read all of track " << trackIndex << " without finding an end-of-track event";
+    }
+} // namespace
+
+babelwires::ResultT<smf::SmfMetadata> smf::scanSmfMetadata(std::span<const babelwires::Byte> bytes) {
+    SmfMetadata metadata;
+
+    constexpr std::size_t headerChunkSize = 14;
+    if ((bytes.size() < headerChunkSize) || !hasTag(bytes.data(), "MThd")) {
+        return babelwires::Error() << "The data does not start with a MIDI header chunk";
+    }
+    if (readU32(bytes.data() + 4) != 6) {
+        return babelwires::Error() << "Header chunk not expected length";
+    }
+    metadata.m_format = readU16(bytes.data() + 8);
+    if (metadata.m_format == 2) {
+        return babelwires::Error() << "Standard MIDI File Format 2 files are not currently supported";
+    } else if (metadata.m_format > 2) {
+        return babelwires::Error() << "Not a known type of Standard MIDI File";
+    }
+    metadata.m_numTracks = readU16(bytes.data() + 10);
+    if ((metadata.m_format == 0) && (metadata.m_numTracks != 1)) {
+        return babelwires::Error() << "A format 0 Standard MIDI file claims to have " << metadata.m_numTracks
+                                   << " tracks but it should only have 1";
+    }
+    metadata.m_division = readU16(bytes.data() + 12);
+    if (metadata.m_division & (1 << 15)) {
+        return babelwires::Error() << "SMPTE format durations not supported";
+    }
+    if (metadata.m_division == 0) {
+        return babelwires::Error() << "The division of the MIDI file is zero";
+    }
+
+    std::size_t position = headerChunkSize;
+    std::uint64_t maxTrackTicks = 0;
+    for (int i = 0; i < metadata.m_numTracks; ++i) {
+        if ((bytes.size() - position < 8) || !hasTag(bytes.data() + position, "MTrk")) {
+            return babelwires::Error() << "Expected a MIDI track chunk at offset " << position;
+        }
+        const std::uint32_t trackLength = readU32(bytes.data() + position + 4);
+        position += 8;
+        if (bytes.size() - position < trackLength) {
+            return babelwires::Error() << "Stream is truncated: The MIDI track at offset " << position
+                                       << " has length " << trackLength << " but only " << (bytes.size() - position)
+                                       << " bytes remain";
+        }
+        smf::SmfTrackReader reader(bytes.subspan(position, trackLength), position);
+        ASSIGN_OR_ERROR(const std::uint64_t trackTicks, scanTrack(reader, i, (i == 0), metadata));
+        maxTrackTicks = std::max(maxTrackTicks, trackTicks);
+        position += trackLength;
+    }
+    metadata.m_duration = bw_music::ModelDuration(static_cast<babelwires::Rational::ComponentType>(maxTrackTicks),
+                                                  metadata.m_division * 4);
+    return metadata;
+}
+
+babelwires::ResultT<smf::SmfMetadata> smf::scanSmfMetadata(babelwires::DataSource& dataSource) {
+    // Read the chunks the header says are present, and scan them in memory.
+    std::vector<babelwires::Byte> bytes;
+    const auto readBytes = [&dataSource, &bytes](std::uint32_t numBytes) -> babelwires::Result {
+        for (std::uint32_t i = 0; i < numBytes; ++i) {
+            const auto result = dataSource.getNextByte();
+            if (!result) {
+                return babelwires::Error() << "Stream is truncated (" << result.error().toString() << ")";
+            }
+            bytes.emplace_back(*result);
+        }
+        return {};
+    };
+    DO_OR_ERROR(readBytes(14));
+    if (!hasTag(bytes.data(), "MThd")) {
+        // Let the other overload report the problem.
+        return scanSmfMetadata(bytes);
+    }
+    const std::uint32_t numTracks = readU16(bytes.data() + 10);
+    for (std::uint32_t i = 0; i < numTracks; ++i) {
+        DO_OR_ERROR(readBytes(8));
+        DO_OR_ERROR(readBytes(readU32(bytes.data() + bytes.size() - 4)));
+    }
+    return scanSmfMetadata(bytes);
+}
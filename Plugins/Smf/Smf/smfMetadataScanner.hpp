@@ -0,0 +1,56 @@
+/**
+ * Obtain a summary of a Standard MIDI File without building its tracks.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <Smf/gmSpec.hpp>
+
+#include <MusicLib/musicTypes.hpp>
+
+#include <BaseLib/IO/dataSource.hpp>
+#include <BaseLib/Result/result.hpp>
+
+#include <array>
+#include <bitset>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace smf {
+    /// The information about a Standard MIDI File which a catalog of files would need.
+    struct SmfMetadata {
+        /// The SMF format, which is 0 or 1.
+        int m_format = 0;
+        int m_numTracks = 0;
+        /// Ticks per quarter note.
+        int m_division = 0;
+
+        /// As in the MidiMetadata obtained by parsing, these come from the first track.
+        std::optional<std::string> m_name;
+        std::optional<std::string> m_copyright;
+        /// In beats per minute.
+        std::optional<int> m_tempo;
+
+        GMSpecType::Value m_gmSpec = GMSpecType::Value::NONE;
+
+        /// The channels which have note events.
+        std::bitset<16> m_channelsUsed;
+        /// The number of notes started on each channel.
+        std::array<int, 16> m_numNotesPerChannel{};
+        /// The duration of the longest track.
+        bw_music::ModelDuration m_duration = 0;
+    };
+
+    /// Scan the chunks of the file for metadata and count its notes, without building any tracks.
+    /// This is much faster than parseSmfSequence, and does not need a context. Malformed files are rejected, as they
+    /// are by parseSmfSequence, but messages which parseSmfSequence would warn about are silently ignored.
+    babelwires::ResultT<SmfMetadata> scanSmfMetadata(std::span<const babelwires::Byte> bytes);
+
+    /// As above, but the bytes are obtained from the dataSource.
+    babelwires::ResultT<SmfMetadata> scanSmfMetadata(babelwires::DataSource& dataSource);
+
+} // namespace smf
@@ -14,6 +14,7 @@
 #include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
 #include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
 #include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Utilities/runConcurrently.hpp>
 
 #include <BaseLib/Context/context.hpp>
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
@@ -22,34 +23,111 @@
 #include <BaseLib/Log/debugLogger.hpp>
 #include <BaseLib/Result/result.hpp>
 
+#include <algorithm>
+#include <bitset>
 #include <cassert>
 #include <cmath>
 #include <iomanip>
+#include <thread>
 
 namespace {
     static const int MAX_CHANNELS = 16;
 
+    /// Below this size, starting threads to parse the tracks costs more than it saves.
+    constexpr std::size_t c_minBytesForConcurrentParsing = 1 << 16;
+
+    /// Convert a number of MIDI ticks to a duration, where a quarter note has division ticks.
+    bw_music::ModelDuration ticksToModelDuration(std::uint64_t ticks, int division) {
+        return bw_music::ModelDuration(static_cast<babelwires::Rational::ComponentType>(ticks), division * 4);
+    }
+
     // See page 237 of the SC-8850 English manual
     const std::array<unsigned int, 16> s_gsBlockToPartMapping{10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12, 13, 14, 15, 16};
 } // namespace
 
 smf::SmfParser::SmfParser(babelwires::DataSource& dataSource, const babelwires::Context& context,
                           babelwires::UserLogger& userLogger)
+    : SmfParser(&dataSource, {}, context, userLogger) {}
+
+smf::SmfParser::SmfParser(std::span<const babelwires::Byte> bytes, const babelwires::Context& context,
+                          babelwires::UserLogger& userLogger)
+    : SmfParser(nullptr, bytes, context, userLogger) {}
+
+smf::SmfParser::SmfParser(babelwires::DataSource* dataSource, std::span<const babelwires::Byte> bytes,
+                          const babelwires::Context& context, babelwires::UserLogger& userLogger)
     : m_projectContext(context)
     , m_dataSource(dataSource)
+    , m_bytes(bytes)
     , m_userLogger(userLogger)
     , m_sequenceType(Format::SMF_UNKNOWN_FORMAT)
     , m_numTracks(-1)
     , m_division(-1)
-    , m_standardPercussionSets(context) {
+    , m_standardPercussionSets(std::make_shared<StandardPercussionSets>(context)) {
 
     m_result = std::make_unique<babelwires::ValueTreeRoot>(
         context.get<babelwires::TypeSystem>(), babelwires::FileTypeT<SmfSequence>::getType(context.get<babelwires::TypeSystem>()));
     m_result->setToDefault();
+    m_gmSpec = getMidiMetadata().getSpec().get();
+}
+
+smf::SmfParser::SmfParser(const babelwires::Context& context, babelwires::UserLogger& userLogger, int division,
+                          GMSpecType::Value gmSpec, std::shared_ptr<StandardPercussionSets> standardPercussionSets)
+    : m_projectContext(context)
+    , m_dataSource(nullptr)
+    , m_userLogger(userLogger)
+    , m_sequenceType(Format::SMF_FORMAT_1)
+    , m_numTracks(-1)
+    , m_division(division)
+    , m_standardPercussionSets(std::move(standardPercussionSets))
+    , m_gmSpec(gmSpec) {}
+
+void smf::SmfParser::setMaxNumThreads(unsigned int maxNumThreads) {
+    m_maxNumThreads = maxNumThreads;
+}
+
+void smf::SmfParser::setDeferTracks(std::shared_ptr<const void> bytesOwner) {
+    assert(!m_dataSource && "Only bytes in memory can be parsed later");
+    m_deferredBytesOwner = std::move(bytesOwner);
 }
 
 smf::SmfParser::~SmfParser() = default;
 
+/// Collects the text of a warning and, when it is destroyed, logs it or adds it to the buffered warnings.
+class smf::SmfParser::WarningStream {
+  public:
+    explicit WarningStream(SmfParser& parser)
+        : m_parser(parser) {}
+    WarningStream(const WarningStream&) = delete;
+    WarningStream& operator=(const WarningStream&) = delete;
+
+    ~WarningStream() {
+        if (m_parser.m_bufferedWarnings) {
+            m_parser.m_bufferedWarnings->emplace_back(m_stream.str());
+        } else {
+            m_parser.m_userLogger.logWarning() << m_stream.str();
+        }
+    }
+
+    template <typename T> WarningStream& operator<<(const T& value) {
+        m_stream << value;
+        return *this;
+    }
+
+    /// For manipulators such as std::hex.
+    WarningStream& operator<<(std::ios_base& (*manipulator)(std::ios_base&)) {
+        m_stream << manipulator;
+        return *this;
+    }
+
+  private:
+    SmfParser& m_parser;
+    std::ostringstream m_stream;
+};
+
+smf::SmfParser::WarningStream smf::SmfParser::logWarning() {
+    return WarningStream(*this);
+}
+
 smf::SmfSequence::ConstInstance smf::SmfParser::getSmfSequenceConst() const {
     return babelwires::FileTypeT<SmfSequence>::ConstInstance(*m_result).getConts();
 }
@@ -61,7 +139,16 @@ smf::SmfSequence::Instance smf::SmfParser::getSmfSequence() {
 smf::SmfSequence::Instance getSmfSequence();
 
 babelwires::ResultT<babelwires::Byte> smf::SmfParser::getNext() {
-    const auto result = m_dataSource.getNextByte();
+    if (m_isReadingTrackData) {
+        return m_trackReader.getNext();
+    }
+    if (!m_dataSource) {
+        if (m_bytesPosition < m_bytes.size()) {
+            return m_bytes[m_bytesPosition++];
+        }
+        return babelwires::Error() << "Stream is truncated at offset " << m_bytesPosition;
+    }
+    const auto result = m_dataSource->getNextByte();
     if (!result) {
         return babelwires::Error() << "Stream is truncated (" << result.error().toString() << ")";
     }
@@ -69,19 +156,38 @@ babelwires::ResultT<babelwires::Byte> smf::SmfParser::getNext() {
 }
 
 babelwires::ResultT<babelwires::Byte> smf::SmfParser::peekNext() {
-    const auto result = m_dataSource.peekNextByte();
+    if (m_isReadingTrackData) {
+        return m_trackReader.peekNext();
+    }
+    if (!m_dataSource) {
+        if (m_bytesPosition < m_bytes.size()) {
+            return m_bytes[m_bytesPosition];
+        }
+        return babelwires::Error() << "Stream is truncated at offset " << m_bytesPosition;
+    }
+    const auto result = m_dataSource->peekNextByte();
     if (!result) {
         return babelwires::Error() << "Stream is truncated (" << result.error().toString() << ")";
     }
     return result;
 }
 
+int smf::SmfParser::getPosition() const {
+    if (m_isReadingTrackData) {
+        return static_cast<int>(m_trackReader.getPosition());
+    }
+    if (!m_dataSource) {
+        return static_cast<int>(m_bytesPosition);
+    }
+    return m_dataSource->getAbsolutePosition();
+}
+
 babelwires::Result smf::SmfParser::readByteSequence(const char* seq) {
     assert(seq);
     while (*seq) {
         ASSIGN_OR_ERROR(const babelwires::Byte c, getNext());
         if (c != *seq) {
-            return babelwires::Error() << "Expected " << *seq << " at index " << m_dataSource.getAbsolutePosition()
+            return babelwires::Error() << "Expected " << *seq << " at index " << getPosition()
                                        << " but found " << c << " instead";
         }
         ++seq;
@@ -118,24 +224,8 @@ babelwires::ResultT<std::uint32_t> smf::SmfParser::readU32() {
 }
 
 babelwires::ResultT<std::uint32_t> smf::SmfParser::readVariableLengthQuantity() {
-    std::uint32_t result = 0;
-    babelwires::Byte b;
-    int numBytes = 0;
-    do {
-        if (numBytes == 4) {
-            return babelwires::Error() << "Variable Length Quantity too big";
-        }
-        ++numBytes;
-
-        ASSIGN_OR_ERROR(b, getNext());
-        result = (result << 7) + (b & 0x7f);
-    } while (b & 0x80);
-    return result;
-}
-
-babelwires::ResultT<bw_music::ModelDuration> smf::SmfParser::readModelDuration() {
-    ASSIGN_OR_ERROR(const int numDivisions, readVariableLengthQuantity());
-    return bw_music::ModelDuration(numDivisions) * bw_music::ModelDuration(1, m_division * 4);
+    assert(m_isReadingTrackData && "Variable length quantities only occur in tracks");
+    return m_trackReader.readVariableLengthQuantity();
 }
 
 babelwires::ResultT<std::string> smf::SmfParser::readTextMetaEvent(int length) {
@@ -211,45 +301,52 @@ void smf::SmfParser::readTempoEvent(std::uint32_t tempoValue) {
 
 class smf::SmfParser::TrackSplitter {
   public:
-    TrackSplitter(const std::array<ChannelSetup, 16>& channelSetup)
+    /// Events on channels which are not built are counted but not added to a track.
+    TrackSplitter(const std::array<ChannelSetup, 16>& channelSetup, int division,
+                  std::bitset<MAX_CHANNELS> channelsToBuild = std::bitset<MAX_CHANNELS>().set())
         : m_channels{}
-        , m_channelSetup(channelSetup) {}
+        , m_channelSetup(channelSetup)
+        , m_division(division)
+        , m_channelsToBuild(channelsToBuild) {}
 
-    bool addNoteOn(unsigned int channelNumber, bw_music::ModelDuration timeSinceLastTrackEvent, bw_music::Pitch pitch,
+    bool addNoteOn(unsigned int channelNumber, std::uint64_t ticksSinceLastTrackEvent, bw_music::Pitch pitch,
                    bw_music::Velocity velocity) {
         if (const bw_music::PercussionSetWithPitchMap* const percussionSet =
                 m_channelSetup[channelNumber].m_kitIfPercussion) {
-            if (auto instrument = percussionSet->tryGetInstrumentFromPitch(pitch)) {
-                addToChannel<bw_music::PercussionOnEvent>(channelNumber, timeSinceLastTrackEvent, *instrument,
-                                                          velocity);
+            if (auto instrument = percussionSet->tryGetIndexedInstrumentFromPitch(pitch)) {
+                addToChannel<bw_music::PercussionOnEvent>(channelNumber, ticksSinceLastTrackEvent,
+                                                          instrument->m_instrument, velocity,
+                                                          instrument->m_instrumentIndex);
                 return true;
             }
             return false;
         } else {
-            addToChannel<bw_music::NoteOnEvent>(channelNumber, timeSinceLastTrackEvent, pitch, velocity);
+            addToChannel<bw_music::NoteOnEvent>(channelNumber, ticksSinceLastTrackEvent, pitch, velocity);
             return true;
         }
     }
 
-    bool addNoteOff(unsigned int channelNumber, bw_music::ModelDuration timeSinceLastTrackEvent, bw_music::Pitch pitch,
+    bool addNoteOff(unsigned int channelNumber, std::uint64_t ticksSinceLastTrackEvent, bw_music::Pitch pitch,
                     bw_music::Velocity velocity) {
         if (const bw_music::PercussionSetWithPitchMap* const percussionSet =
                 m_channelSetup[channelNumber].m_kitIfPercussion) {
-            if (auto instrument = percussionSet->tryGetInstrumentFromPitch(pitch)) {
-                addToChannel<bw_music::PercussionOffEvent>(channelNumber, timeSinceLastTrackEvent, *instrument,
-                                                           velocity);
+            if (auto instrument = percussionSet->tryGetIndexedInstrumentFromPitch(pitch)) {
+                addToChannel<bw_music::PercussionOffEvent>(channelNumber, ticksSinceLastTrackEvent,
+                                                           instrument->m_instrument, velocity,
+                                                           instrument->m_instrumentIndex);
                 return true;
             }
             return false;
         } else {
-            addToChannel<bw_music::NoteOffEvent>(channelNumber, timeSinceLastTrackEvent, pitch, velocity);
+            addToChannel<bw_music::NoteOffEvent>(channelNumber, ticksSinceLastTrackEvent, pitch, velocity);
             return true;
         }
     }
 
     /// All channels share the duration of the MIDI track.
-    void setDurationsForAllChannels(bw_music::ModelDuration timeToEndOfTrackEvent) {
-        const bw_music::ModelDuration duration = m_timeSinceStart + timeToEndOfTrackEvent;
+    void setDurationsForAllChannels(std::uint64_t ticksToEndOfTrackEvent) {
+        const bw_music::ModelDuration duration =
+            ticksToModelDuration(m_ticksSinceStart + ticksToEndOfTrackEvent, m_division);
         for (int channelNumber = 0; channelNumber < MAX_CHANNELS; ++channelNumber) {
             if (m_channels[channelNumber] != nullptr) {
                 m_channels[channelNumber]->m_trackDuration = duration;
@@ -260,8 +357,9 @@ class smf::SmfParser::TrackSplitter {
   private:
     struct PerChannelInfo {
         bw_music::TrackBuilder m_track;
-        bw_music::ModelDuration m_timeOfLastEvent;
+        std::uint64_t m_tickOfLastEvent = 0;
         bw_music::ModelDuration m_trackDuration = 0;
+        int m_numEventsAdded = 0;
     };
 
     PerChannelInfo* getChannel(unsigned int channelNumber) {
@@ -276,24 +374,34 @@ class smf::SmfParser::TrackSplitter {
     }
 
     template <typename EVENT_TYPE, typename... ARGS>
-    void addToChannel(unsigned int channelNumber, bw_music::ModelDuration timeSinceLastTrackEvent, ARGS&&... args) {
+    void addToChannel(unsigned int channelNumber, std::uint64_t ticksSinceLastTrackEvent, ARGS&&... args) {
         PerChannelInfo* channel = getChannel(channelNumber);
 
-        m_timeSinceStart += timeSinceLastTrackEvent;
-        channel->m_track.addEvent(
-            EVENT_TYPE{m_timeSinceStart - channel->m_timeOfLastEvent, std::forward<ARGS>(args)...});
-        channel->m_timeOfLastEvent = m_timeSinceStart;
+        // Times are kept in ticks, so there is only one conversion to a Rational per event.
+        m_ticksSinceStart += ticksSinceLastTrackEvent;
+        if (m_channelsToBuild[channelNumber]) {
+            const std::uint64_t ticksSinceLastChannelEvent = m_ticksSinceStart - channel->m_tickOfLastEvent;
+            channel->m_track.addEvent(EVENT_TYPE{ticksToModelDuration(ticksSinceLastChannelEvent, m_division),
+                                                 std::forward<ARGS>(args)...});
+            channel->m_tickOfLastEvent = m_ticksSinceStart;
+        }
+        ++channel->m_numEventsAdded;
     }
 
   public:
-    bw_music::ModelDuration m_timeSinceStart;
+    std::uint64_t m_ticksSinceStart = 0;
 
     std::array<std::unique_ptr<PerChannelInfo>, MAX_CHANNELS> m_channels;
 
     const std::array<ChannelSetup, 16>& m_channelSetup;
+
+    /// The number of ticks in a quarter note.
+    int m_division;
+
+    std::bitset<MAX_CHANNELS> m_channelsToBuild;
 };
 
-template <typename STREAMLIKE> babelwires::Result smf::SmfParser::logByteSequence(STREAMLIKE log, int length) {
+template <typename STREAMLIKE> babelwires::Result smf::SmfParser::logByteSequence(STREAMLIKE&& log, int length) {
     {
         ASSIGN_OR_ERROR(const auto b, getNext());
         log << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(b);
@@ -327,7 +435,7 @@ template <std::size_t N> bool smf::SmfParser::isMessageBufferMessage(const std::
     return true;
 }
 
-template <typename STREAMLIKE> void smf::SmfParser::logMessageBuffer(STREAMLIKE log) const {
+template <typename STREAMLIKE> void smf::SmfParser::logMessageBuffer(STREAMLIKE&& log) const {
     log << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(m_messageBuffer[0]);
     for (auto i = 1; i < m_messageBuffer.size(); ++i) {
         log << ", " << std::setfill('0') << std::setw(2) << static_cast<int>(m_messageBuffer[i]);
@@ -338,7 +446,7 @@ babelwires::Result smf::SmfParser::readSysExEvent() {
     ASSIGN_OR_ERROR(auto length, readVariableLengthQuantity());
     if (length < 1) {
         DO_OR_ERROR(
-            logByteSequence(m_userLogger.logWarning() << "Skipping SysEx message with invalid length: ", length));
+            logByteSequence(logWarning() << "Skipping SysEx message with invalid length: ", length));
         return {};
     }
     DO_OR_ERROR(readFullMessageIntoBuffer(length));
@@ -347,7 +455,7 @@ babelwires::Result smf::SmfParser::readSysExEvent() {
         // Universal SysEx
         if (length < 4) {
             DO_OR_ERROR(logByteSequence(
-                m_userLogger.logWarning() << "Skipping Universal SysEx message with invalid length: ", length));
+                logWarning() << "Skipping Universal SysEx message with invalid length: ", length));
             return {};
         }
         // Universal Non-Real Time SysEx
@@ -356,22 +464,19 @@ babelwires::Result smf::SmfParser::readSysExEvent() {
         const babelwires::Byte subId2 = m_messageBuffer[3];
         if (subId1 == 0x09) {
             // General MIDI message
-            if (subId2 == 0x01) {
-                // General MIDI On
-                setGMSpec(GMSpecType::Value::GM);
-                babelwires::logDebug() << "General MIDI On";
+            if (const auto gmSpec = getGMSpecFromSysEx(m_messageBuffer)) {
+                // General MIDI On or General MIDI 2 On
+                setGMSpec(*gmSpec);
+                babelwires::logDebug() << ((*gmSpec == GMSpecType::Value::GM2) ? "General MIDI 2 On"
+                                                                               : "General MIDI On");
             } else if (subId2 == 0x02) {
                 // General MIDI Off
                 babelwires::logDebug() << "General MIDI Off";
-            } else if (subId2 == 0x03) {
-                // General MIDI 2 On
-                setGMSpec(GMSpecType::Value::GM2);
-                babelwires::logDebug() << "General MIDI 2 On";
             } else {
                 babelwires::logDebug() << "Ignoring unrecognized General MIDI SysEx message";
             }
             if (m_messageBuffer[4] != 0xF7) {
-                m_userLogger.logWarning() << "Improperly terminated General MIDI SysEx message";
+                logWarning() << "Improperly terminated General MIDI SysEx message";
             }
             return {};
         }
@@ -379,7 +484,7 @@ babelwires::Result smf::SmfParser::readSysExEvent() {
         // Roland SysEx
         const unsigned int messageSize = m_messageBuffer.size();
         if (m_messageBuffer[messageSize - 1] != 0xF7) {
-            m_userLogger.logWarning() << "Improperly terminated Roland SysEx message";
+            logWarning() << "Improperly terminated Roland SysEx message";
         }
         // Checksum
         babelwires::Byte checkSum = 0;
@@ -388,11 +493,10 @@ babelwires::Result smf::SmfParser::readSysExEvent() {
             checkSum += m_messageBuffer[i];
         }
         if (m_messageBuffer[messageSize - 2] != ((0x80 - (checkSum % 0x80)) % 0x80)) {
-            m_userLogger.logWarning() << "Ignoring Roland SysEx message with invalid checksum";
+            logWarning() << "Ignoring Roland SysEx message with invalid checksum";
             return {};
         }
-        if (isMessageBufferMessage(
-                std::array<std::int16_t, 10>{0x41, -1, 0x42, 0x12, 0x40, 0x00, 0x7F, 0x00, 0x41, 0xF7})) {
+        if (getGMSpecFromSysEx(m_messageBuffer) == GMSpecType::Value::GS) {
             setGMSpec(GMSpecType::Value::GS);
             babelwires::logDebug() << "Roland GS Reset";
             return {};
@@ -403,7 +507,7 @@ babelwires::Result smf::SmfParser::readSysExEvent() {
             const babelwires::Byte blockNumber = m_messageBuffer[5] & 0x0f;
             const babelwires::Byte value = m_messageBuffer[7];
             if (value > 2) {
-                m_userLogger.logWarning()
+                logWarning()
                     << "Ignoring Roland SysEx use for rhythm part message with out of range value";
             } else {
                 setGsPartMode(blockNumber, value);
@@ -412,7 +516,7 @@ babelwires::Result smf::SmfParser::readSysExEvent() {
         }
     } else if (headerId == 0x43) {
         // Yamaha SysEx
-        if (isMessageBufferMessage(std::array<std::int16_t, 8>{0x43, -1, 0x4C, 0x00, 0x00, 0x7E, 0x00, 0xF7})) {
+        if (getGMSpecFromSysEx(m_messageBuffer) == GMSpecType::Value::XG) {
             setGMSpec(GMSpecType::Value::XG);
             babelwires::logDebug() << "Yamaha XG Reset";
             return {};
@@ -431,7 +535,7 @@ babelwires::Result smf::SmfParser::readSysExEventContinuation() {
 babelwires::Result smf::SmfParser::readSequencerSpecificEvent(int length) {
     if (length <= 1) {
         DO_OR_ERROR(logByteSequence(
-            m_userLogger.logWarning() << "Skipping sequencer specific event with invalid length: ", length));
+            logWarning() << "Skipping sequencer specific event with invalid length: ", length));
         return {};
     }
     assert(length <= 255 && "Length was expected to be held in one byte");
@@ -530,6 +634,12 @@ babelwires::Result smf::SmfParser::readSequencerSpecificEvent(int length) {
 babelwires::Result smf::SmfParser::readControlChange(unsigned int channelNumber) {
     ASSIGN_OR_ERROR(const babelwires::Byte controllerNumber, getNext());
     ASSIGN_OR_ERROR(const babelwires::Byte value, getNext());
+    onControlChange(channelNumber, controllerNumber, value);
+    return {};
+}
+
+void smf::SmfParser::onControlChange(unsigned int channelNumber, babelwires::Byte controllerNumber,
+                                     babelwires::Byte value) {
     switch (controllerNumber) {
         case 0x00:
             // bank select MSB
@@ -542,7 +652,6 @@ babelwires::Result smf::SmfParser::readControlChange(unsigned int channelNumber)
         default:
             break;
     }
-    return {};
 }
 
 babelwires::Result smf::SmfParser::readProgramChange(unsigned int channelNumber) {
@@ -554,38 +663,110 @@ babelwires::Result smf::SmfParser::readProgramChange(unsigned int channelNumber)
 babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& tracks, bool hasMainMetadata) {
     DO_OR_ERROR(readByteSequence("MTrk"));
     ASSIGN_OR_ERROR(const std::uint32_t trackLength, readU32());
-    const int currentIndex = m_dataSource.getAbsolutePosition();
+    DO_OR_ERROR(readTrackData(trackLength));
+    m_isReadingTrackData = true;
+    const babelwires::Result result = readTrackEvents(trackIndex, tracks, hasMainMetadata);
+    m_isReadingTrackData = false;
+    return result;
+}
+
+babelwires::Result smf::SmfParser::readTrackData(std::uint32_t trackLength) {
+    const int trackDataOffset = getPosition();
+    if (!m_dataSource) {
+        // No copy is needed.
+        if (m_bytes.size() - m_bytesPosition < trackLength) {
+            return babelwires::Error() << "Stream is truncated: The MIDI track at offset " << trackDataOffset
+                                       << " has length " << trackLength << " but only "
+                                       << (m_bytes.size() - m_bytesPosition) << " bytes remain";
+        }
+        m_trackReader = SmfTrackReader(m_bytes.subspan(m_bytesPosition, trackLength), trackDataOffset);
+        m_bytesPosition += trackLength;
+        return {};
+    }
+    m_trackDataBuffer.clear();
+    // Don't trust the length too much before the data has been seen.
+    m_trackDataBuffer.reserve(std::min<std::uint32_t>(trackLength, 1 << 20));
+    for (std::uint32_t i = 0; i < trackLength; ++i) {
+        ASSIGN_OR_ERROR(const babelwires::Byte b, getNext());
+        m_trackDataBuffer.emplace_back(b);
+    }
+    m_trackReader = SmfTrackReader(m_trackDataBuffer, trackDataOffset);
+    return {};
+}
+
+bool smf::SmfParser::tryReadChannelMessage(TrackSplitter& tracks, std::uint64_t& ticksSinceLastNoteEvent,
+                                           babelwires::Byte& lastStatusByte) {
+    const std::optional<SmfTrackReader::ChannelMessage> message = m_trackReader.tryReadChannelMessage(lastStatusByte);
+    if (!message) {
+        return false;
+    }
+    ticksSinceLastNoteEvent += message->m_deltaTicks;
+
+    const babelwires::Byte statusByte = message->m_statusByte;
+    const babelwires::Byte statusHi = statusByte >> 4;
+    const babelwires::Byte statusLo = statusByte & 0xf;
+    const babelwires::Byte data0 = message->m_data0;
+    const babelwires::Byte data1 = message->m_data1;
+
+    switch (statusHi) {
+        case 0b1000: // Note off.
+        case 0b1001: // Note on.
+            if (m_trackPass != TrackPass::Setup) {
+                addNoteEvent(tracks, statusByte, data0, data1, ticksSinceLastNoteEvent);
+            }
+            break;
+        case 0b1011: // Control change.
+            if (m_trackPass == TrackPass::Events) {
+                applyChannelSetupChanges();
+            } else {
+                const PercussionKits kitsBeforeMessage = getPercussionKits();
+                onControlChange(statusLo, data0, data1);
+                recordChannelSetupChange(kitsBeforeMessage);
+            }
+            break;
+        case 0b1100: // Program change
+            if (m_trackPass == TrackPass::Events) {
+                applyChannelSetupChanges();
+            } else {
+                const PercussionKits kitsBeforeMessage = getPercussionKits();
+                setProgram(statusLo, data0);
+                recordChannelSetupChange(kitsBeforeMessage);
+            }
+            break;
+        default:
+            // Aftertouch, channel pressure and pitch wheel are ignored.
+            break;
+    }
+    return true;
+}
 
-    bw_music::ModelDuration timeSinceLastNoteEvent = 0;
+void smf::SmfParser::addNoteEvent(TrackSplitter& tracks, babelwires::Byte statusByte, bw_music::Pitch pitch,
+                                  bw_music::Velocity velocity, std::uint64_t& ticksSinceLastNoteEvent) {
+    const unsigned int channelNumber = statusByte & 0xf;
+    // A note on with zero velocity is a note off.
+    const bool isNoteOn = ((statusByte >> 4) == 0b1001) && (velocity != 0);
+    // TODO If a NoteOn was skipped, we would need to skip the corresponding note off.
+    const bool wasAdded = isNoteOn ? tracks.addNoteOn(channelNumber, ticksSinceLastNoteEvent, pitch, velocity)
+                                   : tracks.addNoteOff(channelNumber, ticksSinceLastNoteEvent, pitch, velocity);
+    if (wasAdded) {
+        ticksSinceLastNoteEvent = 0;
+    }
+}
+
+babelwires::Result smf::SmfParser::readTrackEvents(int trackIndex, TrackSplitter& tracks, bool hasMainMetadata) {
+    std::uint64_t ticksSinceLastNoteEvent = 0;
     babelwires::Byte lastStatusByte = 0;
-    while ((m_dataSource.getAbsolutePosition() - currentIndex) < trackLength) {
+    while (!m_trackReader.isAtEnd()) {
+        if (tryReadChannelMessage(tracks, ticksSinceLastNoteEvent, lastStatusByte)) {
+            continue;
+        }
         {
-            ASSIGN_OR_ERROR(const auto duration, readModelDuration());
-            timeSinceLastNoteEvent += duration;
-        }
-
-        // Peek in case running status should be used.
-        ASSIGN_OR_ERROR(babelwires::Byte statusByte, peekNext());
-        if ((statusByte & 0x80) || (lastStatusByte == 0)) {
-            // A new status byte, so consume the status byte.
-            DO_OR_ERROR(getNext());
-
-            // Buffer stores the status when a Voice Category Status (ie, 0x80 to 0xEF) is received.
-            // Buffer is cleared when a System Common Category Status (ie, 0xF0 to 0xF7) is received.
-            // Nothing is done to the buffer when a RealTime Category message is received.
-
-            if ((statusByte >= 0x80) && (statusByte <= 0xEF)) {
-                // Voice category status
-                lastStatusByte = statusByte;
-            } else if ((statusByte >= 0xF0) && (statusByte <= 0xF7)) {
-                // System common category status
-                lastStatusByte = 0;
-            }
-        } else {
-            // Running status.
-            statusByte = lastStatusByte;
+            ASSIGN_OR_ERROR(const std::uint32_t numTicks, readVariableLengthQuantity());
+            ticksSinceLastNoteEvent += numTicks;
         }
 
+        ASSIGN_OR_ERROR(const babelwires::Byte statusByte, m_trackReader.readStatusByte(lastStatusByte));
+
         const babelwires::Byte statusHi = statusByte >> 4;
         const babelwires::Byte statusLo = statusByte & 0xf;
 
@@ -595,20 +776,32 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
 
         switch (statusHi) {
             case 0b1111: {
-                if (statusLo == 0x00) {
+                if (((statusLo == 0x00) || (statusLo == 0x07)) && (m_trackPass == TrackPass::Events)) {
+                    // SysEx messages were handled by the Setup pass.
+                    ASSIGN_OR_ERROR(const std::uint32_t length, readVariableLengthQuantity());
+                    DO_OR_ERROR(skipBytes(length));
+                    applyChannelSetupChanges();
+                } else if (statusLo == 0x00) {
+                    const PercussionKits kitsBeforeMessage = getPercussionKits();
                     DO_OR_ERROR(readSysExEvent());
+                    recordChannelSetupChange(kitsBeforeMessage);
                 } else if (statusLo == 0x07) {
                     DO_OR_ERROR(readSysExEventContinuation());
                 } else if (statusLo == 0x0f) {
                     // Meta-event.
                     ASSIGN_OR_ERROR(const babelwires::Byte type, getNext());
                     ASSIGN_OR_ERROR(const std::uint32_t length, readVariableLengthQuantity());
+                    if ((m_trackPass == TrackPass::Setup) && (type != 0x2F)) {
+                        // Meta-events are handled by the Events pass.
+                        DO_OR_ERROR(skipBytes(length));
+                        break;
+                    }
                     switch (type) {
                         case 0x00: // Sequence number
                         {
                             if (length != 2) {
                                 DO_OR_ERROR(logByteSequence(
-                                    m_userLogger.logWarning()
+                                    logWarning()
                                         << "Skipping sequence number meta-event with incorrect length: ",
                                     length));
                             } else {
@@ -667,7 +860,7 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
                         {
                             if (length != 1) {
                                 DO_OR_ERROR(
-                                    logByteSequence(m_userLogger.logWarning()
+                                    logByteSequence(logWarning()
                                                         << "Skipping channel prefix meta-event with incorrect length",
                                                     length));
                             } else {
@@ -679,24 +872,25 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
                         case 0x2F: // End of track.
                         {
                             // Finished.
-                            if ((m_dataSource.getAbsolutePosition() - currentIndex) != trackLength) {
-                                return babelwires::Error()
-                                       << "MIDI track " << trackIndex << " had an unexpected end-of-track event";
+                            if (!m_trackReader.isAtEnd()) {
+                                return babelwires::Error() << "MIDI track " << trackIndex
+                                                           << " had an unexpected end-of-track event at offset "
+                                                           << getPosition();
                             }
-                            if (length != 0) {
+                            if ((length != 0) && (m_trackPass != TrackPass::Setup)) {
                                 // Not a good idea to skip end of track events.
                                 DO_OR_ERROR(logByteSequence(
-                                    m_userLogger.logWarning()
+                                    logWarning()
                                         << "End of Track meta-event has incorrect length. Will try use it anyway.",
                                     length));
                             }
-                            tracks.setDurationsForAllChannels(timeSinceLastNoteEvent);
+                            tracks.setDurationsForAllChannels(ticksSinceLastNoteEvent);
                             return {};
                         }
                         case 0x51: // Set tempo
                         {
                             if (length != 3) {
-                                DO_OR_ERROR(logByteSequence(m_userLogger.logWarning()
+                                DO_OR_ERROR(logByteSequence(logWarning()
                                                                 << "Skipping Tempo meta-event with incorrect length",
                                                             length));
                             } else {
@@ -711,7 +905,7 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
                         {
                             if (length != 5) {
                                 DO_OR_ERROR(
-                                    logByteSequence(m_userLogger.logWarning()
+                                    logByteSequence(logWarning()
                                                         << "Skipping SMPTE Offset meta-event with incorrect length",
                                                     length));
                             } else {
@@ -724,7 +918,7 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
                         {
                             if (length != 4) {
                                 DO_OR_ERROR(
-                                    logByteSequence(m_userLogger.logWarning()
+                                    logByteSequence(logWarning()
                                                         << "Skipping Time Signature meta-event with incorrect length",
                                                     length));
                             } else {
@@ -736,7 +930,7 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
                         case 0x59: // Key signature
                         {
                             if (length != 2) {
-                                DO_OR_ERROR(logByteSequence(m_userLogger.logWarning()
+                                DO_OR_ERROR(logByteSequence(logWarning()
                                                                 << "Skipping Key Signature event with incorrect length",
                                                             length));
                             } else {
@@ -753,7 +947,7 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
                         default: // Unknown meta-event type
                         {
                             // This isn't in the spec, so warn: Perhaps BabelWires-Music is out-of-date.
-                            DO_OR_ERROR(logByteSequence(m_userLogger.logWarning()
+                            DO_OR_ERROR(logByteSequence(logWarning()
                                                             << "Skipping unknown meta-event of type " << std::hex
                                                             << (int)type << ": ",
                                                         length));
@@ -761,33 +955,18 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
                         }
                     }
                 } else {
-                    return babelwires::Error()
-                           << "Unrecognized MIDI message with status byte " << static_cast<int>(statusByte);
+                    return babelwires::Error() << "Unrecognized MIDI message with status byte "
+                                               << static_cast<int>(statusByte) << " at offset " << getPosition();
                 }
                 break;
             }
             case 0b1000: // Note off.
-            {
-                ASSIGN_OR_ERROR(const bw_music::Pitch pitch, getNext());
-                ASSIGN_OR_ERROR(const bw_music::Velocity velocity, getNext());
-                // TODO If a NoteOn was skipped, we would need to skip the corresponding note off.
-                if (tracks.addNoteOff(statusLo, timeSinceLastNoteEvent, pitch, velocity)) {
-                    timeSinceLastNoteEvent = 0;
-                }
-                break;
-            }
             case 0b1001: // Note on.
             {
                 ASSIGN_OR_ERROR(const bw_music::Pitch pitch, getNext());
                 ASSIGN_OR_ERROR(const bw_music::Velocity velocity, getNext());
-                if (velocity != 0) {
-                    if (tracks.addNoteOn(statusLo, timeSinceLastNoteEvent, pitch, velocity)) {
-                        timeSinceLastNoteEvent = 0;
-                    }
-                } else {
-                    if (tracks.addNoteOff(statusLo, timeSinceLastNoteEvent, pitch, velocity)) {
-                        timeSinceLastNoteEvent = 0;
-                    }
+                if (m_trackPass != TrackPass::Setup) {
+                    addNoteEvent(tracks, statusByte, pitch, velocity, ticksSinceLastNoteEvent);
                 }
                 break;
             }
@@ -798,7 +977,14 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
             }
             case 0b1011: // Control change.
             {
-                DO_OR_ERROR(readControlChange(statusLo));
+                if (m_trackPass == TrackPass::Events) {
+                    DO_OR_ERROR(skipBytes(2));
+                    applyChannelSetupChanges();
+                } else {
+                    const PercussionKits kitsBeforeMessage = getPercussionKits();
+                    DO_OR_ERROR(readControlChange(statusLo));
+                    recordChannelSetupChange(kitsBeforeMessage);
+                }
                 break;
             }
             case 0b1110: // Pitch wheel
@@ -808,7 +994,14 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
             }
             case 0b1100: // Program change
             {
-                DO_OR_ERROR(readProgramChange(statusLo));
+                if (m_trackPass == TrackPass::Events) {
+                    DO_OR_ERROR(skipBytes(1));
+                    applyChannelSetupChanges();
+                } else {
+                    const PercussionKits kitsBeforeMessage = getPercussionKits();
+                    DO_OR_ERROR(readProgramChange(statusLo));
+                    recordChannelSetupChange(kitsBeforeMessage);
+                }
                 break;
             }
             case 0b1101: // Channel pressure
@@ -817,8 +1010,8 @@ babelwires::Result smf::SmfParser::readTrack(int trackIndex, TrackSplitter& trac
                 break;
             }
             default: {
-                return babelwires::Error()
-                       << "Unrecognized MIDI message with status byte " << static_cast<int>(statusByte);
+                return babelwires::Error() << "Unrecognized MIDI message with status byte "
+                                           << static_cast<int>(statusByte) << " at offset " << getPosition();
             }
         }
     }
@@ -832,58 +1025,235 @@ babelwires::Result smf::SmfParser::readFormat0Sequence() {
         return babelwires::Error() << "A format 0 Standard MIDI file claims to have " << m_numTracks
                                    << " tracks but it should only have 1";
     }
-    TrackSplitter splitTracks(m_channelSetup);
+    if (m_deferredBytesOwner) {
+        return readSequenceDeferred();
+    }
+    TrackSplitter splitTracks(m_channelSetup, m_division);
     DO_OR_ERROR(readTrack(0, splitTracks, true));
-    auto tracks = getSmfSequence().getTrcks0();
+    setFormat0SequenceTracks(finishChannelTracks(splitTracks));
+    return {};
+}
+
+void smf::SmfParser::setFormat0SequenceTracks(ChannelTracks tracks) {
+    auto trcks0 = getSmfSequence().getTrcks0();
     for (int channelNumber = 0; channelNumber < MAX_CHANNELS; ++channelNumber) {
-        const auto& perChannelInfoPtr = splitTracks.m_channels[channelNumber];
-        if (perChannelInfoPtr != nullptr) {
-            tracks.activateAndGetTrack(channelNumber)
-                .set(perChannelInfoPtr->m_track.finishAndGetTrack(perChannelInfoPtr->m_trackDuration));
+        if (tracks.m_tracks[channelNumber]) {
+            trcks0.activateAndGetTrack(channelNumber).set(std::move(*tracks.m_tracks[channelNumber]));
         }
     }
-    return {};
 }
 
-babelwires::Result smf::SmfParser::readFormat1SequenceTrack(MidiTrackAndChannel::Instance& track,
-                                                            bool hasMainMetadata) {
-    TrackSplitter splitTrack(m_channelSetup);
-    DO_OR_ERROR(readTrack(0, splitTrack, hasMainMetadata));
-
-    // Convert the builders to actual tracks.
-    std::array<bw_music::Track, 16> tracks;
+smf::SmfParser::ChannelTracks smf::SmfParser::finishChannelTracks(TrackSplitter& splitTrack) const {
+    ChannelTracks tracks;
+    for (int channelNumber = 0; channelNumber < MAX_CHANNELS; ++channelNumber) {
+        const auto& perChannelInfoPtr = splitTrack.m_channels[channelNumber];
+        if (perChannelInfoPtr != nullptr) {
+            tracks.m_numEvents[channelNumber] = perChannelInfoPtr->m_numEventsAdded;
+            if (splitTrack.m_channelsToBuild[channelNumber]) {
+                // In format 0 files, all channels share the duration of the MIDI track.
+                bw_music::TrackBuilder& trackBuilder = perChannelInfoPtr->m_track;
+                tracks.m_tracks[channelNumber] =
+                    (m_sequenceType == Format::SMF_FORMAT_0)
+                        ? trackBuilder.finishAndGetTrack(perChannelInfoPtr->m_trackDuration)
+                        : trackBuilder.finishAndGetTrack();
+            }
+        }
+    }
+    return tracks;
+}
 
+void smf::SmfParser::setFormat1SequenceTrack(MidiTrackAndChannel::Instance& track, ChannelTracks tracks) {
     // If this is a format 1 track with multiple channels (rare but possible), privilege the
-    // channel with the most events.
+    // channel with the most events. The events are counted as they are parsed, so deferred tracks need not be built.
     int privilegedTrack = -1;
     int maxNumEvents = 0;
     for (int channelNumber = 0; channelNumber < MAX_CHANNELS; ++channelNumber) {
-        if (splitTrack.m_channels[channelNumber] != nullptr) {
-            tracks[channelNumber] = splitTrack.m_channels[channelNumber]->m_track.finishAndGetTrack();
-            if (tracks[channelNumber].getNumEvents() > maxNumEvents) {
-                privilegedTrack = channelNumber;
-                maxNumEvents = tracks[channelNumber].getNumEvents();
-            }
+        if (tracks.m_tracks[channelNumber] && (tracks.m_numEvents[channelNumber] > maxNumEvents)) {
+            privilegedTrack = channelNumber;
+            maxNumEvents = tracks.m_numEvents[channelNumber];
         }
     }
     for (int channelNumber = 0; channelNumber < MAX_CHANNELS; ++channelNumber) {
         if (channelNumber == privilegedTrack) {
             track.getChan().set(channelNumber);
-            track.getTrack().set(std::move(tracks[channelNumber]));
-        } else if (splitTrack.m_channels[channelNumber] != nullptr) {
+            track.getTrack().set(std::move(*tracks.m_tracks[channelNumber]));
+        } else if (tracks.m_tracks[channelNumber]) {
             // All other tracks are added as extra.
-            track.activateAndGetTrack(channelNumber).set(std::move(tracks[channelNumber]));
+            track.activateAndGetTrack(channelNumber).set(std::move(*tracks.m_tracks[channelNumber]));
         }
     }
+}
+
+babelwires::Result smf::SmfParser::readFormat1SequenceTrack(int trackIndex, MidiTrackAndChannel::Instance& track,
+                                                            bool hasMainMetadata) {
+    TrackSplitter splitTrack(m_channelSetup, m_division);
+    DO_OR_ERROR(readTrack(trackIndex, splitTrack, hasMainMetadata));
+    setFormat1SequenceTrack(track, finishChannelTracks(splitTrack));
     return {};
 }
 
 babelwires::Result smf::SmfParser::readFormat1Sequence() {
+    if (m_deferredBytesOwner) {
+        return readSequenceDeferred();
+    }
+    unsigned int maxNumThreads = m_maxNumThreads;
+    if (maxNumThreads == 0) {
+        // The size of a data source is not known in advance, so it is only parsed concurrently on request.
+        const bool isLargeFile = !m_dataSource && (m_bytes.size() >= c_minBytesForConcurrentParsing);
+        maxNumThreads = isLargeFile ? std::max(std::thread::hardware_concurrency(), 1u) : 1;
+    }
+    const unsigned int numThreads = std::min<unsigned int>(std::max(m_numTracks, 1), maxNumThreads);
+    if (numThreads > 1) {
+        return readFormat1SequenceConcurrently(numThreads);
+    }
+    auto tracks = getSmfSequence().getTrcks1();
+    tracks.setSize(m_numTracks);
+    for (int i = 0; i < m_numTracks; ++i) {
+        auto track = tracks.getEntry(i);
+        DO_OR_ERROR(readFormat1SequenceTrack(i, track, (i == 0)));
+    }
+    return {};
+}
+
+babelwires::Result smf::SmfParser::readFormat1SequenceConcurrently(unsigned int numThreads) {
+    // Phase one: Locate the chunks and follow the setup of the channels through them in order, since a track can
+    // change the percussion kits used by later tracks.
+    DO_OR_ERROR(locateTrackChunks());
+    const std::vector<TrackChunk>& chunks = m_trackChunks;
+
+    // Phase two: Parse the events of each chunk independently. Only this parser can write the main metadata, so it
+    // parses the first track itself. The other tracks are parsed by worker parsers, which buffer their warnings so
+    // they can be logged in track order afterwards.
+    std::vector<std::optional<babelwires::ResultT<ChannelTracks>>> results(m_numTracks);
+    std::vector<std::vector<std::string>> warnings(m_numTracks);
+    bw_music::runConcurrently(
+        m_numTracks,
+        [&](std::size_t i) {
+            if (i == 0) {
+                results[0] = readTrackChunkEvents(0, chunks[0], true);
+            } else {
+                SmfParser workerParser(m_projectContext, m_userLogger, m_division, m_gmSpec,
+                                       m_standardPercussionSets);
+                workerParser.m_bufferedWarnings = &warnings[i];
+                results[i] = workerParser.readTrackChunkEvents(i, chunks[i], false);
+            }
+        },
+        numThreads);
+
     auto tracks = getSmfSequence().getTrcks1();
     tracks.setSize(m_numTracks);
     for (int i = 0; i < m_numTracks; ++i) {
+        for (const std::string& warning : warnings[i]) {
+            m_userLogger.logWarning() << warning;
+        }
+        ASSIGN_OR_ERROR(ChannelTracks channelTracks, std::move(*results[i]));
         auto track = tracks.getEntry(i);
-        DO_OR_ERROR(readFormat1SequenceTrack(track, (i == 0)));
+        setFormat1SequenceTrack(track, std::move(channelTracks));
+    }
+    return {};
+}
+
+babelwires::Result smf::SmfParser::locateTrackChunks() {
+    m_trackChunks.clear();
+    m_trackChunks.resize(m_numTracks);
+    m_trackPass = TrackPass::Setup;
+    for (int i = 0; i < m_numTracks; ++i) {
+        TrackChunk& chunk = m_trackChunks[i];
+        chunk.m_channelSetupAtStart = m_channelSetup;
+        m_chunkBeingScanned = &chunk;
+        TrackSplitter unusedTracks(m_channelSetup, m_division);
+        DO_OR_ERROR(readTrack(i, unusedTracks));
+        if (m_dataSource) {
+            chunk.m_ownedBytes = std::move(m_trackDataBuffer);
+            chunk.m_bytes = chunk.m_ownedBytes;
+        } else {
+            chunk.m_bytes = m_trackReader.getTrackData();
+        }
+        chunk.m_offset = static_cast<int>(m_trackReader.getOffset());
+    }
+    m_chunkBeingScanned = nullptr;
+    return {};
+}
+
+babelwires::ResultT<smf::SmfParser::ChannelTracks>
+smf::SmfParser::readTrackChunkEvents(int trackIndex, const TrackChunk& chunk, bool hasMainMetadata,
+                                     std::bitset<16> channelsToBuild) {
+    m_trackPass = TrackPass::Events;
+    m_channelSetup = chunk.m_channelSetupAtStart;
+    m_channelSetupChangesToApply = &chunk.m_channelSetupChanges;
+    m_nextChannelSetupChange = 0;
+    m_trackReader = SmfTrackReader(chunk.m_bytes, chunk.m_offset);
+
+    TrackSplitter splitTrack(m_channelSetup, m_division, channelsToBuild);
+    m_isReadingTrackData = true;
+    const babelwires::Result result = readTrackEvents(trackIndex, splitTrack, hasMainMetadata);
+    m_isReadingTrackData = false;
+    m_channelSetupChangesToApply = nullptr;
+    DO_OR_ERROR(result);
+    return finishChannelTracks(splitTrack);
+}
+
+/// What a deferred track needs to parse its channel from the file after the parser has gone.
+struct smf::SmfParser::DeferredTrackSource {
+    const babelwires::Context& m_context;
+    babelwires::UserLogger& m_userLogger;
+    /// Keeps the bytes which the chunks refer to alive.
+    std::shared_ptr<const void> m_bytesOwner;
+    std::vector<TrackChunk> m_trackChunks;
+    std::shared_ptr<StandardPercussionSets> m_standardPercussionSets;
+    int m_division;
+    GMSpecType::Value m_gmSpec;
+    Format m_sequenceType;
+
+    bw_music::Track loadTrack(int trackIndex, unsigned int channelNumber) const {
+        SmfParser parser(m_context, m_userLogger, m_division, m_gmSpec, m_standardPercussionSets);
+        parser.m_sequenceType = m_sequenceType;
+        // The warnings were logged when the file was loaded.
+        std::vector<std::string> warnings;
+        parser.m_bufferedWarnings = &warnings;
+        std::bitset<MAX_CHANNELS> channelsToBuild;
+        channelsToBuild.set(channelNumber);
+        auto result = parser.readTrackChunkEvents(trackIndex, m_trackChunks[trackIndex], false, channelsToBuild);
+        assert(result && "The chunk was parsed without error when the file was loaded");
+        assert(result->m_tracks[channelNumber] && "The channel had events when the file was loaded");
+        if (!result || !result->m_tracks[channelNumber]) {
+            return {};
+        }
+        return std::move(*result->m_tracks[channelNumber]);
+    }
+};
+
+babelwires::Result smf::SmfParser::readSequenceDeferred() {
+    DO_OR_ERROR(locateTrackChunks());
+
+    // Read the events of every chunk to log warnings, set the metadata and find which channels have events, but do
+    // not build any tracks.
+    std::vector<ChannelTracks> channelTracks(m_numTracks);
+    for (int i = 0; i < m_numTracks; ++i) {
+        ASSIGN_OR_ERROR(channelTracks[i], readTrackChunkEvents(i, m_trackChunks[i], (i == 0), {}));
+    }
+
+    auto source = std::make_shared<const DeferredTrackSource>(
+        DeferredTrackSource{m_projectContext, m_userLogger, std::move(m_deferredBytesOwner), std::move(m_trackChunks),
+                            m_standardPercussionSets, m_division, m_gmSpec, m_sequenceType});
+    for (int i = 0; i < m_numTracks; ++i) {
+        for (unsigned int channelNumber = 0; channelNumber < MAX_CHANNELS; ++channelNumber) {
+            if (channelTracks[i].m_numEvents[channelNumber] > 0) {
+                channelTracks[i].m_tracks[channelNumber] = bw_music::Track::createDeferred(
+                    [source, i, channelNumber]() { return source->loadTrack(i, channelNumber); });
+            }
+        }
+    }
+
+    if (m_sequenceType == Format::SMF_FORMAT_0) {
+        setFormat0SequenceTracks(std::move(channelTracks[0]));
+    } else {
+        auto tracks = getSmfSequence().getTrcks1();
+        tracks.setSize(m_numTracks);
+        for (int i = 0; i < m_numTracks; ++i) {
+            auto track = tracks.getEntry(i);
+            setFormat1SequenceTrack(track, std::move(channelTracks[i]));
+        }
     }
     return {};
 }
@@ -894,8 +1264,9 @@ smf::MidiMetadata::Instance smf::SmfParser::getMidiMetadata() {
 
 void smf::SmfParser::setGMSpec(GMSpecType::Value gmSpec) {
     for (int i = 0; i < 16; ++i) {
-        m_channelSetup[i].m_kitIfPercussion = m_standardPercussionSets.getDefaultPercussionSet(gmSpec, i);
+        m_channelSetup[i].m_kitIfPercussion = m_standardPercussionSets->getDefaultPercussionSet(gmSpec, i);
     }
+    m_gmSpec = gmSpec;
     getMidiMetadata().getSpec().set(gmSpec);
 }
 
@@ -925,9 +1296,32 @@ void smf::SmfParser::setGsPartMode(unsigned int blockNumber, babelwires::Byte va
 /// Right now, just trying to determine which percussionSet is in use if any.
 void smf::SmfParser::onChangeProgram(unsigned int channelNumber) {
     ChannelSetup& channelSetup = m_channelSetup[channelNumber];
-    const GMSpecType::Value gmSpec = getMidiMetadata().getSpec().get();
     channelSetup.m_kitIfPercussion =
-        m_standardPercussionSets.getPercussionSetFromChannelSetupInfo(gmSpec, channelSetup.m_channelSetupInfo);
+        m_standardPercussionSets->getPercussionSetFromChannelSetupInfo(m_gmSpec, channelSetup.m_channelSetupInfo);
+}
+
+smf::SmfParser::PercussionKits smf::SmfParser::getPercussionKits() const {
+    PercussionKits kits;
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        kits[i] = m_channelSetup[i].m_kitIfPercussion;
+    }
+    return kits;
+}
+
+void smf::SmfParser::recordChannelSetupChange(const PercussionKits& kitsBeforeMessage) {
+    if ((m_trackPass == TrackPass::Setup) && (getPercussionKits() != kitsBeforeMessage)) {
+        m_chunkBeingScanned->m_channelSetupChanges.emplace_back(
+            ChannelSetupChange{m_trackReader.getPositionInTrack(), m_channelSetup});
+    }
+}
+
+void smf::SmfParser::applyChannelSetupChanges() {
+    const std::vector<ChannelSetupChange>& changes = *m_channelSetupChangesToApply;
+    while ((m_nextChannelSetupChange < changes.size()) &&
+           (changes[m_nextChannelSetupChange].m_positionInTrack <= m_trackReader.getPositionInTrack())) {
+        m_channelSetup = changes[m_nextChannelSetupChange].m_channelSetup;
+        ++m_nextChannelSetupChange;
+    }
 }
 
 babelwires::ResultT<std::unique_ptr<babelwires::ValueTreeRoot>>
@@ -937,3 +1331,20 @@ smf::parseSmfSequence(babelwires::DataSource& dataSource, const babelwires::Cont
     DO_OR_ERROR(parser.parse());
     return parser.getResult();
 }
+
+babelwires::ResultT<std::unique_ptr<babelwires::ValueTreeRoot>>
+smf::parseSmfSequence(std::span<const babelwires::Byte> bytes, const babelwires::Context& context,
+                      babelwires::UserLogger& userLogger) {
+    SmfParser parser(bytes, context, userLogger);
+    DO_OR_ERROR(parser.parse());
+    return parser.getResult();
+}
+
+babelwires::ResultT<std::unique_ptr<babelwires::ValueTreeRoot>>
+smf::parseSmfSequenceDeferred(std::span<const babelwires::Byte> bytes, std::shared_ptr<const void> bytesOwner,
+                              const babelwires::Context& context, babelwires::UserLogger& userLogger) {
+    SmfParser parser(bytes, context, userLogger);
+    parser.setDeferTracks(std::move(bytesOwner));
+    DO_OR_ERROR(parser.parse());
+    return parser.getResult();
+}
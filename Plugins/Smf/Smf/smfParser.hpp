@@ -10,16 +10,22 @@
 #include <Smf/gmSpec.hpp>
 #include <Smf/Percussion/standardPercussionSets.hpp>
 #include <Smf/smfSequence.hpp>
+#include <Smf/smfTrackReader.hpp>
 
 #include <MusicLib/musicTypes.hpp>
+#include <MusicLib/Types/Track/track.hpp>
 
 #include <BaseLib/IO/dataSource.hpp>
 #include <BaseLib/Log/userLogger.hpp>
 #include <BaseLib/Result/result.hpp>
 
+#include <bitset>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <sstream>
+#include <string>
 #include <vector>
 
 namespace bw_music {
@@ -32,18 +38,42 @@ namespace smf {
       public:
         SmfParser(babelwires::DataSource& dataSource, const babelwires::Context& context,
                   babelwires::UserLogger& log);
+        /// Parse the bytes of a file which are already in memory, without copying them.
+        SmfParser(std::span<const babelwires::Byte> bytes, const babelwires::Context& context,
+                  babelwires::UserLogger& log);
         virtual ~SmfParser();
 
         babelwires::Result parse();
         std::unique_ptr<babelwires::ValueTreeRoot> getResult() { return std::move(m_result); }
 
+        /// Limit the number of threads used to parse the tracks of format 1 files.
+        /// By default (0), the hardware concurrency is used for large files in memory, and other files are parsed in
+        /// a single pass. With 1, tracks are always parsed in a single pass.
+        void setMaxNumThreads(unsigned int maxNumThreads);
+
+        /// Only index the tracks while parsing, and build the track of each channel when it is first used.
+        /// The bytes must be in memory, and bytesOwner must keep them alive and unchanged. The deferred tracks share
+        /// ownership of it, and the context must outlive them.
+        void setDeferTracks(std::shared_ptr<const void> bytesOwner);
+
       protected:
+        SmfParser(babelwires::DataSource* dataSource, std::span<const babelwires::Byte> bytes,
+                  const babelwires::Context& context, babelwires::UserLogger& log);
+
+        /// A parser which only reads the events of track chunks located by another parser, and does not build a
+        /// result. Used to parse tracks on worker threads, which share the other parser's percussion sets.
+        SmfParser(const babelwires::Context& context, babelwires::UserLogger& log, int division,
+                  GMSpecType::Value gmSpec, std::shared_ptr<StandardPercussionSets> standardPercussionSets);
+
         SmfSequence::ConstInstance getSmfSequenceConst() const;
         SmfSequence::Instance getSmfSequence();
 
         babelwires::ResultT<babelwires::Byte> getNext();
         babelwires::ResultT<babelwires::Byte> peekNext();
 
+        /// The absolute position of the next byte to be read.
+        int getPosition() const;
+
         void setGMSpec(GMSpecType::Value spec);
 
         /// Read the expected byte sequence.
@@ -54,15 +84,44 @@ namespace smf {
 
         babelwires::Result readFormat0Sequence();
         babelwires::Result readFormat1Sequence();
-        babelwires::Result readFormat1SequenceTrack(MidiTrackAndChannel::Instance& track, bool hasMainMetadata = false);
+        babelwires::Result readFormat1SequenceTrack(int trackIndex, MidiTrackAndChannel::Instance& track,
+                                                    bool hasMainMetadata = false);
+
+        /// Parse the tracks of a format 1 file in two phases, so most of the work can be done concurrently.
+        babelwires::Result readFormat1SequenceConcurrently(unsigned int numThreads);
+
+        /// The tracks of a MIDI track, by channel.
+        struct ChannelTracks {
+            /// Empty for channels without events and for channels which were not built.
+            std::array<std::optional<bw_music::Track>, 16> m_tracks;
+            /// The number of events parsed on each channel.
+            std::array<int, 16> m_numEvents = {};
+        };
 
         MidiMetadata::Instance getMidiMetadata();
 
         class TrackSplitter;
 
+        ChannelTracks finishChannelTracks(TrackSplitter& splitTrack) const;
+        void setFormat0SequenceTracks(ChannelTracks tracks);
+        void setFormat1SequenceTrack(MidiTrackAndChannel::Instance& track, ChannelTracks tracks);
+
         babelwires::Result readTrack(int trackIndex, TrackSplitter& tracks, bool hasMainMetadata = false);
 
-        babelwires::ResultT<bw_music::ModelDuration> readModelDuration();
+        /// Make m_trackReader read the whole track chunk, so its events can be parsed from memory.
+        babelwires::Result readTrackData(std::uint32_t trackLength);
+
+        /// Parse the events read by m_trackReader.
+        babelwires::Result readTrackEvents(int trackIndex, TrackSplitter& tracks, bool hasMainMetadata);
+
+        /// Read a delta time and channel message using m_trackReader, checking the bounds only once.
+        /// Returns false without consuming anything if there might not be enough data or the message is not a channel
+        /// message, in which case the message should be read by the checked code.
+        bool tryReadChannelMessage(TrackSplitter& tracks, std::uint64_t& ticksSinceLastNoteEvent,
+                                   babelwires::Byte& lastStatusByte);
+
+        void addNoteEvent(TrackSplitter& tracks, babelwires::Byte statusByte, bw_music::Pitch pitch,
+                          bw_music::Velocity velocity, std::uint64_t& ticksSinceLastNoteEvent);
 
         void readTempoEvent(std::uint32_t tempoValue);
 
@@ -70,7 +129,12 @@ namespace smf {
 
         babelwires::Result skipBytes(int numBytes);
 
-        template <typename STREAMLIKE> babelwires::Result logByteSequence(STREAMLIKE log, int length);
+        class WarningStream;
+
+        /// Warnings are logged through this rather than directly, so a worker parser can buffer them.
+        WarningStream logWarning();
+
+        template <typename STREAMLIKE> babelwires::Result logByteSequence(STREAMLIKE&& log, int length);
 
         babelwires::Result readSysExEvent();
         babelwires::Result readSysExEventContinuation();
@@ -88,9 +152,10 @@ namespace smf {
         /// A -1 in the message is allowed to be anything.
         template <std::size_t N> bool isMessageBufferMessage(const std::array<std::int16_t, N>& message) const;
 
-        template <typename STREAMLIKE> void logMessageBuffer(STREAMLIKE log) const;
+        template <typename STREAMLIKE> void logMessageBuffer(STREAMLIKE&& log) const;
 
         babelwires::Result readControlChange(unsigned int channelNumber);
+        void onControlChange(unsigned int channelNumber, babelwires::Byte controllerNumber, babelwires::Byte value);
         babelwires::Result readProgramChange(unsigned int channelNumber);
         void setBankMSB(unsigned int channelNumber, const babelwires::Byte msbValue);
         void setBankLSB(unsigned int channelNumber, const babelwires::Byte lsbValue);
@@ -101,15 +166,36 @@ namespace smf {
         
         void onChangeProgram(unsigned int channelNumber);
 
+        using PercussionKits = std::array<const bw_music::PercussionSetWithPitchMap*, 16>;
+        PercussionKits getPercussionKits() const;
+
+        /// In the Setup pass, record the channel setup if the message just read changed a percussion kit.
+        void recordChannelSetupChange(const PercussionKits& kitsBeforeMessage);
+
+        /// In the Events pass, apply the channel setup changes recorded up to the current position.
+        void applyChannelSetupChanges();
+
         enum KnownPercussionSets { GM_PERCUSSION_KIT, GM2_STANDARD_PERCUSSION_KIT, NUM_KNOWN_PERCUSSION_KITS };
 
       private:
         const babelwires::Context& m_projectContext;
-        babelwires::DataSource& m_dataSource;
+        /// Null when parsing bytes in memory.
+        babelwires::DataSource* m_dataSource;
+        /// The bytes being parsed, when not parsing from a data source.
+        std::span<const babelwires::Byte> m_bytes;
+        /// The position of the next byte to read in m_bytes.
+        std::size_t m_bytesPosition = 0;
         babelwires::UserLogger& m_userLogger;
         std::unique_ptr<babelwires::ValueTreeRoot> m_result;
         std::vector<babelwires::Byte> m_messageBuffer;
 
+        /// Reads the bytes of the track chunk being parsed.
+        SmfTrackReader m_trackReader;
+        /// When parsing from a data source, m_trackReader reads this.
+        std::vector<babelwires::Byte> m_trackDataBuffer;
+        /// True while bytes are read by m_trackReader rather than from the data source.
+        bool m_isReadingTrackData = false;
+
         enum class Format { SMF_FORMAT_0, SMF_FORMAT_1, SMF_FORMAT_2, SMF_UNKNOWN_FORMAT };
             
         Format m_sequenceType;
@@ -117,7 +203,8 @@ namespace smf {
         int m_division;
 
         /// Knowledge of how pitches map to percussion instruments.
-        StandardPercussionSets m_standardPercussionSets;
+        /// This is shared with worker parsers, which only read it.
+        std::shared_ptr<StandardPercussionSets> m_standardPercussionSets;
 
         /// Currently just used to determine which tracks are percussion tracks.
         struct ChannelSetup {
@@ -128,10 +215,82 @@ namespace smf {
         };
 
         std::array<ChannelSetup, 16> m_channelSetup;
+
+        /// The spec most recently set, which determines the default percussion kits.
+        GMSpecType::Value m_gmSpec;
+
+        /// Which messages are handled when reading the events of a track.
+        enum class TrackPass {
+            /// All messages, in a single pass.
+            All,
+            /// Only messages which affect the setup of channels, recording where the percussion kits change.
+            Setup,
+            /// All other messages. The setup of channels is taken from the changes recorded by the Setup pass.
+            Events
+        };
+
+        TrackPass m_trackPass = TrackPass::All;
+
+        /// The setup of the channels after a message which changed a percussion kit.
+        struct ChannelSetupChange {
+            /// The position in the track just after the message.
+            std::size_t m_positionInTrack;
+            std::array<ChannelSetup, 16> m_channelSetup;
+        };
+
+        /// A track chunk, located and scanned by the Setup pass.
+        struct TrackChunk {
+            std::span<const babelwires::Byte> m_bytes;
+            /// When parsing from a data source, m_bytes refers to this.
+            std::vector<babelwires::Byte> m_ownedBytes;
+            /// The absolute position of the chunk's events.
+            int m_offset = 0;
+            std::array<ChannelSetup, 16> m_channelSetupAtStart;
+            std::vector<ChannelSetupChange> m_channelSetupChanges;
+        };
+
+        /// Read the track chunks into m_trackChunks using the Setup pass.
+        babelwires::Result locateTrackChunks();
+
+        /// Parse the events of a chunk found by the Setup pass, building tracks only for the given channels.
+        babelwires::ResultT<ChannelTracks>
+        readTrackChunkEvents(int trackIndex, const TrackChunk& chunk, bool hasMainMetadata,
+                             std::bitset<16> channelsToBuild = std::bitset<16>().set());
+
+        struct DeferredTrackSource;
+
+        /// Index the track chunks and give the sequence deferred tracks which parse their channel on first use.
+        babelwires::Result readSequenceDeferred();
+
+        std::vector<TrackChunk> m_trackChunks;
+
+        /// The chunk being read by the Setup pass, where it records what it finds.
+        TrackChunk* m_chunkBeingScanned = nullptr;
+        /// The changes the Events pass applies.
+        const std::vector<ChannelSetupChange>* m_channelSetupChangesToApply = nullptr;
+        std::size_t m_nextChannelSetupChange = 0;
+
+        unsigned int m_maxNumThreads = 0;
+
+        /// When non-null, the tracks are deferred.
+        std::shared_ptr<const void> m_deferredBytesOwner;
+
+        /// When non-null, warnings are added to this instead of being logged.
+        std::vector<std::string>* m_bufferedWarnings = nullptr;
     };
 
     babelwires::ResultT<std::unique_ptr<babelwires::ValueTreeRoot>> parseSmfSequence(babelwires::DataSource& dataSource,
                                                               const babelwires::Context& context,
                                                               babelwires::UserLogger& userLogger);
 
+    babelwires::ResultT<std::unique_ptr<babelwires::ValueTreeRoot>>
+    parseSmfSequence(std::span<const babelwires::Byte> bytes, const babelwires::Context& context,
+                     babelwires::UserLogger& userLogger);
+
+    /// Parse the bytes, but only build the track of a channel when it is first used.
+    /// bytesOwner must keep the bytes alive and unchanged. The deferred tracks share ownership of it.
+    babelwires::ResultT<std::unique_ptr<babelwires::ValueTreeRoot>>
+    parseSmfSequenceDeferred(std::span<const babelwires::Byte> bytes, std::shared_ptr<const void> bytesOwner,
+                             const babelwires::Context& context, babelwires::UserLogger& userLogger);
+
 } // namespace smf
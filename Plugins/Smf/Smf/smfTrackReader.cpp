@@ -0,0 +1,153 @@
+/**
+ * Read the messages of a Standard MIDI File track chunk which is in memory.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <Smf/smfTrackReader.hpp>
+
+#include <algorithm>
+#include <array>
+
+smf::SmfTrackReader::SmfTrackReader(std::span<const babelwires::Byte> trackData, std::size_t offset)
+    : m_trackData(trackData)
+    , m_offset(offset) {}
+
+babelwires::Error smf::SmfTrackReader::getRunsPastEndError() const {
+    return babelwires::Error() << "Message runs past the end of the MIDI track at offset "
+                               << (m_offset + m_trackData.size());
+}
+
+babelwires::ResultT<babelwires::Byte> smf::SmfTrackReader::getNext() {
+    if (m_position < m_trackData.size()) {
+        return m_trackData[m_position++];
+    }
+    return getRunsPastEndError();
+}
+
+babelwires::ResultT<babelwires::Byte> smf::SmfTrackReader::peekNext() const {
+    if (m_position < m_trackData.size()) {
+        return m_trackData[m_position];
+    }
+    return getRunsPastEndError();
+}
+
+babelwires::ResultT<std::span<const babelwires::Byte>> smf::SmfTrackReader::readBytes(std::uint32_t numBytes) {
+    if (m_trackData.size() - m_position < numBytes) {
+        return getRunsPastEndError();
+    }
+    const std::span<const babelwires::Byte> bytes = m_trackData.subspan(m_position, numBytes);
+    m_position += numBytes;
+    return bytes;
+}
+
+babelwires::ResultT<std::uint32_t> smf::SmfTrackReader::readVariableLengthQuantity() {
+    std::uint32_t result = 0;
+    babelwires::Byte b;
+    int numBytes = 0;
+    do {
+        if (numBytes == 4) {
+            return babelwires::Error() << "Variable Length Quantity too big";
+        }
+        ++numBytes;
+
+        ASSIGN_OR_ERROR(b, getNext());
+        result = (result << 7) + (b & 0x7f);
+    } while (b & 0x80);
+    return result;
+}
+
+babelwires::ResultT<babelwires::Byte> smf::SmfTrackReader::readStatusByte(babelwires::Byte& lastStatusByte) {
+    ASSIGN_OR_ERROR(const babelwires::Byte statusByte, peekNext());
+    if (!(statusByte & 0x80) && (lastStatusByte != 0)) {
+        // Running status.
+        return lastStatusByte;
+    }
+    ++m_position;
+
+    // Buffer stores the status when a Voice Category Status (ie, 0x80 to 0xEF) is received.
+    // Buffer is cleared when a System Common Category Status (ie, 0xF0 to 0xF7) is received.
+    // Nothing is done to the buffer when a RealTime Category message is received.
+    if ((statusByte >= 0x80) && (statusByte <= 0xEF)) {
+        // Voice category status
+        lastStatusByte = statusByte;
+    } else if ((statusByte >= 0xF0) && (statusByte <= 0xF7)) {
+        // System common category status
+        lastStatusByte = 0;
+    }
+    return statusByte;
+}
+
+std::optional<smf::SmfTrackReader::ChannelMessage>
+smf::SmfTrackReader::tryReadChannelMessage(babelwires::Byte& lastStatusByte) {
+    // A delta time of at most 4 bytes, a status byte and at most 2 data bytes.
+    constexpr std::size_t maxChannelMessageSize = 7;
+    if (m_trackData.size() - m_position < maxChannelMessageSize) {
+        return {};
+    }
+    const babelwires::Byte* cursor = m_trackData.data() + m_position;
+
+    std::uint32_t numTicks = 0;
+    int numBytes = 0;
+    babelwires::Byte b;
+    do {
+        if (numBytes == 4) {
+            // Leave the checked code to report this.
+            return {};
+        }
+        ++numBytes;
+        b = *cursor++;
+        numTicks = (numTicks << 7) + (b & 0x7f);
+    } while (b & 0x80);
+
+    babelwires::Byte statusByte = *cursor;
+    if (statusByte & 0x80) {
+        if (statusByte >= 0xF0) {
+            // System messages and meta-events.
+            return {};
+        }
+        ++cursor;
+    } else if (lastStatusByte == 0) {
+        return {};
+    } else {
+        // Running status.
+        statusByte = lastStatusByte;
+    }
+
+    const int numDataBytes = getNumDataBytes(statusByte);
+    const ChannelMessage message{numTicks, statusByte, cursor[0],
+                                 (numDataBytes == 2) ? cursor[1] : static_cast<babelwires::Byte>(0)};
+    m_position = (cursor + numDataBytes) - m_trackData.data();
+    lastStatusByte = statusByte;
+    return message;
+}
+
+int smf::SmfTrackReader::getNumDataBytes(babelwires::Byte channelStatusByte) {
+    const babelwires::Byte statusHi = channelStatusByte >> 4;
+    return ((statusHi == 0b1100) || (statusHi == 0b1101)) ? 1 : 2;
+}
+
+std::optional<smf::GMSpecType::Value> smf::getGMSpecFromSysEx(std::span<const babelwires::Byte> message) {
+    if ((message.size() >= 4) && (message[0] == 0x7E) && (message[2] == 0x09)) {
+        // General MIDI message.
+        if (message[3] == 0x01) {
+            return GMSpecType::Value::GM;
+        } else if (message[3] == 0x03) {
+            return GMSpecType::Value::GM2;
+        }
+    } else if (message.size() == 10) {
+        // Roland GS Reset. The checksum is part of the fixed message.
+        constexpr std::array<babelwires::Byte, 8> gsReset{0x42, 0x12, 0x40, 0x00, 0x7F, 0x00, 0x41, 0xF7};
+        if ((message[0] == 0x41) && std::equal(gsReset.begin(), gsReset.end(), message.begin() + 2)) {
+            return GMSpecType::Value::GS;
+        }
+    } else if (message.size() == 8) {
+        // Yamaha XG Reset.
+        constexpr std::array<babelwires::Byte, 6> xgReset{0x4C, 0x00, 0x00, 0x7E, 0x00, 0xF7};
+        if ((message[0] == 0x43) && std::equal(xgReset.begin(), xgReset.end(), message.begin() + 2)) {
+            return GMSpecType::Value::XG;
+        }
+    }
+    return {};
+}
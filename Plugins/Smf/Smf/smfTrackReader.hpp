@@ -0,0 +1,85 @@
+/**
+ * Read the messages of a Standard MIDI File track chunk which is in memory.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#pragma once
+
+#include <Smf/gmSpec.hpp>
+
+#include <BaseLib/IO/dataSource.hpp>
+#include <BaseLib/Result/result.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace smf {
+
+    /// Reads the bytes of a track chunk. It understands how messages are framed (delta times, running status and
+    /// the lengths of channel messages) but not what they mean, which is left to the SmfParser and the metadata
+    /// scanner.
+    class SmfTrackReader {
+      public:
+        SmfTrackReader() = default;
+
+        /// The offset is the absolute position of the track data in the file, which is used in error messages.
+        SmfTrackReader(std::span<const babelwires::Byte> trackData, std::size_t offset);
+
+        std::span<const babelwires::Byte> getTrackData() const { return m_trackData; }
+        std::size_t getOffset() const { return m_offset; }
+
+        /// The position of the next byte to read, counted from the start of the track data.
+        std::size_t getPositionInTrack() const { return m_position; }
+
+        /// The absolute position of the next byte to read.
+        std::size_t getPosition() const { return m_offset + m_position; }
+
+        bool isAtEnd() const { return m_position == m_trackData.size(); }
+
+        babelwires::ResultT<babelwires::Byte> getNext();
+        babelwires::ResultT<babelwires::Byte> peekNext() const;
+
+        /// Return the next numBytes bytes and move past them.
+        babelwires::ResultT<std::span<const babelwires::Byte>> readBytes(std::uint32_t numBytes);
+
+        babelwires::ResultT<std::uint32_t> readVariableLengthQuantity();
+
+        /// Read the status byte of the next message, or return the running status if the message has none.
+        /// lastStatusByte carries the running status between messages, and should be 0 at the start of a track.
+        /// A data byte is consumed and returned if there is no running status, so the caller can report it.
+        babelwires::ResultT<babelwires::Byte> readStatusByte(babelwires::Byte& lastStatusByte);
+
+        /// A channel message, whose status byte is in the range 0x80 to 0xEF.
+        struct ChannelMessage {
+            std::uint32_t m_deltaTicks;
+            babelwires::Byte m_statusByte;
+            babelwires::Byte m_data0;
+            /// Zero if the message has only one data byte.
+            babelwires::Byte m_data1;
+        };
+
+        /// Read a delta time and channel message, checking the bounds only once.
+        /// Returns nothing without consuming anything if there might not be enough data or the message is not a
+        /// channel message, in which case the message should be read by the checked functions.
+        std::optional<ChannelMessage> tryReadChannelMessage(babelwires::Byte& lastStatusByte);
+
+        /// Program change and channel pressure have one data byte. The other channel messages have two.
+        static int getNumDataBytes(babelwires::Byte channelStatusByte);
+
+      private:
+        babelwires::Error getRunsPastEndError() const;
+
+      private:
+        std::span<const babelwires::Byte> m_trackData;
+        std::size_t m_offset = 0;
+        std::size_t m_position = 0;
+    };
+
+    /// The specification selected by a SysEx message, given the bytes which follow its length, if it is one of the
+    /// messages which select a specification.
+    std::optional<GMSpecType::Value> getGMSpecFromSysEx(std::span<const babelwires::Byte> message);
+
+} // namespace smf
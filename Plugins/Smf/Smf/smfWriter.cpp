@@ -14,7 +14,7 @@
 
 #include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
 #include <MusicLib/Utilities/filteredTrackIterator.hpp>
-#include <MusicLib/Utilities/musicUtilities.hpp>
+#include <MusicLib/Utilities/runConcurrently.hpp>
 #include <MusicLib/Utilities/trackTraverser.hpp>
 
 #include <BaseLib/Context/context.hpp>
@@ -25,70 +25,116 @@
 
 #include <algorithm>
 #include <set>
-#include <sstream>
+#include <thread>
 
 namespace {
     // See page 237 of the SC-8850 English manual for the part to block conversion.
     // We will always use the default part mapping, where parts correspond to midi channels.
     const std::array<unsigned int, 16> s_gsChannelToBlockMapping{1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 10, 11, 12, 13, 14, 15};
+
+    /// Below this, starting threads to encode the tracks costs more than it saves.
+    /// Events take a few bytes each, so this is roughly the size at which the parser starts using threads.
+    constexpr int c_minEventsForConcurrentWriting = 1 << 14;
 } // namespace
 
 smf::SmfWriter::SmfWriter(const babelwires::Context& context, babelwires::UserLogger& userLogger,
-                          const babelwires::ValueTreeRoot& sequence, std::ostream& ostream)
+                          const babelwires::ValueTreeRoot& sequence, std::ostream& ostream,
+                          const SmfWriterOptions& options)
     : m_projectContext(context)
     , m_userLogger(userLogger)
     , m_smfFeature(sequence)
     , m_ostream(ostream)
-    , m_os(&m_ostream)
+    , m_options(options)
     , m_division(256)
-    , m_standardPercussionSets(context) {}
+    , m_standardPercussionSets(std::make_shared<StandardPercussionSets>(context)) {}
+
+smf::SmfWriter::SmfWriter(const SmfWriter& owner, const std::array<ChannelSetup, 16>& channelSetup)
+    : m_projectContext(owner.m_projectContext)
+    , m_userLogger(owner.m_userLogger)
+    , m_smfFeature(owner.m_smfFeature)
+    , m_ostream(owner.m_ostream)
+    , m_options(owner.m_options)
+    , m_division(owner.m_division)
+    , m_standardPercussionSets(owner.m_standardPercussionSets)
+    , m_channelSetup(channelSetup) {}
+
+void smf::SmfWriter::setMaxNumThreads(unsigned int maxNumThreads) {
+    m_maxNumThreads = maxNumThreads;
+}
 
 void smf::SmfWriter::writeUint16(std::uint16_t i) {
-    m_os->put(i >> 8);
-    m_os->put(i & 255);
+    putByte(i >> 8);
+    putByte(i & 255);
 }
 
 void smf::SmfWriter::writeUint24(std::uint32_t i) {
     assert((i < (1 << 24)) && "Value cannot be represented in 24 bits");
-    m_os->put(i >> 16);
-    m_os->put((i >> 8) & 255);
-    m_os->put(i & 255);
+    putByte(i >> 16);
+    putByte((i >> 8) & 255);
+    putByte(i & 255);
 }
 
 void smf::SmfWriter::writeUint32(std::uint32_t i) {
-    m_os->put(i >> 24);
-    m_os->put((i >> 16) & 255);
-    m_os->put((i >> 8) & 255);
-    m_os->put(i & 255);
+    putByte(i >> 24);
+    putByte((i >> 16) & 255);
+    putByte((i >> 8) & 255);
+    putByte(i & 255);
 }
 
 void smf::SmfWriter::writeVariableLengthQuantity(std::uint32_t i) {
     assert((i <= 0x0fffffff) && "Value is too big for a variable-lengths quantity");
 
     if (const std::uint32_t b0 = ((i >> 21) & 0x7f)) {
-        m_os->put(b0 | 0x80);
+        putByte(b0 | 0x80);
     }
     if (const std::uint32_t b1 = ((i >> 14) & 0x7f)) {
-        m_os->put(b1 | 0x80);
+        putByte(b1 | 0x80);
     }
     if (const std::uint32_t b2 = ((i >> 7) & 0x7f)) {
-        m_os->put(b2 | 0x80);
+        putByte(b2 | 0x80);
     }
     const std::uint32_t b3 = i & 0x7f;
-    m_os->put(b3);
+    putByte(b3);
 }
 
 void smf::SmfWriter::writeModelDuration(const bw_music::ModelDuration& d) {
-    // TODO: Quantize if this isn't exact.
-    const int numDivisions = (d.getNumerator() * m_division * 4) / (d.getDenominator());
-    writeVariableLengthQuantity(numDivisions);
+    const int denominator = d.getDenominator();
+    const int ticksPerWhole = m_division * 4;
+    if (ticksPerWhole % denominator == 0) {
+        // The division is a multiple of the denominators of the events, so this is the usual case.
+        writeVariableLengthQuantity(d.getNumerator() * (ticksPerWhole / denominator));
+    } else {
+        // TODO: Quantize if this isn't exact.
+        writeVariableLengthQuantity((d.getNumerator() * ticksPerWhole) / denominator);
+    }
+}
+
+void smf::SmfWriter::writeStatusByte(std::uint8_t statusByte) {
+    if (!m_options.m_useRunningStatus || (statusByte != m_runningStatus)) {
+        putByte(statusByte);
+        m_runningStatus = statusByte;
+    }
+}
+
+void smf::SmfWriter::writeNoteMessage(bool isNoteOn, int channelNumber, std::uint8_t pitch, std::uint8_t velocity) {
+    if (isNoteOn || m_options.m_useNoteOnForNoteOff) {
+        writeStatusByte(0b10010000 | channelNumber);
+        putByte(pitch);
+        putByte(isNoteOn ? velocity : 0);
+    } else {
+        writeStatusByte(0b10000000 | channelNumber);
+        putByte(pitch);
+        putByte(velocity);
+    }
 }
 
 void smf::SmfWriter::writeTempoEvent(int bpm) {
-    m_os->put(0x00u);
-    m_os->put(0xffu);
-    m_os->put(0x51u);
-    m_os->put(0x03u);
+    // Meta-events cancel running status.
+    m_runningStatus = 0;
+    putByte(0x00u);
+    putByte(0xffu);
+    putByte(0x51u);
+    putByte(0x03u);
 
     const int d = 60'000'000 / bpm;
 
@@ -98,13 +144,15 @@ void smf::SmfWriter::writeTempoEvent(int bpm) {
 void smf::SmfWriter::writeTextMetaEvent(int type, std::string text) {
     assert((0 <= type) && (type <= 15) && "Type is out-of-range.");
     babelwires::Byte t = type;
-    m_os->put(0x00u);
-    m_os->put(0xffu);
-    m_os->put(t);
+    // Meta-events cancel running status.
+    m_runningStatus = 0;
+    putByte(0x00u);
+    putByte(0xffu);
+    putByte(t);
     writeVariableLengthQuantity(text.length());
 
     // TODO assert text is ASCII.
-    *m_os << text;
+    m_buffer.insert(m_buffer.end(), text.begin(), text.end());
 }
 
 smf::SmfSequence::ConstInstance smf::SmfWriter::getSmfSequenceConst() const {
@@ -118,15 +166,16 @@ void smf::SmfWriter::writeHeaderChunk(unsigned int numTracks) {
 
     const unsigned int tagIndex = smfType.getInstanceType().getIndexOfTag(smfType.getSelectedTag());
 
-    m_os->write("MThd", 4);
+    putBytes("MThd");
     writeUint32(6);
     writeUint16(tagIndex);
     writeUint16((tagIndex == 0) ? 1 : numTracks);
 
     {
+        // Tracks maintain their minimum denominator, so this does not need to look at the events.
         int division = 1;
         applyToAllTracks([&division](unsigned int channelNumber, const bw_music::Track& track) {
-            division = babelwires::lcm(division, bw_music::getMinimumDenominator(track));
+            division = babelwires::lcm(division, track.getMinimumDenominator());
         });
         m_division = division;
     }
@@ -146,9 +195,7 @@ smf::SmfWriter::WriteTrackEventResult smf::SmfWriter::writeTrackEvent(int channe
         if (const bw_music::PercussionOnEvent* percussionOn = e.tryAs<bw_music::PercussionOnEvent>()) {
             if (auto maybePitch = kitIfPercussion->tryGetPitchFromInstrument(percussionOn->getInstrument())) {
                 writeModelDuration(timeSinceLastEvent);
-                m_os->put(0b10010000 | channelNumber);
-                m_os->put(*maybePitch);
-                m_os->put(percussionOn->getVelocity());
+                writeNoteMessage(true, channelNumber, *maybePitch, percussionOn->getVelocity());
                 return WriteTrackEventResult::Written;
             } else {
                 return WriteTrackEventResult::NotInPercussionSet;
@@ -156,9 +203,7 @@ smf::SmfWriter::WriteTrackEventResult smf::SmfWriter::writeTrackEvent(int channe
         } else if (const bw_music::PercussionOffEvent* percussionOff = e.tryAs<bw_music::PercussionOffEvent>()) {
             if (auto maybePitch = kitIfPercussion->tryGetPitchFromInstrument(percussionOff->getInstrument())) {
                 writeModelDuration(timeSinceLastEvent);
-                m_os->put(0b10000000 | channelNumber);
-                m_os->put(*maybePitch);
-                m_os->put(percussionOff->getVelocity());
+                writeNoteMessage(false, channelNumber, *maybePitch, percussionOff->getVelocity());
                 return WriteTrackEventResult::Written;
             } else {
                 return WriteTrackEventResult::NotInPercussionSet;
@@ -167,15 +212,11 @@ smf::SmfWriter::WriteTrackEventResult smf::SmfWriter::writeTrackEvent(int channe
     } else {
         if (const bw_music::NoteOnEvent* noteOn = e.tryAs<bw_music::NoteOnEvent>()) {
             writeModelDuration(timeSinceLastEvent);
-            m_os->put(0b10010000 | channelNumber);
-            m_os->put(noteOn->m_pitch);
-            m_os->put(noteOn->m_velocity);
+            writeNoteMessage(true, channelNumber, noteOn->m_pitch, noteOn->m_velocity);
             return WriteTrackEventResult::Written;
         } else if (const bw_music::NoteOffEvent* noteOff = e.tryAs<bw_music::NoteOffEvent>()) {
             writeModelDuration(timeSinceLastEvent);
-            m_os->put(0b10000000 | channelNumber);
-            m_os->put(noteOff->m_pitch);
-            m_os->put(noteOff->m_velocity);
+            writeNoteMessage(false, channelNumber, noteOff->m_pitch, noteOff->m_velocity);
             return WriteTrackEventResult::Written;
         }
     }
@@ -217,7 +258,7 @@ void smf::SmfWriter::writeNotes(const std::vector<ChannelAndTrack>& tracks) {
                     isFirstEventAtThisTime = false;
                 } else {
                     // TODO Warn user about events which could not be written.
-                    m_userLogger.logWarning() << "Event could not be written";
+                    logWarning("Event could not be written");
                 }
             });
         }
@@ -230,11 +271,24 @@ void smf::SmfWriter::writeNotes(const std::vector<ChannelAndTrack>& tracks) {
 }
 
 template <std::size_t N> void smf::SmfWriter::writeMessage(const std::array<std::uint8_t, N>& message) {
-    for (int i = 0; i < message.size(); ++i) {
-        m_os->put(message[i]);
+    // The status byte is always written here, but a channel message can establish a running status, while a system
+    // message cancels it.
+    m_runningStatus = (message[0] < 0xF0) ? message[0] : 0;
+    m_buffer.insert(m_buffer.end(), message.begin(), message.end());
+}
+
+void smf::SmfWriter::logWarning(std::string warning) {
+    if (m_bufferedWarnings) {
+        m_bufferedWarnings->emplace_back(std::move(warning));
+    } else {
+        m_userLogger.logWarning() << warning;
     }
 }
 
+void smf::SmfWriter::putBytes(std::string_view bytes) {
+    m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+}
+
 void smf::SmfWriter::writeGlobalSetup() {
     const auto& metadata = getSmfSequenceConst().getMeta();
 
@@ -277,64 +331,107 @@ void smf::SmfWriter::writeGlobalSetup() {
     }
 }
 
-void smf::SmfWriter::writeTrack(const std::vector<ChannelAndTrack>& tracks, bool includeGlobalSetup) {
-    std::ostream* oldStream = m_os;
-    std::ostringstream tempStream;
-    m_os = &tempStream;
-
-    if (includeGlobalSetup) {
-        writeGlobalSetup();
-    }
-
-    const GMSpecType::Value gmSpec = getSmfSequenceConst().getMeta().getSpec().get();
-
+smf::SmfWriter::ChannelSetupToWrite smf::SmfWriter::getChannelSetupToWrite(const std::vector<ChannelAndTrack>& tracks) {
+    ChannelSetupToWrite channelSetupToWrite;
     for (int i = 0; i < tracks.size(); ++i) {
         const unsigned int channelNumber = std::get<0>(tracks[i]);
         ChannelSetup& channelSetup = m_channelSetup[channelNumber];
         if (!channelSetup.m_setupWritten) {
-            const std::optional<StandardPercussionSets::ChannelSetupInfo> info =
-                m_standardPercussionSets.getChannelSetupInfoFromPercussionSet(channelSetup.m_kitIfPercussion,
-                                                                              channelNumber);
-            if (info) {
-                if (gmSpec == GMSpecType::Value::GS) {
-                    // Set GS "Use For Rhythm Part"
-                    writeModelDuration(0);
-                    const std::uint8_t block = 0x10 | s_gsChannelToBlockMapping[channelNumber];
-                    const std::uint8_t checksum = (0x80 - ((0x40 + block + 0x15 + info->m_gsPartMode) % 0x80)) % 0x80;
-                    writeMessage(std::array<std::uint8_t, 12>{0b11110000, 0x0A, 0x41, 0x10, 0x42, 0x12, 0x40, block,
-                                                              0x15, info->m_gsPartMode, checksum, 0xF7});
-                } else {
-                    // Bank select MSB
-                    writeModelDuration(0);
-                    writeMessage(std::array<std::uint8_t, 3>{static_cast<std::uint8_t>(0b10110000 | channelNumber),
-                                                             0x00, info->m_bankMSB});
-
-                    // Bank select LSB
-                    writeModelDuration(0);
-                    writeMessage(std::array<std::uint8_t, 3>{static_cast<std::uint8_t>(0b10110000 | channelNumber),
-                                                             0x20, info->m_bankLSB});
-                }
-
-                // Program change.
-                writeModelDuration(0);
-                writeMessage(std::array<std::uint8_t, 2>{static_cast<std::uint8_t>(0b11000000 | channelNumber),
-                                                         info->m_program});
-            }
+            channelSetupToWrite.emplace_back(channelNumber,
+                                             m_standardPercussionSets->getChannelSetupInfoFromPercussionSet(
+                                                 channelSetup.m_kitIfPercussion, channelNumber));
             channelSetup.m_setupWritten = true;
         }
     }
+    return channelSetupToWrite;
+}
+
+void smf::SmfWriter::writeChannelSetup(unsigned int channelNumber,
+                                       const StandardPercussionSets::ChannelSetupInfo& info) {
+    const GMSpecType::Value gmSpec = getSmfSequenceConst().getMeta().getSpec().get();
+    if (gmSpec == GMSpecType::Value::GS) {
+        // Set GS "Use For Rhythm Part"
+        writeModelDuration(0);
+        const std::uint8_t block = 0x10 | s_gsChannelToBlockMapping[channelNumber];
+        const std::uint8_t checksum = (0x80 - ((0x40 + block + 0x15 + info.m_gsPartMode) % 0x80)) % 0x80;
+        writeMessage(std::array<std::uint8_t, 12>{0b11110000, 0x0A, 0x41, 0x10, 0x42, 0x12, 0x40, block, 0x15,
+                                                  info.m_gsPartMode, checksum, 0xF7});
+    } else {
+        // Bank select MSB
+        writeModelDuration(0);
+        writeMessage(std::array<std::uint8_t, 3>{static_cast<std::uint8_t>(0b10110000 | channelNumber), 0x00,
+                                                 info.m_bankMSB});
+
+        // Bank select LSB
+        writeModelDuration(0);
+        writeMessage(std::array<std::uint8_t, 3>{static_cast<std::uint8_t>(0b10110000 | channelNumber), 0x20,
+                                                 info.m_bankLSB});
+    }
+
+    // Program change.
+    writeModelDuration(0);
+    writeMessage(
+        std::array<std::uint8_t, 2>{static_cast<std::uint8_t>(0b11000000 | channelNumber), info.m_program});
+}
+
+void smf::SmfWriter::writeTrack(const std::vector<ChannelAndTrack>& tracks,
+                                const ChannelSetupToWrite& channelSetupToWrite, bool includeGlobalSetup) {
+    putBytes("MTrk");
+    // The length is not known until the track is written, so leave space for it.
+    const std::size_t lengthPosition = m_buffer.size();
+    writeUint32(0);
+    const std::size_t trackStart = m_buffer.size();
+    m_runningStatus = 0;
+
+    if (includeGlobalSetup) {
+        writeGlobalSetup();
+    }
+
+    for (const auto& [channelNumber, info] : channelSetupToWrite) {
+        if (info) {
+            writeChannelSetup(channelNumber, *info);
+        }
+    }
 
     writeNotes(tracks);
 
     // End of track.
-    m_os->put(0xffu);
-    m_os->put(0x2Fu);
-    m_os->put(0x00u);
-
-    m_os = oldStream;
-    m_os->write("MTrk", 4);
-    writeUint32(static_cast<std::uint32_t>(tempStream.tellp()));
-    m_os->write(tempStream.str().data(), tempStream.tellp());
+    m_runningStatus = 0;
+    putByte(0xffu);
+    putByte(0x2Fu);
+    putByte(0x00u);
+
+    const std::uint32_t trackLength = static_cast<std::uint32_t>(m_buffer.size() - trackStart);
+    m_buffer[lengthPosition] = trackLength >> 24;
+    m_buffer[lengthPosition + 1] = (trackLength >> 16) & 255;
+    m_buffer[lengthPosition + 2] = (trackLength >> 8) & 255;
+    m_buffer[lengthPosition + 3] = trackLength & 255;
+}
+
+void smf::SmfWriter::writeFormat1TracksConcurrently(const std::vector<std::vector<ChannelAndTrack>>& tracks,
+                                                    const std::vector<ChannelSetupToWrite>& channelSetupToWrite,
+                                                    unsigned int numThreads) {
+    const int numTracks = tracks.size();
+    std::vector<std::vector<std::uint8_t>> trackBuffers(numTracks);
+    // The workers buffer their warnings, which are logged in track order afterwards.
+    std::vector<std::vector<std::string>> warnings(numTracks);
+    bw_music::runConcurrently(
+        numTracks,
+        [&](std::size_t i) {
+            SmfWriter workerWriter(*this, m_channelSetup);
+            workerWriter.m_bufferedWarnings = &warnings[i];
+            workerWriter.writeTrack(tracks[i], channelSetupToWrite[i], (i == 0));
+            trackBuffers[i] = std::move(workerWriter.m_buffer);
+        },
+        numThreads);
+
+    // Appending the buffers in order gives the same bytes as writing the tracks in a single pass.
+    for (int i = 0; i < numTracks; ++i) {
+        for (const std::string& warning : warnings[i]) {
+            m_userLogger.logWarning() << warning;
+        }
+        m_buffer.insert(m_buffer.end(), trackBuffers[i].begin(), trackBuffers[i].end());
+    }
 }
 
 void smf::SmfWriter::setUpPercussionKit(const std::unordered_set<babelwires::ShortId>& instrumentsInUse,
@@ -342,7 +439,7 @@ void smf::SmfWriter::setUpPercussionKit(const std::unordered_set<babelwires::Sho
     const GMSpecType::Value gmSpec = getSmfSequenceConst().getMeta().getSpec().get();
     std::unordered_set<babelwires::ShortId> excludedInstruments;
     m_channelSetup[channelNumber].m_kitIfPercussion =
-        m_standardPercussionSets.getBestPercussionSet(gmSpec, channelNumber, instrumentsInUse, excludedInstruments);
+        m_standardPercussionSets->getBestPercussionSet(gmSpec, channelNumber, instrumentsInUse, excludedInstruments);
     if (!excludedInstruments.empty()) {
         m_userLogger.logWarning() << "Percussion events for " << excludedInstruments.size()
                                   << " instruments could not be represented in channel " << channelNumber;
@@ -391,11 +488,20 @@ void smf::SmfWriter::applyToAllTracks(std::function<void(unsigned int, const bw_
 void smf::SmfWriter::write() {
     setUpPercussionSets();
 
-    std::vector<ChannelAndTrack> channelAndTrackValues;
+    {
+        // Most events take 4 bytes, so this is usually enough to avoid reallocating.
+        std::size_t numEvents = 0;
+        applyToAllTracks([&numEvents](unsigned int channelNumber, const bw_music::Track& track) {
+            numEvents += track.getNumEvents();
+        });
+        m_buffer.clear();
+        m_buffer.reserve(1024 + numEvents * 4);
+    }
 
     const auto& smfType = getSmfSequenceConst();
 
     if (smfType.getInstanceType().getIndexOfTag(smfType.getSelectedTag()) == 0) {
+        std::vector<ChannelAndTrack> channelAndTrackValues;
         const auto& tracks = smfType.getTrcks0();
         for (unsigned int c = 0; c < 16; ++c) {
             if (auto track = tracks.tryGetTrack(c)) {
@@ -403,28 +509,76 @@ void smf::SmfWriter::write() {
             }
         }
         writeHeaderChunk(channelAndTrackValues.size());
-        writeTrack(channelAndTrackValues, true);
+        writeTrack(channelAndTrackValues, getChannelSetupToWrite(channelAndTrackValues), true);
     } else {
         const auto& tracks = smfType.getTrcks1();
         const int numTracks = tracks.getSize();
         writeHeaderChunk(numTracks);
+
+        // The setup of each channel is written by the first track which uses it, so determine that in order before
+        // the tracks are encoded. After this, the tracks can be encoded independently.
+        std::vector<std::vector<ChannelAndTrack>> channelAndTrackValuesPerTrack(numTracks);
+        std::vector<ChannelSetupToWrite> channelSetupToWrite(numTracks);
         for (int i = 0; i < numTracks; ++i) {
-            channelAndTrackValues.clear();
+            std::vector<ChannelAndTrack>& trackValues = channelAndTrackValuesPerTrack[i];
             auto trackAndChannel = tracks.getEntry(i);
-            channelAndTrackValues.emplace_back(
+            trackValues.emplace_back(
                 ChannelAndTrack{trackAndChannel.getChan().get(), &trackAndChannel.getTrack().get()});
             for (unsigned int c = 0; c < 16; ++c) {
                 if (auto extraTrack = trackAndChannel.tryGetTrack(c)) {
-                    channelAndTrackValues.emplace_back(ChannelAndTrack{c, &extraTrack->get()});
+                    trackValues.emplace_back(ChannelAndTrack{c, &extraTrack->get()});
+                }
+            }
+            channelSetupToWrite[i] = getChannelSetupToWrite(trackValues);
+        }
+
+        unsigned int maxNumThreads = m_maxNumThreads;
+        if (maxNumThreads == 0) {
+            int numEvents = 0;
+            for (const auto& trackValues : channelAndTrackValuesPerTrack) {
+                for (const auto& [channel, track] : trackValues) {
+                    numEvents += track->getNumEvents();
                 }
             }
-            writeTrack(channelAndTrackValues, (i == 0));
+            maxNumThreads = (numEvents >= c_minEventsForConcurrentWriting)
+                                ? std::max(std::thread::hardware_concurrency(), 1u)
+                                : 1;
+        }
+        const unsigned int numThreads = std::min<unsigned int>(std::max(numTracks, 1), maxNumThreads);
+        if (numThreads > 1) {
+            writeFormat1TracksConcurrently(channelAndTrackValuesPerTrack, channelSetupToWrite, numThreads);
+        } else {
+            for (int i = 0; i < numTracks; ++i) {
+                writeTrack(channelAndTrackValuesPerTrack[i], channelSetupToWrite[i], (i == 0));
+            }
         }
     }
+
+    m_ostream.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
 }
 
 void smf::writeToSmf(const babelwires::Context& context, babelwires::UserLogger& userLogger,
-                     const babelwires::ValueTreeRoot& sequence, std::ostream& output) {
-    smf::SmfWriter writer(context, userLogger, sequence, output);
+                     const babelwires::ValueTreeRoot& sequence, std::ostream& output,
+                     const SmfWriterOptions& options) {
+    smf::SmfWriter writer(context, userLogger, sequence, output, options);
     writer.write();
 }
+
+smf::SmfWriterOptions smf::getSmfWriterOptions(const babelwires::ValueTreeRoot& sequence) {
+    SmfWriterOptions options;
+    const auto metadata = babelwires::FileTypeT<SmfSequence>::ConstInstance(sequence).getConts().getMeta();
+    if (const auto encoding = metadata.tryGetEncode()) {
+        switch (encoding->get()) {
+            case SmfEncodingType::Value::Cmpact:
+                options.m_useNoteOnForNoteOff = true;
+                [[fallthrough]];
+            case SmfEncodingType::Value::RunSt:
+                options.m_useRunningStatus = true;
+                break;
+            default:
+            case SmfEncodingType::Value::Plain:
+                break;
+        }
+    }
+    return options;
+}
@@ -13,7 +13,12 @@
 #include <MusicLib/musicTypes.hpp>
 
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace babelwires {
     struct UserLogger;
@@ -26,22 +31,48 @@ namespace bw_music {
 
 namespace smf {
 
+    /// Options which affect how the sequence is encoded.
+    /// The defaults write every status byte, so files exported without options are unchanged.
+    /// The SMF target format takes them from the encoding in the sequence's metadata.
+    struct SmfWriterOptions {
+        /// Omit the status byte of a channel message when it is the same as the status byte of the previous one.
+        bool m_useRunningStatus = false;
+        /// Write note offs as note ons with zero velocity, so they can share the running status of note ons.
+        /// The velocities of the note offs are lost.
+        bool m_useNoteOnForNoteOff = false;
+    };
+
     class SmfWriter {
       public:
         SmfWriter(const babelwires::Context& context, babelwires::UserLogger& userLogger,
-                  const babelwires::ValueTreeRoot& sequence, std::ostream& output);
+                  const babelwires::ValueTreeRoot& sequence, std::ostream& output,
+                  const SmfWriterOptions& options = {});
 
         void write();
 
+        /// Limit the number of threads used to encode the tracks of format 1 files.
+        /// By default (0), the hardware concurrency is used for files with many events, and other files are encoded
+        /// in a single pass. With 1, tracks are always encoded in a single pass.
+        void setMaxNumThreads(unsigned int maxNumThreads);
+
       protected:
         SmfSequence::ConstInstance getSmfSequenceConst() const;
 
+        void putByte(std::uint8_t b) { m_buffer.push_back(b); }
+        void putBytes(std::string_view bytes);
+
         void writeUint16(std::uint16_t i);
         void writeUint24(std::uint32_t i);
         void writeUint32(std::uint32_t i);
         void writeVariableLengthQuantity(std::uint32_t i);
         void writeModelDuration(const bw_music::ModelDuration& d);
 
+        /// Write the status byte of a channel message, unless running status allows it to be omitted.
+        void writeStatusByte(std::uint8_t statusByte);
+
+        /// Write a note on or note off message.
+        void writeNoteMessage(bool isNoteOn, int channelNumber, std::uint8_t pitch, std::uint8_t velocity);
+
         /// Returns true if the event was written.
         enum class WriteTrackEventResult { Written, WrongCategory, NotInPercussionSet };
         WriteTrackEventResult writeTrackEvent(int channelNumber, bw_music::ModelDuration timeSinceLastEvent,
@@ -60,8 +91,25 @@ namespace smf {
 
         void writeHeaderChunk(unsigned int numTracks);
 
+        /// The channels whose setup information is written at the start of a track, and that information, if any.
+        using ChannelSetupToWrite =
+            std::vector<std::tuple<unsigned int, std::optional<StandardPercussionSets::ChannelSetupInfo>>>;
+
+        /// Find the channels of the tracks whose setup has not been written by an earlier track, and mark them as
+        /// written. This must be called for the tracks in the order they are written.
+        ChannelSetupToWrite getChannelSetupToWrite(const std::vector<ChannelAndTrack>& tracks);
+
         /// Write the events for the given track.
-        void writeTrack(const std::vector<ChannelAndTrack>& tracks, bool includeGlobalSetup);
+        void writeTrack(const std::vector<ChannelAndTrack>& tracks, const ChannelSetupToWrite& channelSetupToWrite,
+                        bool includeGlobalSetup);
+
+        /// Write the messages which set up the instrument of a channel.
+        void writeChannelSetup(unsigned int channelNumber, const StandardPercussionSets::ChannelSetupInfo& info);
+
+        /// Encode the tracks of a format 1 file into separate buffers on several threads, and append them in order.
+        void writeFormat1TracksConcurrently(const std::vector<std::vector<ChannelAndTrack>>& tracks,
+                                            const std::vector<ChannelSetupToWrite>& channelSetupToWrite,
+                                            unsigned int numThreads);
 
         /// Write non-channel-specific setup information.
         void writeGlobalSetup();
@@ -74,16 +122,25 @@ namespace smf {
 
         template <std::size_t N> void writeMessage(const std::array<std::uint8_t, N>& message);
 
+        /// Log the warning, or buffer it if this is a worker writer.
+        void logWarning(std::string warning);
+
       private:
         const babelwires::Context& m_projectContext;
         babelwires::UserLogger& m_userLogger;
         const babelwires::ValueTreeRoot& m_smfFeature;
         std::ostream& m_ostream;
-        std::ostream* m_os;
+        SmfWriterOptions m_options;
+        /// The file is written into this buffer, which is written to m_ostream in one go.
+        std::vector<std::uint8_t> m_buffer;
         /// Always use metrical time. Quater-note division.
         int m_division;
+        /// The status byte of the last channel message written to the current track, or 0 if there is none, or if
+        /// running status has been cancelled by a system message or meta-event.
+        std::uint8_t m_runningStatus = 0;
 
-        StandardPercussionSets m_standardPercussionSets;
+        /// Shared with the worker writers, which only use the percussion sets it owns through m_channelSetup.
+        std::shared_ptr<StandardPercussionSets> m_standardPercussionSets;
 
         /// Currently just used to determine which tracks are percussion tracks.
         struct ChannelSetup {
@@ -97,9 +154,22 @@ namespace smf {
         };
 
         std::array<ChannelSetup, 16> m_channelSetup;
+
+        unsigned int m_maxNumThreads = 0;
+
+        /// When non-null, warnings are added to this instead of being logged.
+        std::vector<std::string>* m_bufferedWarnings = nullptr;
+
+      private:
+        /// A writer which encodes tracks into its own buffer on behalf of owner. Used on worker threads.
+        SmfWriter(const SmfWriter& owner, const std::array<ChannelSetup, 16>& channelSetup);
     };
 
     void writeToSmf(const babelwires::Context& context, babelwires::UserLogger& userLogger,
-                    const babelwires::ValueTreeRoot& sequence, std::ostream& output);
+                    const babelwires::ValueTreeRoot& sequence, std::ostream& output,
+                    const SmfWriterOptions& options = {});
+
+    /// The options for the encoding selected in the metadata of the sequence, or the defaults if none is selected.
+    SmfWriterOptions getSmfWriterOptions(const babelwires::ValueTreeRoot& sequence);
 
 } // namespace smf
@@ -3,11 +3,13 @@
 #include <Smf/libRegistration.hpp>
 #include <Smf/midiTrackAndChannel.hpp>
 #include <Smf/midiTrackAndChannelArray.hpp>
+#include <Smf/smfFormat.hpp>
 #include <Smf/smfParser.hpp>
 #include <Smf/smfWriter.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
 #include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Utilities/filteredTrackIterator.hpp>
 #include <MusicLib/libRegistration.hpp>
 
 #include <BabelWiresLib/Instance/arrayTypeInstance.hpp>
@@ -22,6 +24,10 @@
 
 #include <Tests/TestUtils/tempFilePath.hpp>
 
+#include <filesystem>
+#include <span>
+#include <sstream>
+
 TEST(SmfSaveLoadTest, cMajorScale) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
@@ -274,3 +280,138 @@ TEST(SmfSaveLoadTest, format1Chords) {
         }
     }
 }
+
+TEST(SmfSaveLoadTest, format1ConcurrentWriteMatchesSinglePass) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.get<babelwires::TypeSystem>(),
+                                         babelwires::FileTypeT<smf::SmfSequence>::getType(
+                                             testEnvironment.m_projectContext.get<babelwires::TypeSystem>()));
+    smfFeature.setToDefault();
+
+    smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->as<babelwires::ValueTreeNode>()};
+    addMetadata(smfType, HAS_SEQUENCE_NAME | HAS_COPYRIGHT | HAS_TEMPO);
+
+    smfType.selectTag("SMF1");
+    auto tracks = smfType.getTrcks1();
+    tracks.setSize(9);
+
+    // Later tracks share channels with earlier ones, so only some tracks write the channel setup.
+    for (int i = 0; i < 9; ++i) {
+        auto trackAndChan = tracks.getEntry(i);
+        trackAndChan.getChan().set(i % 3);
+        bw_music::TrackBuilder track;
+        testUtils::addSimpleNotes(chordPitches[i % 3], track);
+        trackAndChan.getTrack().set(track.finishAndGetTrack());
+    }
+
+    std::ostringstream singlePassOutput;
+    {
+        smf::SmfWriter writer(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, singlePassOutput);
+        writer.setMaxNumThreads(1);
+        writer.write();
+    }
+
+    for (unsigned int numThreads : {2, 4, 16}) {
+        std::ostringstream concurrentOutput;
+        smf::SmfWriter writer(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, concurrentOutput);
+        writer.setMaxNumThreads(numThreads);
+        writer.write();
+        EXPECT_EQ(concurrentOutput.str(), singlePassOutput.str());
+    }
+}
+
+TEST(SmfSaveLoadTest, runningStatus) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.get<babelwires::TypeSystem>(),
+                                         babelwires::FileTypeT<smf::SmfSequence>::getType(
+                                             testEnvironment.m_projectContext.get<babelwires::TypeSystem>()));
+    smfFeature.setToDefault();
+
+    smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->as<babelwires::ValueTreeNode>()};
+    addMetadata(smfType, HAS_SEQUENCE_NAME | HAS_TEMPO);
+
+    // A sequence of three-note chords, so consecutive messages often have the same status.
+    const int numChords = chordPitches[0].size();
+    {
+        bw_music::TrackBuilder track;
+        for (int j = 0; j < numChords; ++j) {
+            for (int i = 0; i < 3; ++i) {
+                track.addEvent(bw_music::NoteOnEvent{0, chordPitches[i][j]});
+            }
+            for (int i = 0; i < 3; ++i) {
+                track.addEvent(bw_music::NoteOffEvent{babelwires::Rational((i == 0) ? 1 : 0, 4), chordPitches[i][j]});
+            }
+        }
+        smfType.getTrcks0().activateAndGetTrack(0).set(track.finishAndGetTrack());
+    }
+
+    const auto writeAndParse = [&](const smf::SmfWriterOptions& options, std::size_t& fileSize) {
+        std::ostringstream os;
+        smf::writeToSmf(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, os, options);
+        const std::string bytes = os.str();
+        fileSize = bytes.size();
+        return smf::parseSmfSequence(
+            std::span<const babelwires::Byte>(reinterpret_cast<const babelwires::Byte*>(bytes.data()), bytes.size()),
+            testEnvironment.m_projectContext, testEnvironment.m_log);
+    };
+
+    std::size_t fullStatusSize = 0;
+    auto fullStatusResult = writeAndParse(smf::SmfWriterOptions{false, false}, fullStatusSize);
+    ASSERT_TRUE(fullStatusResult.has_value());
+
+    // The default options write every status byte.
+    std::size_t defaultOptionsSize = 0;
+    ASSERT_TRUE(writeAndParse(smf::SmfWriterOptions{}, defaultOptionsSize).has_value());
+    EXPECT_EQ(defaultOptionsSize, fullStatusSize);
+
+    std::size_t runningStatusSize = 0;
+    auto runningStatusResult = writeAndParse(smf::SmfWriterOptions{true, false}, runningStatusSize);
+    ASSERT_TRUE(runningStatusResult.has_value());
+    EXPECT_LT(runningStatusSize, fullStatusSize);
+    // Running status does not change the meaning of the file.
+    EXPECT_EQ((*runningStatusResult)->getValue(), (*fullStatusResult)->getValue());
+
+    std::size_t noteOnForNoteOffSize = 0;
+    auto noteOnForNoteOffResult = writeAndParse(smf::SmfWriterOptions{true, true}, noteOnForNoteOffSize);
+    ASSERT_TRUE(noteOnForNoteOffResult.has_value());
+    EXPECT_LT(noteOnForNoteOffSize, runningStatusSize);
+
+    smf::SmfSequence::ConstInstance smfSequence{
+        (*noteOnForNoteOffResult)->getChild(0)->as<babelwires::ValueTreeNode>()};
+    auto track0 = smfSequence.getTrcks0().tryGetTrack(0);
+    ASSERT_TRUE(track0);
+    // Only the velocities of the note offs are lost.
+    int numNoteOns = 0;
+    int numNoteOffs = 0;
+    for (const auto& event : bw_music::iterateOver<bw_music::NoteEvent>(track0->get())) {
+        if (const auto* noteOn = event.tryAs<bw_music::NoteOnEvent>()) {
+            EXPECT_EQ(noteOn->m_velocity, bw_music::NoteOnEvent::c_defaultVelocity);
+            ++numNoteOns;
+        } else if (const auto* noteOff = event.tryAs<bw_music::NoteOffEvent>()) {
+            EXPECT_EQ(noteOff->m_velocity, 0);
+            ++numNoteOffs;
+        }
+    }
+    EXPECT_EQ(numNoteOns, numChords * 3);
+    EXPECT_EQ(numNoteOffs, numChords * 3);
+    EXPECT_EQ(track0->get().getDuration(), babelwires::Rational(numChords, 4));
+
+    // The target format takes the options from the encoding in the metadata.
+    EXPECT_FALSE(smf::getSmfWriterOptions(smfFeature).m_useRunningStatus);
+    smfType.getMeta().activateAndGetEncode().set(smf::SmfEncodingType::Value::Cmpact);
+    const smf::SmfWriterOptions compactOptions = smf::getSmfWriterOptions(smfFeature);
+    EXPECT_TRUE(compactOptions.m_useRunningStatus);
+    EXPECT_TRUE(compactOptions.m_useNoteOnForNoteOff);
+
+    testUtils::TempFilePath tempFile("compactEncoding.mid");
+    ASSERT_TRUE(smf::SmfTargetFormat()
+                    .writeToFile(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, tempFile)
+                    .has_value());
+    EXPECT_EQ(std::filesystem::file_size(tempFile), noteOnForNoteOffSize);
+}
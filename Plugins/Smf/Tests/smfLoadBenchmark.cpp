@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <Smf/libRegistration.hpp>
+#include <Smf/mappedFile.hpp>
+#include <Smf/smfMetadataScanner.hpp>
+#include <Smf/smfParser.hpp>
+
+#include <MusicLib/libRegistration.hpp>
+
+#include <BaseLib/IO/fileDataSource.hpp>
+
+#include <Tests/BabelWiresLib/TestUtils/testEnvironment.hpp>
+
+#include <Tests/TestUtils/resultTestUtils.hpp>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+// These are benchmarks rather than tests, so they are disabled by default.
+// Run them with --gtest_also_run_disabled_tests --gtest_filter=SmfLoadBenchmark.*
+
+namespace {
+    constexpr int numRepetitions = 20;
+
+    std::vector<std::filesystem::path> getTestSuiteFiles() {
+        std::vector<std::filesystem::path> files;
+        for (auto& p : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+            if (p.path().extension() == ".mid") {
+                files.emplace_back(p.path());
+            }
+        }
+        return files;
+    }
+
+    /// Load every test suite file repeatedly with the given function and report the throughput.
+    void reportThroughput(const char* description, const std::function<void(const std::filesystem::path&)>& load) {
+        const auto files = getTestSuiteFiles();
+        ASSERT_FALSE(files.empty());
+        std::uintmax_t numBytes = 0;
+        for (const auto& file : files) {
+            numBytes += std::filesystem::file_size(file);
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+        for (int i = 0; i < numRepetitions; ++i) {
+            for (const auto& file : files) {
+                load(file);
+            }
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+        const double megabytes = static_cast<double>(numBytes * numRepetitions) / (1024.0 * 1024.0);
+        std::cout << description << ": " << files.size() << " files, " << megabytes << " MB in " << elapsed.count()
+                  << " s = " << (megabytes / elapsed.count()) << " MB/s" << std::endl;
+    }
+} // namespace
+
+TEST(SmfLoadBenchmark, DISABLED_fileDataSource) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    reportThroughput("FileDataSource", [&testEnvironment](const std::filesystem::path& path) {
+        BW_ASSERT_RESULT_ASSIGN(auto midiFile, babelwires::FileDataSource::open(path));
+        smf::parseSmfSequence(midiFile, testEnvironment.m_projectContext, testEnvironment.m_log);
+        midiFile.close();
+    });
+}
+
+TEST(SmfLoadBenchmark, DISABLED_mappedFile) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    reportThroughput("MappedFile", [&testEnvironment](const std::filesystem::path& path) {
+        BW_ASSERT_RESULT_ASSIGN(auto mappedFile, smf::MappedFile::open(path));
+        smf::parseSmfSequence(mappedFile.getBytes(), testEnvironment.m_projectContext, testEnvironment.m_log);
+    });
+}
+
+TEST(SmfLoadBenchmark, DISABLED_readFile) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    // This is the path used by SmfSourceFormat::loadFromFile.
+    reportThroughput("Read file", [&testEnvironment](const std::filesystem::path& path) {
+        BW_ASSERT_RESULT_ASSIGN(auto file, smf::MappedFile::read(path));
+        smf::parseSmfSequence(file.getBytes(), testEnvironment.m_projectContext, testEnvironment.m_log);
+    });
+}
+
+TEST(SmfLoadBenchmark, DISABLED_scanMetadata) {
+    reportThroughput("scanSmfMetadata", [](const std::filesystem::path& path) {
+        BW_ASSERT_RESULT_ASSIGN(auto mappedFile, smf::MappedFile::open(path));
+        smf::scanSmfMetadata(mappedFile.getBytes());
+    });
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <Smf/libRegistration.hpp>
+#include <Smf/mappedFile.hpp>
+#include <Smf/midiMetadata.hpp>
+#include <Smf/midiTrackAndChannel.hpp>
+#include <Smf/midiTrackAndChannelArray.hpp>
+#include <Smf/smfMetadataScanner.hpp>
+#include <Smf/smfParser.hpp>
+#include <Smf/smfWriter.hpp>
+
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/libRegistration.hpp>
+
+#include <BabelWiresLib/Instance/arrayTypeInstance.hpp>
+#include <BabelWiresLib/Types/File/fileTypeT.hpp>
+
+#include <Tests/BabelWiresLib/TestUtils/testEnvironment.hpp>
+
+#include <Tests/TestUtils/resultTestUtils.hpp>
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+#include <sstream>
+
+TEST(SmfMetadataScannerTest, scanWrittenFile) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    babelwires::ValueTreeRoot smfFeature(testEnvironment.m_projectContext.get<babelwires::TypeSystem>(),
+                                         babelwires::FileTypeT<smf::SmfSequence>::getType(
+                                             testEnvironment.m_projectContext.get<babelwires::TypeSystem>()));
+    smfFeature.setToDefault();
+
+    smf::SmfSequence::Instance smfType{smfFeature.getChild(0)->as<babelwires::ValueTreeNode>()};
+    auto metadata = smfType.getMeta();
+    metadata.activateAndGetName().set("Test Sequence Name");
+    metadata.activateAndGetCopyR().set("(C)2026 Test Copyright");
+    metadata.activateAndGetTempo().set(100);
+    metadata.getSpec().set(smf::GMSpecType::Value::GS);
+
+    smfType.selectTag("SMF1");
+    auto tracks = smfType.getTrcks1();
+    tracks.setSize(2);
+    {
+        auto trackAndChan = tracks.getEntry(0);
+        trackAndChan.getChan().set(3);
+        trackAndChan.getTrack().set(testUtils::getTrackOfSimpleNotes({60, 62, 64, 65}));
+    }
+    {
+        auto trackAndChan = tracks.getEntry(1);
+        trackAndChan.getChan().set(5);
+        trackAndChan.getTrack().set(testUtils::getTrackOfSimpleNotes({48, 50, 52, 53, 55, 57}));
+    }
+
+    std::ostringstream os;
+    smf::writeToSmf(testEnvironment.m_projectContext, testEnvironment.m_log, smfFeature, os);
+    const std::string bytes = os.str();
+
+    BW_ASSERT_RESULT_ASSIGN(const smf::SmfMetadata smfMetadata,
+                            smf::scanSmfMetadata(std::span<const babelwires::Byte>(
+                                reinterpret_cast<const babelwires::Byte*>(bytes.data()), bytes.size())));
+
+    EXPECT_EQ(smfMetadata.m_format, 1);
+    EXPECT_EQ(smfMetadata.m_numTracks, 2);
+    ASSERT_TRUE(smfMetadata.m_name);
+    EXPECT_EQ(*smfMetadata.m_name, "Test Sequence Name");
+    ASSERT_TRUE(smfMetadata.m_copyright);
+    EXPECT_EQ(*smfMetadata.m_copyright, "(C)2026 Test Copyright");
+    ASSERT_TRUE(smfMetadata.m_tempo);
+    EXPECT_EQ(*smfMetadata.m_tempo, 100);
+    EXPECT_EQ(smfMetadata.m_gmSpec, smf::GMSpecType::Value::GS);
+
+    std::bitset<16> expectedChannels;
+    expectedChannels.set(3);
+    expectedChannels.set(5);
+    EXPECT_EQ(smfMetadata.m_channelsUsed, expectedChannels);
+    for (int c = 0; c < 16; ++c) {
+        EXPECT_EQ(smfMetadata.m_numNotesPerChannel[c], (c == 3) ? 4 : (c == 5) ? 6 : 0);
+    }
+    // Simple notes are a quarter long.
+    EXPECT_EQ(smfMetadata.m_duration, babelwires::Rational(6, 4));
+
+    // A truncated file is rejected.
+    EXPECT_FALSE(smf::scanSmfMetadata(std::span<const babelwires::Byte>(
+        reinterpret_cast<const babelwires::Byte*>(bytes.data()), bytes.size() - 1)));
+}
+
+TEST(SmfMetadataScannerTest, scanMatchesParse) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    int numFilesTested = 0;
+    for (auto& p : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+        if (p.path().extension() == ".mid") {
+            BW_ASSERT_RESULT_ASSIGN(auto mappedFile, smf::MappedFile::open(p.path()));
+            const auto parseResult = smf::parseSmfSequence(mappedFile.getBytes(), testEnvironment.m_projectContext,
+                                                           testEnvironment.m_log);
+            if (!parseResult) {
+                continue;
+            }
+            ++numFilesTested;
+            BW_ASSERT_RESULT_ASSIGN(const smf::SmfMetadata smfMetadata, smf::scanSmfMetadata(mappedFile.getBytes()));
+
+            smf::SmfSequence::ConstInstance smfSequence{
+                (*parseResult)->getChild(0)->as<babelwires::ValueTreeNode>()};
+            EXPECT_EQ(smfMetadata.m_format,
+                      static_cast<int>(smfSequence.getInstanceType().getIndexOfTag(smfSequence.getSelectedTag())));
+
+            const auto& metadata = smfSequence.getMeta();
+            EXPECT_EQ(smfMetadata.m_gmSpec, metadata.getSpec().get());
+            ASSERT_EQ(smfMetadata.m_name.has_value(), static_cast<bool>(metadata.tryGetName()));
+            if (smfMetadata.m_name) {
+                EXPECT_EQ(*smfMetadata.m_name, metadata.tryGetName()->get());
+            }
+            ASSERT_EQ(smfMetadata.m_copyright.has_value(), static_cast<bool>(metadata.tryGetCopyR()));
+            if (smfMetadata.m_copyright) {
+                EXPECT_EQ(*smfMetadata.m_copyright, metadata.tryGetCopyR()->get());
+            }
+            ASSERT_EQ(smfMetadata.m_tempo.has_value(), static_cast<bool>(metadata.tryGetTempo()));
+            if (smfMetadata.m_tempo) {
+                EXPECT_EQ(*smfMetadata.m_tempo, metadata.tryGetTempo()->get());
+            }
+        }
+    }
+    EXPECT_GT(numFilesTested, 0);
+}
+
+TEST(SmfMetadataScannerTest, format0WithTwoTracks) {
+    // A format 0 header which claims two tracks, followed by two empty tracks.
+    std::vector<babelwires::Byte> bytes = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 2, 0, 96,
+                                           'M', 'T', 'r', 'k', 0, 0, 0, 4, 0, 0xFF, 0x2F, 0,
+                                           'M', 'T', 'r', 'k', 0, 0, 0, 4, 0, 0xFF, 0x2F, 0};
+    EXPECT_FALSE(smf::scanSmfMetadata(std::span<const babelwires::Byte>(bytes)));
+
+    // The same chunks are fine in a format 1 file.
+    bytes[9] = 1;
+    EXPECT_TRUE(smf::scanSmfMetadata(std::span<const babelwires::Byte>(bytes)));
+}
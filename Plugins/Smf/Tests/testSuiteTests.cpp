@@ -2,6 +2,7 @@
 
 #include <Smf/Percussion/gm2StandardPercussionSet.hpp>
 #include <Smf/libRegistration.hpp>
+#include <Smf/mappedFile.hpp>
 #include <Smf/smfParser.hpp>
 
 #include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
@@ -16,6 +17,8 @@
 #include <Tests/TestUtils/resultTestUtils.hpp>
 #include <Tests/TestUtils/seqTestUtils.hpp>
 
+#include <algorithm>
+
 TEST(SmfTestSuiteTest, loadAllTestFilesWithoutCrashing) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
@@ -48,6 +51,124 @@ TEST(SmfTestSuiteTest, loadAllTestFilesWithoutCrashing) {
     EXPECT_EQ(numFilesTested, numSucceeded + numFailed);
 }
 
+TEST(SmfTestSuiteTest, mappedFilesParseLikeDataSources) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    int numFilesTested = 0;
+    for (auto& p : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+        if (p.path().extension() == ".mid") {
+            ++numFilesTested;
+            BW_ASSERT_RESULT_ASSIGN(auto midiFile, babelwires::FileDataSource::open(p.path()));
+            const auto resultFromDataSource =
+                smf::parseSmfSequence(midiFile, testEnvironment.m_projectContext, testEnvironment.m_log);
+            midiFile.close();
+
+            BW_ASSERT_RESULT_ASSIGN(auto mappedFile, smf::MappedFile::open(p.path()));
+            EXPECT_EQ(mappedFile.getBytes().size(), std::filesystem::file_size(p.path()));
+            const auto resultFromBytes =
+                smf::parseSmfSequence(mappedFile.getBytes(), testEnvironment.m_projectContext, testEnvironment.m_log);
+
+            BW_ASSERT_RESULT_ASSIGN(auto readFile, smf::MappedFile::read(p.path()));
+            EXPECT_FALSE(readFile.isMapped());
+            EXPECT_TRUE(std::equal(readFile.getBytes().begin(), readFile.getBytes().end(),
+                                   mappedFile.getBytes().begin(), mappedFile.getBytes().end()))
+                << p.path();
+
+            EXPECT_EQ(resultFromDataSource.has_value(), resultFromBytes.has_value()) << p.path();
+            if (resultFromDataSource.has_value() && resultFromBytes.has_value()) {
+                EXPECT_TRUE((*resultFromDataSource)->getValue() == (*resultFromBytes)->getValue()) << p.path();
+            }
+        }
+    }
+    EXPECT_GT(numFilesTested, 0);
+}
+
+TEST(SmfTestSuiteTest, concurrentParsingMatchesSinglePass) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    int numFilesTested = 0;
+    for (auto& p : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+        if (p.path().extension() == ".mid") {
+            ++numFilesTested;
+            BW_ASSERT_RESULT_ASSIGN(auto mappedFile, smf::MappedFile::open(p.path()));
+
+            smf::SmfParser singlePassParser(mappedFile.getBytes(), testEnvironment.m_projectContext,
+                                            testEnvironment.m_log);
+            singlePassParser.setMaxNumThreads(1);
+            const babelwires::Result singlePassResult = singlePassParser.parse();
+
+            smf::SmfParser concurrentParser(mappedFile.getBytes(), testEnvironment.m_projectContext,
+                                            testEnvironment.m_log);
+            concurrentParser.setMaxNumThreads(4);
+            const babelwires::Result concurrentResult = concurrentParser.parse();
+
+            EXPECT_EQ(singlePassResult.has_value(), concurrentResult.has_value()) << p.path();
+            if (singlePassResult.has_value() && concurrentResult.has_value()) {
+                EXPECT_TRUE(singlePassParser.getResult()->getValue() == concurrentParser.getResult()->getValue())
+                    << p.path();
+            }
+        }
+    }
+    EXPECT_GT(numFilesTested, 0);
+}
+
+TEST(SmfTestSuiteTest, deferredParsingMatchesFullParsing) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    int numFilesTested = 0;
+    for (auto& p : std::filesystem::directory_iterator(std::filesystem::current_path())) {
+        if (p.path().extension() == ".mid") {
+            ++numFilesTested;
+            BW_ASSERT_RESULT_ASSIGN(auto readFile, smf::MappedFile::read(p.path()));
+            auto sharedFile = std::make_shared<const smf::MappedFile>(std::move(readFile));
+
+            const auto fullResult =
+                smf::parseSmfSequence(sharedFile->getBytes(), testEnvironment.m_projectContext, testEnvironment.m_log);
+            const auto deferredResult = smf::parseSmfSequenceDeferred(
+                sharedFile->getBytes(), sharedFile, testEnvironment.m_projectContext, testEnvironment.m_log);
+            // The deferred tracks keep the bytes alive.
+            sharedFile.reset();
+
+            EXPECT_EQ(fullResult.has_value(), deferredResult.has_value()) << p.path();
+            if (fullResult.has_value() && deferredResult.has_value()) {
+                EXPECT_TRUE((*fullResult)->getValue() == (*deferredResult)->getValue()) << p.path();
+            }
+        }
+    }
+    EXPECT_GT(numFilesTested, 0);
+}
+
+TEST(SmfTestSuiteTest, deferredTracksAreBuiltOnFirstUse) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+    ASSERT_TRUE(smf::registerLib(testEnvironment.m_projectContext, testEnvironment.m_log));
+
+    BW_ASSERT_RESULT_ASSIGN(auto readFile, smf::MappedFile::read("test-c-major-scale.mid"));
+    auto sharedFile = std::make_shared<const smf::MappedFile>(std::move(readFile));
+    auto result = smf::parseSmfSequenceDeferred(sharedFile->getBytes(), sharedFile, testEnvironment.m_projectContext,
+                                                testEnvironment.m_log);
+    ASSERT_TRUE(result.has_value());
+    const auto& feature = *result;
+
+    smf::SmfSequence::ConstInstance smfSequence{feature->getChild(0)->as<babelwires::ValueTreeNode>()};
+    const auto& metadata = smfSequence.getMeta();
+    ASSERT_TRUE(metadata.tryGetName().has_value());
+    EXPECT_EQ(metadata.tryGetName()->get(), "C Major Scale Test");
+
+    auto track0 = smfSequence.getTrcks0().tryGetTrack(0);
+    ASSERT_TRUE(track0);
+    const bw_music::Track& track = track0->get();
+    EXPECT_TRUE(track.isDeferred());
+    EXPECT_EQ(track.getDuration(), babelwires::Rational(1, 4) * 8);
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{60, 62, 64, 65, 67, 69, 71, 72}, track);
+}
+
 namespace {
     const char* channelNames[] = {"ch0", "ch1", "ch2"};
 } // namespace
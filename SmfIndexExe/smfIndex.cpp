@@ -0,0 +1,213 @@
+/**
+ * The smfindex main function, which writes a CSV index of the Standard MIDI Files in a directory tree.
+ *
+ * (C) 2026 Malcolm Tyrrell
+ *
+ * Licensed under the GPLv3.0. See LICENSE file.
+ **/
+#include <Smf/mappedFile.hpp>
+#include <Smf/smfMetadataScanner.hpp>
+
+#include <MusicLib/Utilities/runConcurrently.hpp>
+
+#include <BaseLib/IO/fileDataSink.hpp>
+#include <BaseLib/Result/result.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+    struct IndexOptions {
+        std::filesystem::path m_directory;
+        std::filesystem::path m_outputFileName;
+        /// By default (0), the hardware concurrency is used.
+        unsigned int m_numThreads = 0;
+    };
+
+    void writeUsage(const std::string& programName, std::ostream& stream) {
+        stream << "Usage: " << programName << " <directory> <output.csv> [-j <numThreads>]" << std::endl;
+        stream << "Writes one line of metadata for each MIDI file found under the directory." << std::endl;
+    }
+
+    babelwires::ResultT<IndexOptions> parseOptions(int argc, char* argv[]) {
+        IndexOptions options;
+        std::vector<std::string> positionalArgs;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "-j") {
+                if (i + 1 == argc) {
+                    return babelwires::Error() << "The -j option requires a number of threads";
+                }
+                const std::string numThreads = argv[++i];
+                const auto [end, error] =
+                    std::from_chars(numThreads.data(), numThreads.data() + numThreads.size(), options.m_numThreads);
+                if ((error != std::errc()) || (end != numThreads.data() + numThreads.size())) {
+                    return babelwires::Error() << "The -j option expects a number of threads, not \"" << numThreads
+                                               << "\"";
+                }
+            } else {
+                positionalArgs.emplace_back(arg);
+            }
+        }
+        if (positionalArgs.size() != 2) {
+            return babelwires::Error() << "Expected a directory and an output file";
+        }
+        options.m_directory = positionalArgs[0];
+        options.m_outputFileName = positionalArgs[1];
+        if (!std::filesystem::is_directory(options.m_directory)) {
+            return babelwires::Error() << options.m_directory << " is not a directory";
+        }
+        return options;
+    }
+
+    bool isMidiFile(const std::filesystem::path& path) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        return (extension == ".mid") || (extension == ".midi") || (extension == ".smf");
+    }
+
+    babelwires::ResultT<std::vector<std::filesystem::path>> findMidiFiles(const std::filesystem::path& directory) {
+        std::vector<std::filesystem::path> files;
+        std::error_code ec;
+        std::filesystem::recursive_directory_iterator it(
+            directory, std::filesystem::directory_options::skip_permission_denied, ec);
+        for (; !ec && (it != std::filesystem::recursive_directory_iterator()); it.increment(ec)) {
+            // An entry which cannot be inspected is not a MIDI file we can index, so its error is ignored.
+            std::error_code entryEc;
+            if (it->is_regular_file(entryEc) && isMidiFile(it->path())) {
+                files.emplace_back(it->path());
+            }
+        }
+        if (ec) {
+            return babelwires::Error() << "Could not list the files in " << directory << ": " << ec.message();
+        }
+        // Sorting makes the index independent of the order of the directory entries.
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    babelwires::ResultT<smf::SmfMetadata> scanFile(const std::filesystem::path& path) {
+        ASSIGN_OR_ERROR(const smf::MappedFile mappedFile, smf::MappedFile::open(path));
+        return smf::scanSmfMetadata(mappedFile.getBytes());
+    }
+
+    const char* getGMSpecName(smf::GMSpecType::Value gmSpec) {
+        switch (gmSpec) {
+            case smf::GMSpecType::Value::GM:
+                return "GM";
+            case smf::GMSpecType::Value::GM2:
+                return "GM2";
+            case smf::GMSpecType::Value::GS:
+                return "GS";
+            case smf::GMSpecType::Value::XG:
+                return "XG";
+            default:
+            case smf::GMSpecType::Value::NONE:
+                return "";
+        }
+    }
+
+    /// Quote the field if it contains characters which are special in CSV.
+    std::string toCsvField(const std::string& field) {
+        if (field.find_first_of(",\"\r\n") == std::string::npos) {
+            return field;
+        }
+        std::string quotedField = "\"";
+        for (char c : field) {
+            if (c == '"') {
+                quotedField += '"';
+            }
+            quotedField += c;
+        }
+        quotedField += '"';
+        return quotedField;
+    }
+
+    void writeCsvHeader(std::ostream& stream) {
+        stream << "path,format,tracks,division,tempo,spec,name,copyright,quarterNotes,channels,notes,"
+                  "notesPerChannel,error\n";
+    }
+
+    void writeCsvRow(std::ostream& stream, const std::string& path,
+                     const babelwires::ResultT<smf::SmfMetadata>& result) {
+        stream << toCsvField(path) << ",";
+        if (!result) {
+            stream << ",,,,,,,,,,," << toCsvField(result.error().toString()) << "\n";
+            return;
+        }
+        const smf::SmfMetadata& metadata = *result;
+        stream << metadata.m_format << "," << metadata.m_numTracks << "," << metadata.m_division << ",";
+        if (metadata.m_tempo) {
+            stream << *metadata.m_tempo;
+        }
+        stream << "," << getGMSpecName(metadata.m_gmSpec) << ",";
+        stream << toCsvField(metadata.m_name.value_or("")) << ",";
+        stream << toCsvField(metadata.m_copyright.value_or("")) << ",";
+        // The duration is in quarter notes, since seconds would require the whole tempo map.
+        stream << (4.0 * metadata.m_duration.getNumerator()) / metadata.m_duration.getDenominator() << ",";
+        // A bitmask, where bit n is set if channel n (counting from 0) has notes.
+        stream << metadata.m_channelsUsed.to_ulong() << ",";
+        int numNotes = 0;
+        std::string notesPerChannel;
+        for (int c = 0; c < 16; ++c) {
+            numNotes += metadata.m_numNotesPerChannel[c];
+            notesPerChannel += (c == 0) ? "" : " ";
+            notesPerChannel += std::to_string(metadata.m_numNotesPerChannel[c]);
+        }
+        stream << numNotes << "," << notesPerChannel << ",\n";
+    }
+
+    babelwires::Result writeIndex(const IndexOptions& options) {
+        ASSIGN_OR_ERROR(const std::vector<std::filesystem::path> files, findMidiFiles(options.m_directory));
+
+        // The files are independent, so scan them concurrently.
+        std::vector<std::optional<babelwires::ResultT<smf::SmfMetadata>>> results(files.size());
+        bw_music::runConcurrently(
+            files.size(), [&](std::size_t i) { results[i] = scanFile(files[i]); }, options.m_numThreads);
+
+        ASSIGN_OR_ERROR(auto outFile, babelwires::FileDataSink::open(options.m_outputFileName));
+        ON_ERROR(outFile.closeOnError());
+        std::ostream& stream = outFile.stream();
+        writeCsvHeader(stream);
+        int numFailed = 0;
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            const std::string path = std::filesystem::relative(files[i], options.m_directory).generic_string();
+            writeCsvRow(stream, path, *results[i]);
+            if (!*results[i]) {
+                ++numFailed;
+            }
+        }
+        DO_OR_ERROR(outFile.close());
+
+        std::cout << "Indexed " << files.size() << " files";
+        if (numFailed > 0) {
+            std::cout << " (" << numFailed << " could not be read)";
+        }
+        std::cout << std::endl;
+        return {};
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const auto options = parseOptions(argc, argv);
+    if (!options) {
+        std::cerr << options.error().toString() << std::endl;
+        writeUsage(argv[0], std::cerr);
+        return EXIT_FAILURE;
+    }
+    const auto result = writeIndex(*options);
+    if (!result) {
+        std::cerr << result.error().toString() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -374,3 +374,53 @@ TEST(ChordMapProcessorTest, processor) {
     testOutputTrack(outArray.getEntry(0).get(), SourceMode::ChordToChord, TargetMode::ChordToChord,
                     WildcardMode::NoWildcards);
 }
+
+TEST(ChordMapProcessorTest, processorMapChangesWithSeveralEntries) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+
+    bw_music::ChordMapProcessor processor(testEnvironment.m_projectContext);
+
+    processor.getInput().setToDefault();
+    processor.getOutput().setToDefault();
+
+    babelwires::ValueTreeNode& input = processor.getInput();
+    const babelwires::ValueTreeNode& output = processor.getOutput();
+
+    babelwires::ValueTreeNode& inputArray =
+        input.assertGetChildFromStep(bw_music::ChordMapProcessor::getCommonArrayId());
+    const babelwires::ValueTreeNode& outputArray =
+        output.assertGetChildFromStep(bw_music::ChordMapProcessor::getCommonArrayId());
+
+    babelwires::ArrayInstanceImpl<babelwires::ValueTreeNode, bw_music::TrackType> inArray(inputArray);
+    const babelwires::ArrayInstanceImpl<const babelwires::ValueTreeNode, bw_music::TrackType> outArray(outputArray);
+
+    bw_music::ChordMapProcessorInput::Instance in(input);
+
+    // All entries share the compiled map.
+    ASSERT_TRUE(in.getChrdMp()->setValue(getTestChordMap(testEnvironment.m_typeSystem, SourceMode::ChordToChord,
+                                                         TargetMode::ChordToChord, WildcardMode::NoWildcards)));
+    inArray.setSize(2);
+    inArray.getEntry(0).set(getTestInputTrack());
+    inArray.getEntry(1).set(getTestInputTrack());
+
+    processor.process(testEnvironment.m_log);
+
+    ASSERT_EQ(outArray.getSize(), 2);
+    testOutputTrack(outArray.getEntry(0).get(), SourceMode::ChordToChord, TargetMode::ChordToChord,
+                    WildcardMode::NoWildcards);
+    testOutputTrack(outArray.getEntry(1).get(), SourceMode::ChordToChord, TargetMode::ChordToChord,
+                    WildcardMode::NoWildcards);
+
+    // A new map must not reuse the previously compiled one.
+    processor.getInput().clearChanges();
+    ASSERT_TRUE(in.getChrdMp()->setValue(getTestChordMap(testEnvironment.m_typeSystem, SourceMode::SilenceToChord,
+                                                         TargetMode::ChordToSilence, WildcardMode::Wildcards)));
+
+    processor.process(testEnvironment.m_log);
+
+    testOutputTrack(outArray.getEntry(0).get(), SourceMode::SilenceToChord, TargetMode::ChordToSilence,
+                    WildcardMode::Wildcards);
+    testOutputTrack(outArray.getEntry(1).get(), SourceMode::SilenceToChord, TargetMode::ChordToSilence,
+                    WildcardMode::Wildcards);
+}
@@ -63,4 +63,28 @@ TEST(ChordTypeSetTest, createValueFromChordTypes) {
     for (auto chordType : inputChordTypes) {
         EXPECT_NE(chordTypes.find(chordType), chordTypes.end());
     }
-}
\ No newline at end of file
+}
+
+TEST(ChordTypeSetTest, createValueFromChordTypeBitset) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+
+    const auto& typeSystem = testEnvironment.m_typeSystem;
+    const auto& chordTypeSet = typeSystem.getRegisteredType<bw_music::ChordTypeSet>();
+
+    bw_music::ChordTypeBitset inputChordTypes;
+    inputChordTypes.set(static_cast<std::size_t>(bw_music::ChordType::Value::M));
+    inputChordTypes.set(static_cast<std::size_t>(bw_music::ChordType::Value::dim));
+    inputChordTypes.set(static_cast<std::size_t>(bw_music::ChordType::Value::aug));
+
+    babelwires::ValueHolder chordSetValue =
+        chordTypeSet->createValueFromChordTypes(typeSystem, inputChordTypes);
+
+    std::set<bw_music::ChordType::Value> chordTypes =
+        chordTypeSet->getChordTypesFromValue(typeSystem, chordSetValue);
+
+    ASSERT_EQ(chordTypes.size(), 3);
+    EXPECT_NE(chordTypes.find(bw_music::ChordType::Value::M), chordTypes.end());
+    EXPECT_NE(chordTypes.find(bw_music::ChordType::Value::dim), chordTypes.end());
+    EXPECT_NE(chordTypes.find(bw_music::ChordType::Value::aug), chordTypes.end());
+}
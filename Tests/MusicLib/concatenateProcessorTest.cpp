@@ -61,6 +61,40 @@ TEST(ConcatenateProcessorTest, appendFuncGaps) {
     testUtils::testNotes(expectedNoteInfos, trackA);
 }
 
+TEST(ConcatenateProcessorTest, concatenateFuncGaps) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilderA;
+    testUtils::addNotes({{60, babelwires::Rational(1, 4), 1}, {62, babelwires::Rational(1, 4)}}, trackBuilderA);
+    const bw_music::Track trackA = trackBuilderA.finishAndGetTrack(2);
+
+    // An empty track still contributes its duration.
+    const bw_music::Track trackB(1);
+
+    bw_music::TrackBuilder trackBuilderC;
+    testUtils::addNotes({{64, babelwires::Rational(1, 4), babelwires::Rational(1, 2)}, {65, babelwires::Rational(1, 4)}},
+                        trackBuilderC);
+    const bw_music::Track trackC = trackBuilderC.finishAndGetTrack(3);
+
+    const std::vector<const bw_music::Track*> tracks = {&trackA, &trackB, &trackC, &trackA};
+    const bw_music::Track trackOut = bw_music::concatenateTracks(tracks);
+
+    EXPECT_EQ(trackOut.getDuration(), 8);
+    testUtils::testNotes({{60, babelwires::Rational(1, 4), 1},
+                          {62, babelwires::Rational(1, 4)},
+                          {64, babelwires::Rational(1, 4), 2},
+                          {65, babelwires::Rational(1, 4)},
+                          {60, babelwires::Rational(1, 4), 3},
+                          {62, babelwires::Rational(1, 4)}},
+                         trackOut);
+
+    bw_music::Track appendedTrack;
+    for (const auto* track : tracks) {
+        appendTrack(appendedTrack, *track);
+    }
+    EXPECT_EQ(trackOut, appendedTrack);
+}
+
 TEST(ConcatenateProcessorTest, processor) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
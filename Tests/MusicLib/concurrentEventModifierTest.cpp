@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Utilities/concurrentEventModifier.hpp>
+#include <MusicLib/Utilities/trackValidator.hpp>
+
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+namespace {
+    /// Overlapping notes of two lengths, under a note which lasts the whole track.
+    bw_music::Track getTrackWithOverlappingNotes() {
+        bw_music::TrackBuilder trackBuilder;
+        trackBuilder.addEvent(bw_music::NoteOnEvent{0, 40});
+        constexpr int numNotes = 300;
+        // Notes are at most 3 steps long, so consecutive notes never share a pitch.
+        const auto getPitch = [](int i) { return static_cast<bw_music::Pitch>(60 + (i * 7) % 13); };
+        bw_music::ModelDuration timeSinceLastEvent = 0;
+        for (int i = 0; i < numNotes + 3; ++i) {
+            timeSinceLastEvent += babelwires::Rational(1, 8);
+            // Even notes last 2 steps and odd notes last 3 steps.
+            if ((i >= 2) && ((i - 2) % 2 == 0) && (i - 2 < numNotes)) {
+                trackBuilder.addEvent(bw_music::NoteOffEvent{timeSinceLastEvent, getPitch(i - 2)});
+                timeSinceLastEvent = 0;
+            }
+            if ((i >= 3) && ((i - 3) % 2 == 1) && (i - 3 < numNotes)) {
+                trackBuilder.addEvent(bw_music::NoteOffEvent{timeSinceLastEvent, getPitch(i - 3)});
+                timeSinceLastEvent = 0;
+            }
+            if (i < numNotes) {
+                trackBuilder.addEvent(bw_music::NoteOnEvent{timeSinceLastEvent, getPitch(i)});
+                timeSinceLastEvent = 0;
+            }
+        }
+        trackBuilder.addEvent(bw_music::NoteOffEvent{timeSinceLastEvent + babelwires::Rational(1, 8), 40});
+        return trackBuilder.finishAndGetTrack(100);
+    }
+} // namespace
+
+TEST(ConcurrentEventModifierTest, sameAsSequential) {
+    testUtils::TestLog log;
+
+    const bw_music::Track trackIn = getTrackWithOverlappingNotes();
+    ASSERT_TRUE(bw_music::isTrackValid(trackIn));
+
+    const bw_music::EventSelector isNote = [](const bw_music::TrackEvent& event) {
+        return event.tryAs<bw_music::NoteEvent>() != nullptr;
+    };
+    const bw_music::EventModifier transpose = [](bw_music::TrackEvent& event) {
+        auto& noteEvent = static_cast<bw_music::NoteEvent&>(event);
+        noteEvent.setPitch(noteEvent.getPitch() + 5);
+        return true;
+    };
+
+    const bw_music::Track sequentialTrack = bw_music::modifyEventsConcurrently(trackIn, isNote, transpose, 1);
+    EXPECT_EQ(sequentialTrack.getNumEvents(), trackIn.getNumEvents());
+    EXPECT_EQ(sequentialTrack.getDuration(), 100);
+
+    for (unsigned int numSegments : {2, 3, 4, 7, 16}) {
+        const bw_music::Track trackOut = bw_music::modifyEventsConcurrently(trackIn, isNote, transpose, numSegments);
+        EXPECT_EQ(trackOut, sequentialTrack);
+    }
+}
+
+TEST(ConcurrentEventModifierTest, collisionsAtJoins) {
+    testUtils::TestLog log;
+
+    const bw_music::Track trackIn = getTrackWithOverlappingNotes();
+
+    // Map pitches onto a few values so groups collide, and drop some notes.
+    const bw_music::EventSelector isHighNote = [](const bw_music::TrackEvent& event) {
+        const auto* noteEvent = event.tryAs<bw_music::NoteEvent>();
+        return noteEvent && (noteEvent->getPitch() >= 60);
+    };
+    const bw_music::EventModifier collide = [](bw_music::TrackEvent& event) {
+        if (auto* noteEvent = event.tryAs<bw_music::NoteEvent>()) {
+            if (noteEvent->getPitch() == 66) {
+                return false;
+            }
+            if (noteEvent->getPitch() >= 60) {
+                noteEvent->setPitch(60 + (noteEvent->getPitch() - 60) % 4);
+            }
+        }
+        return true;
+    };
+
+    const bw_music::Track sequentialTrack = bw_music::modifyEventsConcurrently(trackIn, isHighNote, collide, 1);
+    EXPECT_TRUE(bw_music::isTrackValid(sequentialTrack));
+    EXPECT_LT(sequentialTrack.getNumEvents(), trackIn.getNumEvents());
+
+    for (unsigned int numSegments : {2, 3, 4, 7, 16}) {
+        const bw_music::Track trackOut = bw_music::modifyEventsConcurrently(trackIn, isHighNote, collide, numSegments);
+        EXPECT_EQ(trackOut, sequentialTrack);
+    }
+}
+
+TEST(ConcurrentEventModifierTest, smallTracks) {
+    testUtils::TestLog log;
+
+    const bw_music::EventSelector selectAll = [](const bw_music::TrackEvent& event) { return true; };
+    const bw_music::EventModifier dropAll = [](bw_music::TrackEvent& event) { return false; };
+    const bw_music::Track emptyTrack(4);
+    EXPECT_EQ(bw_music::modifyEventsConcurrently(emptyTrack, selectAll, dropAll, 4), emptyTrack);
+
+    const bw_music::Track track = testUtils::getTrackOfSimpleNotes({60, 62, 64, 65});
+    const bw_music::Track trackOut = bw_music::modifyEventsConcurrently(track, selectAll, dropAll, 4);
+    EXPECT_EQ(trackOut.getNumEvents(), 0);
+    EXPECT_EQ(trackOut.getDuration(), 1);
+}
+
+TEST(ConcurrentEventModifierTest, unselectedEventsUnchanged) {
+    testUtils::TestLog log;
+
+    const bw_music::Track trackIn = getTrackWithOverlappingNotes();
+
+    // The modifier would drop every event, but it only sees the selected ones.
+    const bw_music::EventSelector selectNone = [](const bw_music::TrackEvent& event) { return false; };
+    const bw_music::EventModifier dropAll = [](bw_music::TrackEvent& event) { return false; };
+
+    for (unsigned int numSegments : {1, 2, 3, 4, 7, 16}) {
+        const bw_music::Track trackOut = bw_music::modifyEventsConcurrently(trackIn, selectNone, dropAll, numSegments);
+        EXPECT_EQ(trackOut, trackIn);
+    }
+}
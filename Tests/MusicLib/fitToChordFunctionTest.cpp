@@ -106,3 +106,11 @@ TEST_F(FitToChordFunctionTest, FMajUpperLimit) {
     BW_ASSERT_RESULT_ASSIGN(auto result, bw_music::fitToChordFunction(m_upperLimitTrack, bw_music::Chord{bw_music::PitchClass::Value::F, bw_music::ChordType::Value::M}));
     testSimpleTrack(result, 125, 117, 120); // F, A, C
 }
+
+TEST_F(FitToChordFunctionTest, InPlace) {
+    bw_music::Track track = m_cMajorChordTrack;
+    BW_ASSERT_RESULT_ASSIGN(auto result, bw_music::fitToChordFunction(std::move(track), bw_music::Chord{bw_music::PitchClass::Value::G, bw_music::ChordType::Value::dim}));
+    testSimpleTrack(result, 55, 58, 61); // G, A#, C#
+    BW_ASSERT_RESULT_ASSIGN(auto copiedResult, bw_music::fitToChordFunction(m_cMajorChordTrack, bw_music::Chord{bw_music::PitchClass::Value::G, bw_music::ChordType::Value::dim}));
+    EXPECT_EQ(result, copiedResult);
+}
@@ -112,6 +112,26 @@ TEST(MergeProcessorTest, functionOverlaps) {
     EXPECT_EQ(it, end);
 }
 
+TEST(MergeProcessorTest, incrementalFunction) {
+    testUtils::TestLog log;
+
+    const bw_music::Track trackA = testUtils::getTrackOfSimpleNotes({72, 74, 76, 77});
+    const bw_music::Track trackB = testUtils::getTrackOfSimpleNotes({71, 72, 77, 76});
+    BW_ASSERT_RESULT_ASSIGN(const bw_music::Track previousMerge, bw_music::mergeTracks({&trackA, &trackB}));
+
+    // Edits at the start, in the middle, at the end, beyond the end and removing the end, some of which make notes
+    // overlap notes of the other track.
+    const std::vector<std::vector<bw_music::Pitch>> edits = {
+        {60, 72, 77, 76}, {71, 74, 77, 76}, {71, 72, 77, 60}, {71, 72, 77, 76, 74, 72}, {71, 72}, {}};
+    for (const auto& pitches : edits) {
+        const bw_music::Track newTrackB = testUtils::getTrackOfSimpleNotes(pitches);
+        BW_ASSERT_RESULT_ASSIGN(const bw_music::Track expectedMerge, bw_music::mergeTracks({&trackA, &newTrackB}));
+        BW_ASSERT_RESULT_ASSIGN(const bw_music::Track incrementalMerge,
+                                bw_music::mergeTracks({&trackA, &newTrackB}, {&trackA, &trackB}, previousMerge));
+        EXPECT_EQ(incrementalMerge, expectedMerge);
+    }
+}
+
 TEST(MergeProcessorTest, processor) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
@@ -406,4 +406,60 @@ TEST(MonophonicSubtracksProcessorTest, processor) {
     testUtils::testChords({{bw_music::PitchClass::Value::C, bw_music::ChordType::ChordType::Value::M},
                            {bw_music::PitchClass::Value::D, bw_music::ChordType::ChordType::Value::m}},
                           output.getOther().get());
-}
\ No newline at end of file
+}
+
+namespace {
+    /// Check that each subtrack is monophonic and return the number of notes across all the tracks.
+    int checkMonophonicAndCountNotes(const bw_music::MonophonicSubtracksResult& result) {
+        int numNotes = 0;
+        for (const auto& noteTrack : result.m_noteTracks) {
+            bool isNoteActive = false;
+            for (const auto& event : noteTrack) {
+                if (event.tryAs<bw_music::NoteOnEvent>()) {
+                    EXPECT_FALSE(isNoteActive);
+                    isNoteActive = true;
+                    ++numNotes;
+                } else if (event.tryAs<bw_music::NoteOffEvent>()) {
+                    EXPECT_TRUE(isNoteActive);
+                    isNoteActive = false;
+                }
+            }
+            EXPECT_FALSE(isNoteActive);
+        }
+        for (const auto& event : result.m_other) {
+            if (event.tryAs<bw_music::NoteOnEvent>()) {
+                ++numNotes;
+            }
+        }
+        return numNotes;
+    }
+} // namespace
+
+TEST(MonophonicSubtracksProcessorTest, denseScoreManyVoices) {
+    testUtils::TestLog log;
+
+    constexpr int numSteps = 256;
+    // Up to 48 notes sound at once, so a 32 voice split has to discard or evict notes.
+    const bw_music::Track track = testUtils::getDensePolyphonicTrack(numSteps, 24);
+
+    for (auto policy : {bw_music::MonophonicSubtracksPolicyEnum::Value::High,
+                        bw_music::MonophonicSubtracksPolicyEnum::Value::Low}) {
+        BW_ASSERT_RESULT_ASSIGN(bw_music::MonophonicSubtracksResult result,
+                                bw_music::getMonophonicSubtracks(track, 32, policy));
+        ASSERT_EQ(result.m_noteTracks.size(), 32);
+        // Without eviction, every note ends up somewhere.
+        EXPECT_EQ(checkMonophonicAndCountNotes(result), numSteps * 24);
+        for (const auto& noteTrack : result.m_noteTracks) {
+            EXPECT_GT(noteTrack.getNumEvents(), 0);
+        }
+    }
+
+    for (auto policy : {bw_music::MonophonicSubtracksPolicyEnum::Value::HighEv,
+                        bw_music::MonophonicSubtracksPolicyEnum::Value::LowEv}) {
+        BW_ASSERT_RESULT_ASSIGN(bw_music::MonophonicSubtracksResult result,
+                                bw_music::getMonophonicSubtracks(track, 32, policy));
+        ASSERT_EQ(result.m_noteTracks.size(), 32);
+        // Evicted notes are truncated, not dropped.
+        EXPECT_EQ(checkMonophonicAndCountNotes(result), numSteps * 24);
+    }
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/noteSpanIndex.hpp>
+#include <MusicLib/Types/Track/track.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+#include <algorithm>
+
+namespace {
+    /// Notes of varied lengths, so short notes are nested inside long ones.
+    bw_music::NoteSpans getVariedNoteSpans() {
+        bw_music::NoteSpans noteSpans;
+        for (int i = 0; i < 100; ++i) {
+            const bw_music::ModelDuration start = babelwires::Rational(i, 4);
+            const bw_music::ModelDuration duration = babelwires::Rational(1 + (i * 5) % 17, 8);
+            noteSpans.emplace_back(
+                bw_music::NoteSpan{start, duration, static_cast<bw_music::Pitch>(i), bw_music::NoteOnEvent::c_defaultVelocity});
+        }
+        return noteSpans;
+    }
+
+    bw_music::NoteSpans getNotesOverlappingSlowly(const bw_music::NoteSpans& noteSpans, bw_music::ModelDuration t0,
+                                                  bw_music::ModelDuration t1, bool includeNotesStartingAtT1) {
+        bw_music::NoteSpans notesOut;
+        for (const auto& span : noteSpans) {
+            const bool startsInTime = includeNotesStartingAtT1 ? (span.m_start <= t1) : (span.m_start < t1);
+            if (startsInTime && (span.m_start + span.m_duration > t0)) {
+                notesOut.emplace_back(span);
+            }
+        }
+        return notesOut;
+    }
+} // namespace
+
+TEST(NoteSpanIndexTest, queries) {
+    testUtils::TestLog log;
+
+    const bw_music::NoteSpans noteSpans = getVariedNoteSpans();
+    const bw_music::NoteSpanIndex index(noteSpans);
+
+    EXPECT_EQ(index.getNoteSpans(), noteSpans);
+    EXPECT_EQ(index.getStartOfFirstNote(), 0);
+    bw_music::ModelDuration endOfLastNote = 0;
+    for (const auto& span : noteSpans) {
+        endOfLastNote = std::max(endOfLastNote, span.m_start + span.m_duration);
+    }
+    EXPECT_EQ(index.getEndOfLastNote(), endOfLastNote);
+
+    for (int i = -2; i < 120; ++i) {
+        const bw_music::ModelDuration t0 = babelwires::Rational(i, 8);
+        EXPECT_EQ(index.getNotesActiveAt(t0), getNotesOverlappingSlowly(noteSpans, t0, t0, true));
+        for (int length : {1, 3, 16}) {
+            const bw_music::ModelDuration t1 = t0 + babelwires::Rational(length, 8);
+            EXPECT_EQ(index.getNotesOverlapping(t0, t1), getNotesOverlappingSlowly(noteSpans, t0, t1, false));
+        }
+    }
+    EXPECT_TRUE(index.getNotesOverlapping(2, 2).empty());
+}
+
+TEST(NoteSpanIndexTest, boundaries) {
+    testUtils::TestLog log;
+
+    const bw_music::Track track = testUtils::getTrackOfSimpleNotes({60, 62, 64, 65});
+    const bw_music::NoteSpanIndex& index = track.getNoteSpanIndex();
+
+    // A note is active from its start, but not at its end.
+    const bw_music::NoteSpans notesAtQuarter = index.getNotesActiveAt(babelwires::Rational(1, 4));
+    ASSERT_EQ(notesAtQuarter.size(), 1);
+    EXPECT_EQ(notesAtQuarter[0].m_pitch, 62);
+
+    const bw_music::NoteSpans notesInMiddle = index.getNotesOverlapping(babelwires::Rational(1, 4), babelwires::Rational(3, 4));
+    ASSERT_EQ(notesInMiddle.size(), 2);
+    EXPECT_EQ(notesInMiddle[0].m_pitch, 62);
+    EXPECT_EQ(notesInMiddle[1].m_pitch, 64);
+
+    EXPECT_EQ(index.getStartOfFirstNote(), 0);
+    EXPECT_EQ(index.getEndOfLastNote(), 1);
+
+    const bw_music::Track emptyTrack(4);
+    EXPECT_FALSE(emptyTrack.getNoteSpanIndex().getStartOfFirstNote().has_value());
+    EXPECT_FALSE(emptyTrack.getNoteSpanIndex().getEndOfLastNote().has_value());
+    EXPECT_TRUE(emptyTrack.getNoteSpanIndex().getNotesActiveAt(1).empty());
+}
+
+TEST(NoteSpanIndexTest, nestedNotes) {
+    testUtils::TestLog log;
+
+    // Each note ends after all the notes which start before it, so the latest end is always at the end of a range.
+    constexpr int numNotes = 10000;
+    bw_music::NoteSpans noteSpans;
+    for (int i = 0; i < numNotes; ++i) {
+        noteSpans.emplace_back(bw_music::NoteSpan{i, 2 * (numNotes - i), static_cast<bw_music::Pitch>(i % 128),
+                                                  bw_music::NoteOnEvent::c_defaultVelocity});
+    }
+    const bw_music::NoteSpanIndex index(noteSpans);
+
+    const bw_music::NoteSpans notesActive = index.getNotesActiveAt(numNotes / 2);
+    ASSERT_EQ(notesActive.size(), numNotes / 2 + 1);
+    EXPECT_TRUE(std::equal(notesActive.begin(), notesActive.end(), noteSpans.begin()));
+
+    const bw_music::NoteSpans notesOverlapping = index.getNotesOverlapping(numNotes, 2 * numNotes);
+    ASSERT_EQ(notesOverlapping.size(), numNotes);
+    EXPECT_EQ(notesOverlapping, noteSpans);
+
+    EXPECT_TRUE(index.getNotesActiveAt(2 * numNotes).empty());
+    EXPECT_EQ(index.getEndOfLastNote(), 2 * numNotes);
+}
@@ -118,6 +118,90 @@ TEST(PercussionMapProcessorTest, funcSimple) {
     EXPECT_EQ(outputTrack, expectedOutputTrack);
 }
 
+TEST(PercussionMapProcessorTest, funcInPlace) {
+    testUtils::TestLog log;
+
+    babelwires::TypeSystem typeSystem;
+    const babelwires::TypePtrT<bw_music::BuiltInPercussionInstruments> builtInPercussion =
+        typeSystem.addAndGetType<bw_music::BuiltInPercussionInstruments>();
+    typeSystem.addTypeConstructor<babelwires::EnumAtomTypeConstructor>();
+    typeSystem.addTypeConstructor<babelwires::EnumUnionTypeConstructor>();
+
+    const babelwires::MapValue mapValue = getTestPercussionMap(typeSystem);
+
+    // The input track has events that are dropped, so this cannot be done in place.
+    {
+        BW_ASSERT_RESULT_ASSIGN(const bw_music::Track outputTrack,
+                                bw_music::mapPercussionFunction(typeSystem, getTestInputTrack(), mapValue));
+        EXPECT_EQ(outputTrack, getTestOutputTrack());
+    }
+    // No events are dropped or merged, so this is done in place.
+    {
+        bw_music::TrackBuilder track;
+        track.addEvent(bw_music::PercussionOnEvent{0, "AcBass", 64});
+        track.addEvent(bw_music::PercussionOnEvent{0, "Clap", 64});
+        track.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "AcBass", 64});
+        track.addEvent(bw_music::PercussionOffEvent{0, "Clap", 64});
+        track.addEvent(bw_music::PercussionOnEvent{0, "Crash1", 64});
+        track.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "Crash1", 64});
+
+        bw_music::TrackBuilder expectedTrack;
+        expectedTrack.addEvent(bw_music::PercussionOnEvent{0, "AcBass", 64});
+        expectedTrack.addEvent(bw_music::PercussionOnEvent{0, "Cowbll", 64});
+        expectedTrack.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "AcBass", 64});
+        expectedTrack.addEvent(bw_music::PercussionOffEvent{0, "Cowbll", 64});
+        expectedTrack.addEvent(bw_music::PercussionOnEvent{0, "Crash2", 64});
+        expectedTrack.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "Crash2", 64});
+
+        BW_ASSERT_RESULT_ASSIGN(const bw_music::Track outputTrack,
+                                bw_music::mapPercussionFunction(typeSystem, track.finishAndGetTrack(), mapValue));
+        EXPECT_EQ(outputTrack, expectedTrack.finishAndGetTrack());
+    }
+}
+
+TEST(PercussionMapProcessorTest, funcIndexedInstruments) {
+    testUtils::TestLog log;
+
+    babelwires::TypeSystem typeSystem;
+    const babelwires::TypePtrT<bw_music::BuiltInPercussionInstruments> builtInPercussion =
+        typeSystem.addAndGetType<bw_music::BuiltInPercussionInstruments>();
+    typeSystem.addTypeConstructor<babelwires::EnumAtomTypeConstructor>();
+    typeSystem.addTypeConstructor<babelwires::EnumUnionTypeConstructor>();
+
+    const babelwires::MapValue mapValue = getTestPercussionMap(typeSystem);
+
+    const auto getIndex = [](babelwires::ShortId instrument) {
+        return bw_music::PercussionInstrumentIndex::tryGetIndex(instrument);
+    };
+    const bw_music::PercussionInstrumentIndex::Index clapIndex = getIndex("Clap");
+    ASSERT_NE(clapIndex, bw_music::PercussionInstrumentIndex::c_notInterned);
+
+    // Events created with and without an index are mapped the same way.
+    bw_music::TrackBuilder track;
+    track.addEvent(bw_music::PercussionOnEvent{0, "Clap", 64, clapIndex});
+    track.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "Clap", 64, clapIndex});
+    track.addEvent(bw_music::PercussionOnEvent{0, "Clap", 64});
+    track.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "Clap", 64});
+    track.addEvent(bw_music::PercussionOnEvent{0, "LFlTom", 64, getIndex("LFlTom")});
+    track.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "LFlTom", 64, getIndex("LFlTom")});
+
+    bw_music::TrackBuilder expectedTrack;
+    expectedTrack.addEvent(bw_music::PercussionOnEvent{0, "Cowbll", 64});
+    expectedTrack.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "Cowbll", 64});
+    expectedTrack.addEvent(bw_music::PercussionOnEvent{0, "Cowbll", 64});
+    expectedTrack.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 2), "Cowbll", 64});
+
+    BW_ASSERT_RESULT_ASSIGN(const bw_music::Track outputTrack,
+                            bw_music::mapPercussionFunction(typeSystem, track.finishAndGetTrack(), mapValue));
+    EXPECT_EQ(outputTrack, expectedTrack.finishAndGetTrack());
+
+    // The targets carry their index, so a further map can use it.
+    for (const auto& event : outputTrack) {
+        const auto& percussionEvent = static_cast<const bw_music::PercussionEvent&>(event);
+        EXPECT_EQ(percussionEvent.getInstrumentIndex(), getIndex("Cowbll"));
+    }
+}
+
 TEST(PercussionMapProcessorTest, processor) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
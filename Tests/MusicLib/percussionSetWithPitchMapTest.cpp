@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <MusicLib/Percussion/builtInPercussionInstruments.hpp>
+#include <MusicLib/Percussion/percussionInstrumentIndex.hpp>
 #include <MusicLib/Percussion/percussionSetWithPitchMap.hpp>
 
 #include <BabelWiresLib/TypeSystem/typeSystem.hpp>
@@ -194,3 +195,39 @@ TEST(PercussionSetWithPitchMapTest, duplicates) {
     EXPECT_FALSE(percussionSet.tryGetInstrumentFromPitch(49));
     EXPECT_FALSE(percussionSet.tryGetInstrumentFromPitch(52));
 }
+
+TEST(PercussionSetWithPitchMapTest, instrumentsAreInterned) {
+    testUtils::TestEnvironment testEnvironment;
+    const auto builtIns = testEnvironment.m_typeSystem.addAndGetType<bw_music::BuiltInPercussionInstruments>();
+
+    const babelwires::ShortId newInstrument = testUtils::getTestRegisteredIdentifier("Intrn");
+    bw_music::PercussionSetWithPitchMap::InstrumentBlock block = {
+        {bw_music::BuiltInPercussionInstruments::Value::HBongo, newInstrument}, 40, builtIns.get()};
+
+    TestPercussionSet percussionSet(block, 40);
+
+    const bw_music::PercussionInstrumentIndex::Index hBongoIndex =
+        bw_music::PercussionInstrumentIndex::tryGetIndex(percussionSet.getValueSet()[0]);
+    const bw_music::PercussionInstrumentIndex::Index newInstrumentIndex =
+        bw_music::PercussionInstrumentIndex::tryGetIndex(newInstrument);
+    ASSERT_NE(hBongoIndex, bw_music::PercussionInstrumentIndex::c_notInterned);
+    ASSERT_NE(newInstrumentIndex, bw_music::PercussionInstrumentIndex::c_notInterned);
+    EXPECT_NE(hBongoIndex, newInstrumentIndex);
+    EXPECT_LT(hBongoIndex, bw_music::PercussionInstrumentIndex::getNumInstruments());
+    EXPECT_LT(newInstrumentIndex, bw_music::PercussionInstrumentIndex::getNumInstruments());
+    EXPECT_EQ(bw_music::PercussionInstrumentIndex::getInstrument(hBongoIndex), percussionSet.getValueSet()[0]);
+    EXPECT_EQ(bw_music::PercussionInstrumentIndex::getInstrument(newInstrumentIndex), newInstrument);
+
+    const auto indexedInstrument = percussionSet.tryGetIndexedInstrumentFromPitch(41);
+    ASSERT_TRUE(indexedInstrument);
+    EXPECT_EQ(indexedInstrument->m_instrument, newInstrument);
+    EXPECT_EQ(indexedInstrument->m_instrumentIndex, newInstrumentIndex);
+    EXPECT_FALSE(percussionSet.tryGetIndexedInstrumentFromPitch(42));
+
+    // Interning again does not change the indices.
+    TestPercussionSet percussionSet2(block, 40);
+    EXPECT_EQ(bw_music::PercussionInstrumentIndex::tryGetIndex(newInstrument), newInstrumentIndex);
+
+    EXPECT_EQ(bw_music::PercussionInstrumentIndex::tryGetIndex(testUtils::getTestRegisteredIdentifier("NotIn")),
+              bw_music::PercussionInstrumentIndex::c_notInterned);
+}
@@ -13,6 +13,8 @@
 #include <Tests/TestUtils/seqTestUtils.hpp>
 #include <Tests/TestUtils/resultTestUtils.hpp>
 
+#include <array>
+
 TEST(QuantizeProcessorTest, funcSimple) {
     testUtils::TestLog log;
 
@@ -76,6 +78,79 @@ TEST(QuantizeProcessorTest, funcCollapsedGroup) {
     testUtils::testNotes({{60, 1}, {64, 1}, {65, 1}}, trackOut);
 }
 
+TEST(QuantizeProcessorTest, funcInPlaceMatchesCopy) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilderIn;
+
+    testUtils::addNotes(
+        {
+            {60, babelwires::Rational(16, 17), babelwires::Rational(1, 17)},
+            {62, babelwires::Rational(10, 17), babelwires::Rational(0, 17)},
+            {64, babelwires::Rational(18, 17), babelwires::Rational(1, 17)},
+            {65, babelwires::Rational(22, 17), babelwires::Rational(1, 17)},
+        },
+        trackBuilderIn);
+
+    const bw_music::Track trackIn = trackBuilderIn.finishAndGetTrack();
+    // With a beat of 2, the note 62 collapses, so the track has to be rebuilt.
+    for (const auto& beat : {babelwires::Rational(1, 2), babelwires::Rational(1, 8), babelwires::Rational(2, 1)}) {
+        BW_ASSERT_RESULT_ASSIGN(auto copiedTrack, bw_music::quantize(trackIn, beat));
+        bw_music::Track track = trackIn;
+        BW_ASSERT_RESULT_ASSIGN(auto movedTrack, bw_music::quantize(std::move(track), beat));
+        EXPECT_EQ(copiedTrack, movedTrack);
+    }
+}
+
+TEST(QuantizeProcessorTest, funcMultipleGrids) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackIn;
+
+    testUtils::addNotes(
+        {
+            {60, babelwires::Rational(8, 25)},
+            {62, babelwires::Rational(5, 25)},
+            {64, babelwires::Rational(12, 25)},
+        },
+        trackIn);
+
+    const std::array<bw_music::ModelDuration, 2> beats = {babelwires::Rational(1, 4), babelwires::Rational(1, 3)};
+    BW_ASSERT_RESULT_ASSIGN(auto trackOut, bw_music::quantize(trackIn.finishAndGetTrack(), beats));
+    testUtils::testNotes(
+        {{60, babelwires::Rational(1, 3)}, {62, babelwires::Rational(1, 6)}, {64, babelwires::Rational(1, 2)}},
+        trackOut);
+    EXPECT_EQ(trackOut.getDuration(), 1);
+}
+
+TEST(QuantizeProcessorTest, funcMultipleGridsTie) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackIn;
+
+    // 5/24 is equally close to 1/6 and 1/4, and the later point is preferred.
+    testUtils::addNotes({{60, babelwires::Rational(5, 24)}}, trackIn);
+
+    const std::array<bw_music::ModelDuration, 2> beats = {babelwires::Rational(1, 6), babelwires::Rational(1, 4)};
+    BW_ASSERT_RESULT_ASSIGN(auto trackOut, bw_music::quantize(trackIn.finishAndGetTrack(), beats));
+    testUtils::testNotes({{60, babelwires::Rational(1, 4)}}, trackOut);
+}
+
+TEST(QuantizeProcessorTest, funcZeroBeat) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackIn;
+    testUtils::addNotes({{60, babelwires::Rational(1, 4)}}, trackIn);
+    const bw_music::Track track = trackIn.finishAndGetTrack();
+
+    EXPECT_FALSE(bw_music::quantize(track, babelwires::Rational(0)).has_value());
+
+    // A zero beat is ignored when there are other beats.
+    const std::array<bw_music::ModelDuration, 2> beats = {babelwires::Rational(1, 2), babelwires::Rational(0)};
+    BW_ASSERT_RESULT_ASSIGN(auto trackOut, bw_music::quantize(track, beats));
+    testUtils::testNotes({{60, babelwires::Rational(1, 2)}}, trackOut);
+}
+
 TEST(QuantizeProcessorTest, processor) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
@@ -156,4 +231,14 @@ TEST(QuantizeProcessorTest, processor) {
                           {64, babelwires::Rational(1, 1), babelwires::Rational(1, 4)},
                           {65, babelwires::Rational(5, 4)}},
                          outArray.getEntry(0).get());
+
+    processor.getInput().clearChanges();
+    in.getBeat2().set(babelwires::Rational(1, 3));
+    processor.process(testEnvironment.m_log);
+
+    testUtils::testNotes({{60, babelwires::Rational(1, 1)},
+                          {62, babelwires::Rational(5, 3)},
+                          {64, babelwires::Rational(1, 1)},
+                          {65, babelwires::Rational(5, 4), babelwires::Rational(1, 12)}},
+                         outArray.getEntry(0).get());
 }
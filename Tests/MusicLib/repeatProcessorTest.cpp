@@ -51,6 +51,28 @@ TEST(RepeatProcessorTest, funcSimpleTwice) {
     testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{60, 62, 64, 65, 60, 62, 64, 65}, trackOut);
 }
 
+TEST(RepeatProcessorTest, funcManyWithGap) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilderIn;
+    testUtils::addNotes({{60, babelwires::Rational(1, 4), babelwires::Rational(1, 4)}, {62, babelwires::Rational(1, 4)}},
+                        trackBuilderIn);
+    const bw_music::Track trackIn = trackBuilderIn.finishAndGetTrack(1);
+
+    BW_ASSERT_RESULT_ASSIGN(auto trackOut, bw_music::repeatTrack(trackIn, 64));
+
+    EXPECT_EQ(trackOut.getDuration(), 64);
+    EXPECT_EQ(trackOut.getNumEvents(), 64 * trackIn.getNumEvents());
+
+    std::vector<testUtils::NoteInfo> expectedNotes;
+    for (int i = 0; i < 64; ++i) {
+        expectedNotes.emplace_back(
+            testUtils::NoteInfo{60, babelwires::Rational(1, 4), (i == 0) ? babelwires::Rational(1, 4) : babelwires::Rational(1, 2)});
+        expectedNotes.emplace_back(testUtils::NoteInfo{62, babelwires::Rational(1, 4)});
+    }
+    testUtils::testNotes(expectedNotes, trackOut);
+}
+
 TEST(RepeatProcessorTest, processor) {
     testUtils::TestEnvironment testEnvironment;
     bw_music::registerLib(testEnvironment.m_projectContext);
@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+
+#include <MusicLib/Utilities/runConcurrently.hpp>
+
+#include <atomic>
+#include <vector>
+
+TEST(RunConcurrentlyTest, eachTaskRunsOnce) {
+    for (unsigned int maxNumThreads : {0, 1, 2, 4, 100}) {
+        for (std::size_t numTasks : {0, 1, 3, 50}) {
+            std::vector<std::atomic<int>> numRuns(numTasks);
+            bw_music::runConcurrently(numTasks, [&](std::size_t i) { ++numRuns[i]; }, maxNumThreads);
+            for (std::size_t i = 0; i < numTasks; ++i) {
+                EXPECT_EQ(numRuns[i], 1) << "maxNumThreads " << maxNumThreads << " numTasks " << numTasks;
+            }
+        }
+    }
+}
+
+TEST(RunConcurrentlyTest, singleThreadRunsInOrder) {
+    std::vector<std::size_t> order;
+    bw_music::runConcurrently(10, [&](std::size_t i) { order.emplace_back(i); }, 1);
+    ASSERT_EQ(order.size(), 10);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <BabelWiresLib/ValueTree/valueTreeRoot.hpp>
+
+#include <MusicLib/Functions/sliceFunction.hpp>
+#include <MusicLib/Processors/sliceProcessor.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/libRegistration.hpp>
+
+#include <BabelWiresLib/Types/Rational/rationalValue.hpp>
+
+#include <Tests/BabelWiresLib/TestUtils/testEnvironment.hpp>
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+#include <Tests/TestUtils/resultTestUtils.hpp>
+
+#include <array>
+
+TEST(SliceProcessorTest, funcSimple) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackIn;
+    testUtils::addSimpleNotes(std::vector<bw_music::Pitch>{60, 62, 64, 65, 67, 69, 71, 72}, trackIn);
+
+    const std::array<bw_music::ModelDuration, 2> boundaries = {babelwires::Rational(1, 2), 1};
+    BW_ASSERT_RESULT_ASSIGN(auto slices, bw_music::sliceTrack(trackIn.finishAndGetTrack(), boundaries));
+
+    ASSERT_EQ(slices.size(), 3);
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{60, 62}, slices[0]);
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{64, 65}, slices[1]);
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{67, 69, 71, 72}, slices[2]);
+    EXPECT_EQ(slices[0].getDuration(), babelwires::Rational(1, 2));
+    EXPECT_EQ(slices[1].getDuration(), babelwires::Rational(1, 2));
+    EXPECT_EQ(slices[2].getDuration(), 1);
+}
+
+TEST(SliceProcessorTest, funcNoBoundaries) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackIn;
+    testUtils::addSimpleNotes(std::vector<bw_music::Pitch>{60, 62, 64, 65}, trackIn);
+
+    BW_ASSERT_RESULT_ASSIGN(auto slices, bw_music::sliceTrack(trackIn.finishAndGetTrack(), {}));
+
+    ASSERT_EQ(slices.size(), 1);
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{60, 62, 64, 65}, slices[0]);
+}
+
+TEST(SliceProcessorTest, funcReopenSpanningGroup) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackIn;
+    testUtils::addNotes({{60, 1}, {62, babelwires::Rational(1, 2)}}, trackIn);
+
+    const std::array<bw_music::ModelDuration, 3> boundaries = {babelwires::Rational(1, 4), babelwires::Rational(3, 4),
+                                                               babelwires::Rational(5, 4)};
+    BW_ASSERT_RESULT_ASSIGN(auto slices, bw_music::sliceTrack(trackIn.finishAndGetTrack(), boundaries));
+
+    ASSERT_EQ(slices.size(), 4);
+    testUtils::testNotes({{60, babelwires::Rational(1, 4)}}, slices[0]);
+    testUtils::testNotes({{60, babelwires::Rational(1, 2)}}, slices[1]);
+    testUtils::testNotes({{60, babelwires::Rational(1, 4)}, {62, babelwires::Rational(1, 4)}}, slices[2]);
+    testUtils::testNotes({{62, babelwires::Rational(1, 4)}}, slices[3]);
+}
+
+TEST(SliceProcessorTest, funcBoundariesBeyondEnd) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackIn;
+    testUtils::addSimpleNotes(std::vector<bw_music::Pitch>{60, 62}, trackIn);
+
+    const std::array<bw_music::ModelDuration, 3> boundaries = {babelwires::Rational(1, 2),
+                                                               babelwires::Rational(1, 2), 2};
+    BW_ASSERT_RESULT_ASSIGN(auto slices, bw_music::sliceTrack(trackIn.finishAndGetTrack(), boundaries));
+
+    ASSERT_EQ(slices.size(), 4);
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{60, 62}, slices[0]);
+    EXPECT_EQ(slices[1].getNumEvents(), 0);
+    EXPECT_EQ(slices[1].getDuration(), 0);
+    EXPECT_EQ(slices[2].getNumEvents(), 0);
+    EXPECT_EQ(slices[2].getDuration(), babelwires::Rational(3, 2));
+    EXPECT_EQ(slices[3].getNumEvents(), 0);
+    EXPECT_EQ(slices[3].getDuration(), 0);
+}
+
+TEST(SliceProcessorTest, funcDecreasingBoundaries) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackIn;
+    testUtils::addSimpleNotes(std::vector<bw_music::Pitch>{60, 62}, trackIn);
+
+    const std::array<bw_music::ModelDuration, 2> boundaries = {babelwires::Rational(1, 2), babelwires::Rational(1, 4)};
+    EXPECT_FALSE(bw_music::sliceTrack(trackIn.finishAndGetTrack(), boundaries).has_value());
+}
+
+TEST(SliceProcessorTest, processor) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+
+    bw_music::SliceProcessor processor(testEnvironment.m_projectContext);
+
+    processor.getInput().setToDefault();
+    processor.getOutput().setToDefault();
+
+    auto input = bw_music::SliceProcessorInput::Instance(processor.getInput());
+    const auto output = bw_music::SliceProcessorOutput::ConstInstance(processor.getOutput());
+
+    EXPECT_EQ(input.getBounds().getSize(), 0);
+    EXPECT_EQ(output.getSlices().getSize(), 1);
+
+    {
+        bw_music::TrackBuilder track;
+        testUtils::addSimpleNotes(std::vector<bw_music::Pitch>{60, 62, 64, 65, 67, 69, 71, 72}, track);
+        input.getInput().set(track.finishAndGetTrack());
+        input.getBounds().setSize(1);
+        input.getBounds().getEntry(0).set(1);
+    }
+    processor.process(testEnvironment.m_log);
+
+    ASSERT_EQ(output.getSlices().getSize(), 2);
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{60, 62, 64, 65}, output.getSlices().getEntry(0).get());
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{67, 69, 71, 72}, output.getSlices().getEntry(1).get());
+
+    processor.getInput().clearChanges();
+    {
+        input.getBounds().setSize(2);
+        input.getBounds().getEntry(0).set(babelwires::Rational(1, 2));
+        input.getBounds().getEntry(1).set(babelwires::Rational(3, 2));
+    }
+    processor.process(testEnvironment.m_log);
+
+    ASSERT_EQ(output.getSlices().getSize(), 3);
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{60, 62}, output.getSlices().getEntry(0).get());
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{64, 65, 67, 69}, output.getSlices().getEntry(1).get());
+    testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{71, 72}, output.getSlices().getEntry(2).get());
+}
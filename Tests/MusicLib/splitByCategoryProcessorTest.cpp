@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <BabelWiresLib/ValueTree/valueTreeRoot.hpp>
+
+#include <MusicLib/Functions/splitByCategoryFunction.hpp>
+#include <MusicLib/Processors/splitByCategoryProcessor.hpp>
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/libRegistration.hpp>
+
+#include <Tests/BabelWiresLib/TestUtils/testEnvironment.hpp>
+
+#include <Tests/TestUtils/seqTestUtils.hpp>
+#include <Tests/TestUtils/testTrackEvents.hpp>
+
+namespace {
+    bw_music::Track getTrackOfNotesAndChords() {
+        bw_music::TrackBuilder trackBuilder;
+        trackBuilder.addEvent(bw_music::ChordOnEvent{
+            babelwires::Rational(1, 4), {bw_music::PitchClass::Value::C, bw_music::ChordType::Value::M}});
+        trackBuilder.addEvent(bw_music::NoteOnEvent{0, 60});
+        trackBuilder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 60});
+        trackBuilder.addEvent(bw_music::NoteOnEvent{babelwires::Rational(1, 4), 62});
+        trackBuilder.addEvent(bw_music::ChordOffEvent{babelwires::Rational(1, 4)});
+        trackBuilder.addEvent(bw_music::NoteOffEvent{0, 62});
+        trackBuilder.addEvent(bw_music::ChordOnEvent{
+            babelwires::Rational(1, 2), {bw_music::PitchClass::Value::D, bw_music::ChordType::Value::m}});
+        trackBuilder.addEvent(bw_music::ChordOffEvent{babelwires::Rational(1, 2)});
+        return trackBuilder.finishAndGetTrack(3);
+    }
+} // namespace
+
+TEST(SplitByCategoryProcessorTest, funcNotesAndChords) {
+    testUtils::TestLog log;
+
+    const bw_music::SplitByCategoryResult result = bw_music::splitByCategory(getTrackOfNotesAndChords());
+
+    const std::vector<testUtils::NoteInfo> expectedNotes{
+        {60, babelwires::Rational(1, 4), babelwires::Rational(1, 4)},
+        {62, babelwires::Rational(1, 4), babelwires::Rational(1, 4)},
+    };
+    testUtils::testNotes(expectedNotes, result.m_notes);
+    EXPECT_EQ(result.m_notes.getDuration(), 3);
+
+    const std::vector<testUtils::ChordInfo> expectedChords{
+        {{bw_music::PitchClass::Value::C, bw_music::ChordType::Value::M}, babelwires::Rational(3, 4),
+         babelwires::Rational(1, 4)},
+        {{bw_music::PitchClass::Value::D, bw_music::ChordType::Value::m}, babelwires::Rational(1, 2),
+         babelwires::Rational(1, 2)},
+    };
+    testUtils::testChords(expectedChords, result.m_chords);
+    EXPECT_EQ(result.m_chords.getDuration(), 3);
+
+    EXPECT_EQ(result.m_percussion.getNumEvents(), 0);
+    EXPECT_EQ(result.m_percussion.getDuration(), 3);
+    EXPECT_EQ(result.m_other.getNumEvents(), 0);
+    EXPECT_EQ(result.m_other.getDuration(), 3);
+}
+
+TEST(SplitByCategoryProcessorTest, funcSingleCategory) {
+    testUtils::TestLog log;
+
+    const bw_music::Track track = testUtils::getTrackOfSimpleNotes({60, 62, 64, 65});
+    const bw_music::SplitByCategoryResult result = bw_music::splitByCategory(track);
+
+    EXPECT_EQ(result.m_notes, track);
+    EXPECT_EQ(result.m_chords.getNumEvents(), 0);
+    EXPECT_EQ(result.m_chords.getDuration(), 1);
+}
+
+TEST(SplitByCategoryProcessorTest, funcSingleCategoryAndGenericEvents) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(testUtils::TestTrackEvent{0, 1});
+    trackBuilder.addEvent(bw_music::NoteOnEvent{babelwires::Rational(1, 4), 60});
+    trackBuilder.addEvent(testUtils::TestTrackEvent{babelwires::Rational(1, 4), 2});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 60});
+    const bw_music::Track track = trackBuilder.finishAndGetTrack(1);
+
+    const bw_music::SplitByCategoryResult result = bw_music::splitByCategory(track);
+
+    testUtils::testNotes({{60, babelwires::Rational(1, 2), babelwires::Rational(1, 4)}}, result.m_notes);
+    EXPECT_EQ(result.m_notes.getDuration(), 1);
+    EXPECT_EQ(result.m_chords.getNumEvents(), 0);
+    EXPECT_EQ(result.m_percussion.getNumEvents(), 0);
+
+    ASSERT_EQ(result.m_other.getNumEvents(), 2);
+    EXPECT_EQ(result.m_other.getDuration(), 1);
+    auto it = result.m_other.begin();
+    auto event0 = it->tryAs<const testUtils::TestTrackEvent>();
+    ASSERT_NE(event0, nullptr);
+    EXPECT_EQ(event0->m_value, 1);
+    EXPECT_EQ(event0->getTimeSinceLastEvent(), 0);
+    ++it;
+    auto event1 = it->tryAs<const testUtils::TestTrackEvent>();
+    ASSERT_NE(event1, nullptr);
+    EXPECT_EQ(event1->m_value, 2);
+    EXPECT_EQ(event1->getTimeSinceLastEvent(), babelwires::Rational(1, 2));
+}
+
+TEST(SplitByCategoryProcessorTest, processor) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+
+    bw_music::SplitByCategoryProcessor processor(testEnvironment.m_projectContext);
+    bw_music::SplitByCategoryProcessorInput::Instance in(processor.getInput());
+    const bw_music::SplitByCategoryProcessorOutput::ConstInstance out(processor.getOutput());
+
+    in.getInput().set(getTrackOfNotesAndChords());
+    processor.process(testEnvironment.m_log);
+
+    EXPECT_EQ(out.getNotes().get().getNumEvents(), 4);
+    EXPECT_EQ(out.getChords().get().getNumEvents(), 4);
+    EXPECT_EQ(out.getPercus().get().getNumEvents(), 0);
+    EXPECT_EQ(out.getOther().get().getNumEvents(), 0);
+}
@@ -467,3 +467,25 @@ TEST(TrackBuilderTest, builder_InvalidMixture) {
     }
     EXPECT_EQ(goodEventCount, goodEvents.getNumEvents());
 }
+
+TEST(TrackBuilderTest, builder_addEventsOfTrackWithOpenGroup) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilderIn;
+    trackBuilderIn.addEvent(bw_music::NoteOnEvent(0, 60));
+    trackBuilderIn.addEvent(bw_music::NoteOffEvent(babelwires::Rational(1, 4), 60));
+    trackBuilderIn.addEvent(bw_music::NoteOnEvent(0, 62));
+    trackBuilderIn.addEvent(bw_music::NoteOffEvent(babelwires::Rational(1, 4), 62));
+    const bw_music::Track trackIn = trackBuilderIn.finishAndGetTrack();
+
+    // The note 60 is still open, so the events of trackIn have to be checked.
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(bw_music::NoteOnEvent(0, 60));
+    trackBuilder.addEventsOfTrack(trackIn, babelwires::Rational(1, 8));
+    const bw_music::Track builtTrack = trackBuilder.finishAndGetTrack();
+
+    // The second start of 60 is dropped, so the first note ends at the end of the second.
+    EXPECT_TRUE(bw_music::isTrackValid(builtTrack));
+    EXPECT_EQ(builtTrack.getDuration(), babelwires::Rational(5, 8));
+    testUtils::testNotes({{60, babelwires::Rational(3, 8)}, {62, babelwires::Rational(1, 4)}}, builtTrack);
+}
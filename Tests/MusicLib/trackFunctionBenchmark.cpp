@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <MusicLib/Functions/monophonicSubtracksFunction.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Utilities/concurrentEventModifier.hpp>
+
+#include <Tests/TestUtils/resultTestUtils.hpp>
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <tuple>
+
+// These are benchmarks of the track functions which are expensive on long or dense tracks. They are disabled by
+// default.
+// Run them with --gtest_also_run_disabled_tests --gtest_filter=TrackFunctionBenchmark.*
+
+namespace {
+    constexpr int numRepetitions = 20;
+
+    /// Apply the function to the track repeatedly and report the number of events processed per second.
+    void reportThroughput(const std::string& description, const bw_music::Track& track,
+                          const std::function<void(const bw_music::Track&)>& function) {
+        const auto startTime = std::chrono::steady_clock::now();
+        for (int i = 0; i < numRepetitions; ++i) {
+            function(track);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+        const double numEvents = static_cast<double>(track.getNumEvents()) * numRepetitions;
+        std::cout << description << ": " << track.getNumEvents() << " events in "
+                  << (elapsed.count() / numRepetitions) << " s = " << (numEvents / elapsed.count()) << " events/s"
+                  << std::endl;
+    }
+} // namespace
+
+TEST(TrackFunctionBenchmark, DISABLED_monophonicSubtracks) {
+    const std::tuple<bw_music::MonophonicSubtracksPolicyEnum::Value, const char*> policies[] = {
+        {bw_music::MonophonicSubtracksPolicyEnum::Value::High, "High"},
+        {bw_music::MonophonicSubtracksPolicyEnum::Value::Low, "Low"},
+        {bw_music::MonophonicSubtracksPolicyEnum::Value::HighEv, "HighEv"},
+        {bw_music::MonophonicSubtracksPolicyEnum::Value::LowEv, "LowEv"}};
+
+    // The cost of assigning a note used to grow with the number of subtracks and the number of sounding notes, so
+    // measure a sparse and a dense score against a small and a large number of subtracks.
+    for (int notesPerStep : {4, 24}) {
+        const bw_music::Track track = testUtils::getDensePolyphonicTrack(4096, notesPerStep);
+        for (int numTracks : {4, 32}) {
+            for (const auto& [policy, policyName] : policies) {
+                const std::string description = std::string("getMonophonicSubtracks ") + policyName + " " +
+                                                std::to_string(notesPerStep) + " notes per step into " +
+                                                std::to_string(numTracks) + " tracks";
+                reportThroughput(description, track, [numTracks, policy](const bw_music::Track& track) {
+                    BW_ASSERT_RESULT_ASSIGN(bw_music::MonophonicSubtracksResult result,
+                                            bw_music::getMonophonicSubtracks(track, numTracks, policy));
+                    EXPECT_EQ(result.m_noteTracks.size(), numTracks);
+                });
+            }
+        }
+    }
+}
+
+TEST(TrackFunctionBenchmark, DISABLED_modifyEventsConcurrently) {
+    // A cheap modifier, like the ones used by transpose, so the cost of splitting and joining segments shows.
+    const bw_music::EventSelector isNote = [](const bw_music::TrackEvent& event) {
+        return event.tryAs<bw_music::NoteEvent>() != nullptr;
+    };
+    const bw_music::EventSelector selectNone = [](const bw_music::TrackEvent& event) { return false; };
+    const bw_music::EventModifier transposeUp = [](bw_music::TrackEvent& event) {
+        auto& noteEvent = static_cast<bw_music::NoteEvent&>(event);
+        noteEvent.setPitch(noteEvent.getPitch() + 1);
+        return true;
+    };
+
+    // About a million events, with one segment (the serial path) and 2, 4 and 8 segments, each run on its own thread.
+    // Selecting no events measures the cost of building the track when nothing has to be copied and modified.
+    const bw_music::Track track = testUtils::getDensePolyphonicTrack(1 << 17, 4);
+    for (const auto& [selector, selectorName] :
+         {std::tuple{&isNote, "all notes"}, std::tuple{&selectNone, "no events"}}) {
+        for (unsigned int numSegments : {1u, 2u, 4u, 8u}) {
+            const std::string description = std::string("modifyEventsConcurrently of ") + selectorName + " with " +
+                                            std::to_string(numSegments) + " segments";
+            reportThroughput(description, track, [&, selector = selector, numSegments](const bw_music::Track& track) {
+                const bw_music::Track trackOut =
+                    bw_music::modifyEventsConcurrently(track, *selector, transposeUp, numSegments);
+                EXPECT_EQ(trackOut.getNumEvents(), track.getNumEvents());
+            });
+        }
+    }
+}
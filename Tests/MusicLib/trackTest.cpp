@@ -1,14 +1,20 @@
 #include <gtest/gtest.h>
 
+#include <MusicLib/Functions/quantizeFunction.hpp>
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
 #include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
 #include <MusicLib/Types/Track/track.hpp>
 #include <MusicLib/Types/Track/trackBuilder.hpp>
 
+#include <Tests/TestUtils/resultTestUtils.hpp>
 #include <Tests/TestUtils/seqTestUtils.hpp>
 #include <Tests/TestUtils/testTrackEvents.hpp>
 
 #include <Tests/TestUtils/testLog.hpp>
 
+#include <algorithm>
+#include <type_traits>
+
 TEST(Track, Simple) {
     testUtils::TestLog log;
 
@@ -126,4 +132,156 @@ TEST(Track, equality) {
     EXPECT_NE(trackWithDifferentNotes, trackWithNotes);
     EXPECT_NE(trackWithNotes, trackWithMoreNotes);
     EXPECT_NE(trackWithNotes, trackWithSameNotesLongerDuration);
-}
\ No newline at end of file
+}
+
+TEST(Track, chordSummary) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(bw_music::ChordOnEvent{0, {bw_music::PitchClass::Value::C, bw_music::ChordType::Value::M}});
+    trackBuilder.addEvent(bw_music::ChordOffEvent{1});
+    trackBuilder.addEvent(bw_music::ChordOnEvent{0, {bw_music::PitchClass::Value::D, bw_music::ChordType::Value::m}});
+    trackBuilder.addEvent(bw_music::ChordOffEvent{1});
+    trackBuilder.addEvent(bw_music::ChordOnEvent{0, {bw_music::PitchClass::Value::C, bw_music::ChordType::Value::m}});
+    trackBuilder.addEvent(bw_music::ChordOffEvent{1});
+    testUtils::addSimpleNotes(std::vector<bw_music::Pitch>{60, 62}, trackBuilder);
+    bw_music::Track track = trackBuilder.finishAndGetTrack();
+
+    bw_music::ChordTypeBitset expectedChordTypes;
+    expectedChordTypes.set(static_cast<std::size_t>(bw_music::ChordType::Value::M));
+    expectedChordTypes.set(static_cast<std::size_t>(bw_music::ChordType::Value::m));
+    EXPECT_EQ(track.getChordTypesUsed(), expectedChordTypes);
+
+    bw_music::PitchClassBitset expectedRoots;
+    expectedRoots.set(static_cast<std::size_t>(bw_music::PitchClass::Value::C));
+    expectedRoots.set(static_cast<std::size_t>(bw_music::PitchClass::Value::D));
+    EXPECT_EQ(track.getChordRootsUsed(), expectedRoots);
+
+    const bw_music::Track noteTrack = testUtils::getTrackOfSimpleNotes(std::vector<bw_music::Pitch>{60, 62});
+    EXPECT_TRUE(noteTrack.getChordTypesUsed().none());
+    EXPECT_TRUE(noteTrack.getChordRootsUsed().none());
+}
+
+TEST(Track, noteSpans) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(bw_music::NoteOnEvent{0, 60, 100});
+    trackBuilder.addEvent(bw_music::NoteOnEvent{babelwires::Rational(1, 4), 64, 90});
+    trackBuilder.addEvent(bw_music::ChordOnEvent{0, {bw_music::PitchClass::Value::C, bw_music::ChordType::Value::M}});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 60});
+    trackBuilder.addEvent(bw_music::NoteOnEvent{0, 60, 80});
+    trackBuilder.addEvent(bw_music::ChordOffEvent{babelwires::Rational(1, 4)});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{0, 64});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 2), 60});
+    const bw_music::Track track = trackBuilder.finishAndGetTrack(2);
+
+    const bw_music::NoteSpans expectedSpans = {
+        {0, babelwires::Rational(1, 2), 60, 100},
+        {babelwires::Rational(1, 4), babelwires::Rational(1, 2), 64, 90},
+        {babelwires::Rational(1, 2), babelwires::Rational(3, 4), 60, 80},
+    };
+    const bw_music::NoteSpans& noteSpans = track.getNoteSpans();
+    EXPECT_EQ(noteSpans, expectedSpans);
+
+    // Computed once and shared by copies.
+    EXPECT_EQ(&track.getNoteSpans(), &noteSpans);
+    bw_music::Track copyOfTrack = track;
+    EXPECT_EQ(&copyOfTrack.getNoteSpans(), &noteSpans);
+
+    // Moving a track transfers the cache.
+    const bw_music::Track movedTrack = std::move(copyOfTrack);
+    EXPECT_EQ(&movedTrack.getNoteSpans(), &noteSpans);
+    static_assert(std::is_nothrow_move_constructible_v<bw_music::Track>);
+
+    EXPECT_TRUE(bw_music::Track(4).getNoteSpans().empty());
+}
+
+TEST(Track, trackFromNoteSpans) {
+    testUtils::TestLog log;
+
+    const bw_music::Track track = testUtils::getTrackOfSimpleNotes({60, 62, 64, 65});
+
+    // Reversing the spans does not matter, since they are sorted.
+    bw_music::NoteSpans noteSpans = track.getNoteSpans();
+    std::reverse(noteSpans.begin(), noteSpans.end());
+    // Spans without a positive duration are ignored.
+    noteSpans.emplace_back(bw_music::NoteSpan{babelwires::Rational(1, 2), 0, 70, 127});
+
+    const bw_music::Track trackFromSpans = bw_music::trackFromNoteSpans(noteSpans, 0);
+    EXPECT_EQ(trackFromSpans, track);
+    EXPECT_EQ(trackFromSpans.getNoteSpans(), track.getNoteSpans());
+
+    // Overlapping notes of different pitches are ordered as a TrackBuilder would order them.
+    const bw_music::NoteSpans overlappingSpans = {
+        {babelwires::Rational(1, 4), babelwires::Rational(1, 2), 64, 127},
+        {0, babelwires::Rational(1, 2), 60, 127},
+        {babelwires::Rational(1, 2), babelwires::Rational(1, 4), 60, 127},
+    };
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(bw_music::NoteOnEvent{0, 60});
+    trackBuilder.addEvent(bw_music::NoteOnEvent{babelwires::Rational(1, 4), 64});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 60});
+    trackBuilder.addEvent(bw_music::NoteOnEvent{0, 60});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 4), 64});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{0, 60});
+    const bw_music::Track expectedTrack = trackBuilder.finishAndGetTrack(4);
+    EXPECT_EQ(bw_music::trackFromNoteSpans(overlappingSpans, 4), expectedTrack);
+}
+
+TEST(Track, minimumDenominator) {
+    testUtils::TestLog log;
+
+    EXPECT_EQ(bw_music::Track().getMinimumDenominator(), 1);
+
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(bw_music::NoteOnEvent{babelwires::Rational(1, 4), 60});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 6), 60});
+    trackBuilder.addEvent(bw_music::NoteOnEvent{babelwires::Rational(3, 8), 62});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{1, 62});
+    bw_music::Track track = trackBuilder.finishAndGetTrack();
+    EXPECT_EQ(track.getMinimumDenominator(), 24);
+
+    // Recomputed when the events are modified in place.
+    BW_ASSERT_RESULT_ASSIGN(const bw_music::Track quantizedTrack,
+                            bw_music::quantize(std::move(track), babelwires::Rational(1, 8)));
+    EXPECT_EQ(quantizedTrack.getMinimumDenominator(), 8);
+}
+
+TEST(Track, deferred) {
+    testUtils::TestLog log;
+
+    const bw_music::Track loadedTrack = testUtils::getTrackOfSimpleNotes({60, 62, 64, 65});
+    int numLoads = 0;
+    const bw_music::Track deferredTrack = bw_music::Track::createDeferred([&loadedTrack, &numLoads]() {
+        ++numLoads;
+        return loadedTrack;
+    });
+    const bw_music::Track copyOfDeferredTrack = deferredTrack;
+    EXPECT_TRUE(deferredTrack.isDeferred());
+    EXPECT_EQ(numLoads, 0);
+
+    // Copies of a deferred track are equal without it being loaded.
+    EXPECT_EQ(copyOfDeferredTrack, deferredTrack);
+    EXPECT_EQ(numLoads, 0);
+
+    EXPECT_EQ(deferredTrack.getNumEvents(), loadedTrack.getNumEvents());
+    EXPECT_EQ(numLoads, 1);
+    EXPECT_EQ(deferredTrack.getDuration(), loadedTrack.getDuration());
+    EXPECT_EQ(deferredTrack.getHash(), loadedTrack.getHash());
+    EXPECT_EQ(deferredTrack, loadedTrack);
+    EXPECT_EQ(loadedTrack, copyOfDeferredTrack);
+    EXPECT_TRUE(std::equal(deferredTrack.begin(), deferredTrack.end(), loadedTrack.begin(), loadedTrack.end()));
+    EXPECT_EQ(copyOfDeferredTrack.getNoteSpans(), loadedTrack.getNoteSpans());
+    // The copies share the loaded contents.
+    EXPECT_EQ(numLoads, 1);
+
+    // A deferred track is loaded before it is modified.
+    bw_music::Track modifiedTrack = copyOfDeferredTrack;
+    modifiedTrack.setDuration(8);
+    EXPECT_FALSE(modifiedTrack.isDeferred());
+    EXPECT_EQ(modifiedTrack.getNumEvents(), loadedTrack.getNumEvents());
+    EXPECT_EQ(modifiedTrack.getDuration(), 8);
+    EXPECT_EQ(copyOfDeferredTrack.getDuration(), loadedTrack.getDuration());
+    EXPECT_EQ(numLoads, 1);
+}
@@ -101,6 +101,22 @@ TEST(TransposeProcessorTest, funcSimpleNegativeLimitMap) {
     testUtils::testSimpleNotes(std::vector<bw_music::Pitch>{2, 1, 11, 9, 11, 1, 2}, trackOut);
 }
 
+TEST(TransposeProcessorTest, funcInPlaceMatchesCopy) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilder;
+    testUtils::addSimpleNotes(std::vector<bw_music::Pitch>{60, 62, 64, 65}, trackBuilder);
+    const bw_music::Track trackIn = trackBuilder.finishAndGetTrack();
+
+    for (int offset : {-60, -1, 0, 5, 62, 63}) {
+        BW_ASSERT_RESULT_ASSIGN(auto copiedTrack, bw_music::transposeTrack(trackIn, offset));
+        bw_music::Track track = trackIn;
+        BW_ASSERT_RESULT_ASSIGN(auto movedTrack, bw_music::transposeTrack(std::move(track), offset));
+        EXPECT_EQ(copiedTrack, movedTrack);
+        EXPECT_TRUE(bw_music::isTrackValid(movedTrack));
+    }
+}
+
 TEST(TransposeProcessorTest, funcSimpleChordsZero) {
     testUtils::TestLog log;
 
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <BabelWiresLib/ValueTree/valueTreeRoot.hpp>
+
+#include <MusicLib/Functions/trimFunction.hpp>
+#include <MusicLib/Processors/trimProcessor.hpp>
+#include <MusicLib/Types/Track/TrackEvents/chordEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/noteEvents.hpp>
+#include <MusicLib/Types/Track/TrackEvents/percussionEvents.hpp>
+#include <MusicLib/Types/Track/trackBuilder.hpp>
+#include <MusicLib/Types/Track/trackInstance.hpp>
+#include <MusicLib/libRegistration.hpp>
+
+#include <Tests/BabelWiresLib/TestUtils/testEnvironment.hpp>
+#include <Tests/TestUtils/seqTestUtils.hpp>
+
+#include <Tests/TestUtils/resultTestUtils.hpp>
+
+namespace {
+    /// Two notes with half a beat of silence before them, in a track of duration 4.
+    bw_music::Track getTrackWithSilence() {
+        bw_music::TrackBuilder trackBuilder;
+        testUtils::addNotes({{60, babelwires::Rational(1, 4), babelwires::Rational(1, 2)}, {62}}, trackBuilder);
+        return trackBuilder.finishAndGetTrack(4);
+    }
+} // namespace
+
+TEST(TrimProcessorTest, funcModes) {
+    testUtils::TestLog log;
+
+    const bw_music::Track trackIn = getTrackWithSilence();
+    const std::vector<testUtils::NoteInfo> expectedNotesAfterStartTrim = {{60}, {62}};
+    const std::vector<testUtils::NoteInfo> expectedNotesWithoutStartTrim = {
+        {60, babelwires::Rational(1, 4), babelwires::Rational(1, 2)}, {62}};
+
+    EXPECT_FALSE(bw_music::isTrimmed(trackIn, bw_music::TrimModeEnum::Value::Start));
+    BW_ASSERT_RESULT_ASSIGN(auto startTrimmed, bw_music::trimTrack(trackIn, bw_music::TrimModeEnum::Value::Start));
+    EXPECT_EQ(startTrimmed.getDuration(), babelwires::Rational(7, 2));
+    testUtils::testNotes(expectedNotesAfterStartTrim, startTrimmed);
+    EXPECT_FALSE(bw_music::isTrimmed(startTrimmed, bw_music::TrimModeEnum::Value::Both));
+    EXPECT_TRUE(bw_music::isTrimmed(startTrimmed, bw_music::TrimModeEnum::Value::Start));
+
+    EXPECT_FALSE(bw_music::isTrimmed(trackIn, bw_music::TrimModeEnum::Value::End));
+    BW_ASSERT_RESULT_ASSIGN(auto endTrimmed, bw_music::trimTrack(trackIn, bw_music::TrimModeEnum::Value::End));
+    EXPECT_EQ(endTrimmed.getDuration(), 1);
+    testUtils::testNotes(expectedNotesWithoutStartTrim, endTrimmed);
+    EXPECT_TRUE(bw_music::isTrimmed(endTrimmed, bw_music::TrimModeEnum::Value::End));
+
+    BW_ASSERT_RESULT_ASSIGN(auto bothTrimmed, bw_music::trimTrack(trackIn, bw_music::TrimModeEnum::Value::Both));
+    EXPECT_EQ(bothTrimmed.getDuration(), babelwires::Rational(1, 2));
+    testUtils::testNotes(expectedNotesAfterStartTrim, bothTrimmed);
+    EXPECT_TRUE(bw_music::isTrimmed(bothTrimmed, bw_music::TrimModeEnum::Value::Both));
+
+    const bw_music::TrimmedInterval interval =
+        bw_music::getTrimmedInterval(trackIn, bw_music::TrimModeEnum::Value::Both);
+    EXPECT_EQ(interval.m_start, babelwires::Rational(1, 2));
+    EXPECT_EQ(interval.m_end, 1);
+    EXPECT_FALSE(bw_music::isTrimmed(trackIn, interval));
+    BW_ASSERT_RESULT_ASSIGN(auto intervalTrimmed, bw_music::trimTrack(trackIn, interval));
+    EXPECT_EQ(intervalTrimmed, bothTrimmed);
+}
+
+TEST(TrimProcessorTest, funcNoSoundingEvents) {
+    testUtils::TestLog log;
+
+    // A track with nothing sounding is left alone.
+    const bw_music::Track emptyTrack(4);
+    EXPECT_TRUE(bw_music::isTrimmed(emptyTrack, bw_music::TrimModeEnum::Value::Both));
+    BW_ASSERT_RESULT_ASSIGN(auto trimmedEmpty, bw_music::trimTrack(emptyTrack, bw_music::TrimModeEnum::Value::Both));
+    EXPECT_EQ(trimmedEmpty.getDuration(), 4);
+}
+
+TEST(TrimProcessorTest, funcChords) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(bw_music::ChordOnEvent{1, {bw_music::PitchClass::Value::C, bw_music::ChordType::Value::M}});
+    trackBuilder.addEvent(bw_music::ChordOffEvent{1});
+    const bw_music::Track trackIn = trackBuilder.finishAndGetTrack(4);
+
+    EXPECT_FALSE(bw_music::isTrimmed(trackIn, bw_music::TrimModeEnum::Value::Both));
+    BW_ASSERT_RESULT_ASSIGN(auto trimmedChords, bw_music::trimTrack(trackIn, bw_music::TrimModeEnum::Value::Both));
+    EXPECT_EQ(trimmedChords.getDuration(), 1);
+    EXPECT_EQ(trimmedChords.getNumEvents(), 2);
+    EXPECT_TRUE(bw_music::isTrimmed(trimmedChords, bw_music::TrimModeEnum::Value::Both));
+}
+
+TEST(TrimProcessorTest, funcPercussion) {
+    testUtils::TestLog log;
+
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(bw_music::PercussionOnEvent{babelwires::Rational(1, 2), "AcBass", 64});
+    trackBuilder.addEvent(bw_music::PercussionOffEvent{babelwires::Rational(1, 4), "AcBass", 64});
+    const bw_music::Track trackIn = trackBuilder.finishAndGetTrack(4);
+
+    BW_ASSERT_RESULT_ASSIGN(auto startTrimmed, bw_music::trimTrack(trackIn, bw_music::TrimModeEnum::Value::Start));
+    EXPECT_EQ(startTrimmed.getDuration(), babelwires::Rational(7, 2));
+    EXPECT_EQ(startTrimmed.getNumEvents(), 2);
+
+    BW_ASSERT_RESULT_ASSIGN(auto bothTrimmed, bw_music::trimTrack(trackIn, bw_music::TrimModeEnum::Value::Both));
+    EXPECT_EQ(bothTrimmed.getDuration(), babelwires::Rational(1, 4));
+    EXPECT_EQ(bothTrimmed.getNumEvents(), 2);
+}
+
+TEST(TrimProcessorTest, funcNotesAndChords) {
+    testUtils::TestLog log;
+
+    // The chord starts before the note and the note ends after the chord.
+    bw_music::TrackBuilder trackBuilder;
+    trackBuilder.addEvent(bw_music::ChordOnEvent{1, {bw_music::PitchClass::Value::C, bw_music::ChordType::Value::M}});
+    trackBuilder.addEvent(bw_music::NoteOnEvent{babelwires::Rational(1, 2), 60});
+    trackBuilder.addEvent(bw_music::ChordOffEvent{babelwires::Rational(1, 2)});
+    trackBuilder.addEvent(bw_music::NoteOffEvent{babelwires::Rational(1, 2), 60});
+    const bw_music::Track trackIn = trackBuilder.finishAndGetTrack(4);
+
+    BW_ASSERT_RESULT_ASSIGN(auto bothTrimmed, bw_music::trimTrack(trackIn, bw_music::TrimModeEnum::Value::Both));
+    EXPECT_EQ(bothTrimmed.getDuration(), babelwires::Rational(3, 2));
+    EXPECT_EQ(bothTrimmed.getNumEvents(), 4);
+}
+
+TEST(TrimProcessorTest, processor) {
+    testUtils::TestEnvironment testEnvironment;
+    bw_music::registerLib(testEnvironment.m_projectContext);
+
+    bw_music::TrimProcessor processor(testEnvironment.m_projectContext);
+
+    processor.getInput().setToDefault();
+    processor.getOutput().setToDefault();
+
+    babelwires::ValueTreeNode& input = processor.getInput();
+    const babelwires::ValueTreeNode& output = processor.getOutput();
+
+    babelwires::ValueTreeNode& inputArray = input.assertGetChildFromStep(bw_music::TrimProcessor::getCommonArrayId());
+    const babelwires::ValueTreeNode& outputArray =
+        output.assertGetChildFromStep(bw_music::TrimProcessor::getCommonArrayId());
+
+    babelwires::ArrayInstanceImpl<babelwires::ValueTreeNode, bw_music::TrackType> inArray(inputArray);
+    const babelwires::ArrayInstanceImpl<const babelwires::ValueTreeNode, bw_music::TrackType> outArray(outputArray);
+
+    bw_music::TrimProcessorInput::Instance in(input);
+    EXPECT_EQ(in.getMode().get(), bw_music::TrimModeEnum::Value::Both);
+
+    inArray.getEntry(0).set(getTrackWithSilence());
+    processor.process(testEnvironment.m_log);
+
+    EXPECT_EQ(outArray.getEntry(0).get().getDuration(), babelwires::Rational(1, 2));
+    testUtils::testNotes({{60}, {62}}, outArray.getEntry(0).get());
+
+    processor.getInput().clearChanges();
+    in.getMode().set(bw_music::TrimModeEnum::Value::End);
+    processor.process(testEnvironment.m_log);
+
+    EXPECT_EQ(outArray.getEntry(0).get().getDuration(), 1);
+
+    // A track with nothing to trim is passed through without being copied.
+    processor.getInput().clearChanges();
+    inArray.getEntry(0).set(testUtils::getTrackOfSimpleNotes({60, 62, 64, 65}));
+    processor.process(testEnvironment.m_log);
+
+    EXPECT_EQ(&outArray.getEntry(0).get(), &inArray.getEntry(0).get());
+    testUtils::testSimpleNotes({60, 62, 64, 65}, outArray.getEntry(0).get());
+}
@@ -144,3 +144,26 @@ void testUtils::testNotesAndChords(const std::vector<bw_music::TrackEventHolder>
     }
     EXPECT_EQ(it, end);
 }
+
+bw_music::Track testUtils::getDensePolyphonicTrack(int numSteps, int notesPerStep) {
+    bw_music::TrackBuilder track;
+    bw_music::ModelDuration timeSinceLastEvent = 0;
+    for (int step = 0; step < numSteps + 2; ++step) {
+        if (step >= 2) {
+            for (int i = 0; i < notesPerStep; ++i) {
+                const auto pitch = static_cast<bw_music::Pitch>(30 + (2 * i) + (step % 2));
+                track.addEvent(bw_music::NoteOffEvent{timeSinceLastEvent, pitch});
+                timeSinceLastEvent = 0;
+            }
+        }
+        if (step < numSteps) {
+            for (int i = 0; i < notesPerStep; ++i) {
+                const auto pitch = static_cast<bw_music::Pitch>(30 + (2 * i) + (step % 2));
+                track.addEvent(bw_music::NoteOnEvent{timeSinceLastEvent, pitch});
+                timeSinceLastEvent = 0;
+            }
+        }
+        timeSinceLastEvent = babelwires::Rational(1, 8);
+    }
+    return track.finishAndGetTrack();
+}
@@ -46,4 +46,9 @@ namespace testUtils {
     void testChords(const std::vector<ChordInfo>& expectedChords, const bw_music::Track& track);
 
     void testNotesAndChords(const std::vector<bw_music::TrackEventHolder>& expectedEvents, const bw_music::Track& track);
+
+    /// Get a score of numSteps eighth-note steps, in which notesPerStep notes start at each step and last two steps.
+    /// Up to 2 * notesPerStep notes sound at once, and the notes ending at a step have the pitches of the notes
+    /// starting there.
+    bw_music::Track getDensePolyphonicTrack(int numSteps, int notesPerStep);
 }